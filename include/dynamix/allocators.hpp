@@ -183,6 +183,24 @@ public:
     /// elements used to allocated the buffer
     virtual void dealloc_mixin_data(char* ptr, size_t count, const object* obj) = 0;
 
+    /// Virtual function, which should return a buffer for the `mixin_data_in_object` array
+    /// and the mixins of an object, allocated together, or nullptr if the allocator doesn't
+    /// allocate objects in a single block.
+    /// The layout of the block is computed by the object type info and the allocator only
+    /// needs to provide the memory. It must be aligned as memory returned by `new`.
+    ///
+    /// When a block is returned, it's used instead of `alloc_mixin_data` and `alloc_mixin`
+    /// for the mixins which use this allocator and can be moved. When the type of the object
+    /// changes, a new block is allocated and the mixins which remain are moved to it, thus
+    /// unlike other mixins their addresses change with the mutations of the object.
+    ///
+    /// The default implementation returns nullptr.
+    virtual char* alloc_object_block(size_t size, const object* obj);
+
+    /// Virtual function, which should free the memory that has been obtained via a call to
+    /// `alloc_object_block`. The size will be the one which was used to allocate it.
+    virtual void dealloc_object_block(char* ptr, size_t size, const object* obj);
+
 
     /// Size of `mixin_data_in_object`
     ///
@@ -268,6 +286,22 @@ public:
 
 } // namespace internal
 
+/**
+ * A domain allocator which allocates the mixin data array and the mixins of an object in a
+ * single block (see `domain_allocator::alloc_object_block`).
+ *
+ * Creating an object with it is a single allocation and the mixins of an object are next to
+ * each other in memory. The cost is that the mixins of an object are moved when its type
+ * changes. Mixins which can't be moved, are over-aligned, or have a custom allocator are
+ * allocated separately, as with the default allocator.
+ */
+class DYNAMIX_API single_block_allocator : public internal::default_allocator
+{
+public:
+    virtual char* alloc_object_block(size_t size, const object* obj) override;
+    virtual void dealloc_object_block(char* ptr, size_t size, const object* obj) override;
+};
+
 /// Feature list entry function for custom mixin allocators
 template <typename CusomAllocator>
 mixin_allocator& allocator()
@@ -0,0 +1,84 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+/**
+ * \file
+ * Functions which call a message for many objects at once.
+ */
+
+#include "config.hpp"
+#include "object.hpp"
+#include "internal/preprocessor.hpp"
+
+#include <iterator>
+#include <utility>
+
+namespace dynamix
+{
+
+/// Calls a message for all objects in the range `[begin; end)`.
+/// The range can be of objects or of pointers to objects.
+///
+/// The call table of a type is only accessed when the type changes between two
+/// consecutive objects in the range, so populations which are grouped by type
+/// benefit the most. The mixins of the following objects are prefetched while
+/// the current one is being processed.
+///
+/// The results of unicast messages are discarded. Since the arguments are used
+/// for multiple calls, messages with rvalue reference arguments are not supported.
+///
+/// If a mixin has a batch implementation of the message (see `dynamix::batch`), it is
+/// called with the mixins of all consecutive objects of the same type instead of calling
+/// the message for each of them. For multicast messages this means that each message
+/// of the chain is called for all objects of such a run before the next one.
+template <typename Message, typename ObjectIterator, typename... Args>
+void call_all(Message* message, ObjectIterator begin, ObjectIterator end, Args&&... args)
+{
+    I_DYNAMIX_MAYBE_UNUSED(message);
+    Message::make_bulk_call(begin, end, std::forward<Args>(args)...);
+}
+
+/// Calls a message for all objects in a container (for example `std::vector<object>`
+/// or `std::vector<object*>`). Same as `call_all(message, begin(objects), end(objects), args...)`
+template <typename Message, typename Container, typename... Args>
+auto call_all(Message* message, Container& objects, Args&&... args)
+-> decltype(std::begin(objects), void())
+{
+    call_all(message, std::begin(objects), std::end(objects), std::forward<Args>(args)...);
+}
+
+/// Calls a multicast message for all objects in the range `[begin; end)` adding the
+/// results of all of them to a combinator.
+/// Same as calling the message with the combinator for each object, but the call table
+/// of a type is only accessed when the type changes between consecutive objects.
+///
+/// \par Example:
+/// \code
+/// combinators::sum<int> total;
+/// combine_all(get_value_msg, objects, total);
+/// total.result(); // the sum for all objects
+/// \endcode
+template <typename Message, typename ObjectIterator, typename Combinator, typename... Args>
+void combine_all(Message* message, ObjectIterator begin, ObjectIterator end, Combinator& combinator, Args&&... args)
+{
+    I_DYNAMIX_MAYBE_UNUSED(message);
+    Message::make_combinator_bulk_call(begin, end, combinator, std::forward<Args>(args)...);
+}
+
+/// Calls a multicast message for all objects in a container adding the results of all
+/// of them to a combinator.
+/// Same as `combine_all(message, begin(objects), end(objects), combinator, args...)`
+template <typename Message, typename Container, typename Combinator, typename... Args>
+auto combine_all(Message* message, Container& objects, Combinator& combinator, Args&&... args)
+-> decltype(std::begin(objects), void())
+{
+    combine_all(message, std::begin(objects), std::end(objects), combinator, std::forward<Args>(args)...);
+}
+
+} // namespace dynamix
@@ -10,14 +10,76 @@
 /**
  * \file
  * Common multicast combinator classes.
+ *
+ * Besides combining the results of a multicast chain, the combinators here can
+ * combine the results of a multicast for a population of objects (see `combine_all`
+ * and `parallel_combine`). Such combinators (population combinators) also need:
+ * * a default constructor
+ * * `void merge(const combinator& other)` which adds the results of another
+ *   instance, as if they were added to this one
+ * * optionally `void merge(const combinator* others, size_t num)` which merges
+ *   many instances at once
  */
 
 #include "config.hpp"
 
 #include <cstddef>
+#include <utility>
 
 namespace dynamix
 {
+
+namespace internal
+{
+// sums values obtained from an array of objects in four independent lanes
+// this way the additions don't depend on each other and the compiler can vectorize them
+template <typename T, typename Object, typename GetValue>
+T lane_sum(const Object* objects, size_t num, GetValue get)
+{
+    T lanes[4] = { T(0), T(0), T(0), T(0) };
+
+    size_t i = 0;
+    for (; i + 4 <= num; i += 4)
+    {
+        lanes[0] += get(objects[i]);
+        lanes[1] += get(objects[i + 1]);
+        lanes[2] += get(objects[i + 2]);
+        lanes[3] += get(objects[i + 3]);
+    }
+
+    for (; i < num; ++i)
+    {
+        lanes[0] += get(objects[i]);
+    }
+
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+// merges many combinators into one
+// uses the combinator's merge for many instances if it has one
+template <typename Combinator>
+auto merge_combinators_impl(Combinator& target, const Combinator* others, size_t num, int)
+-> decltype(target.merge(others, num), void())
+{
+    target.merge(others, num);
+}
+
+template <typename Combinator>
+void merge_combinators_impl(Combinator& target, const Combinator* others, size_t num, ...)
+{
+    for (size_t i = 0; i < num; ++i)
+    {
+        target.merge(others[i]);
+    }
+}
+
+template <typename Combinator>
+void merge_combinators(Combinator& target, const Combinator* others, size_t num)
+{
+    merge_combinators_impl(target, others, num, 0);
+}
+} // namespace internal
+
 namespace combinators
 {
 
@@ -61,6 +123,12 @@ public:
         _result = true;
     }
 
+    /// Adds the result of another instance
+    void merge(const boolean_and& other)
+    {
+        _result = _result && other._result;
+    }
+
 private:
     bool _result;
 };
@@ -105,6 +173,12 @@ public:
         _result = false;
     }
 
+    /// Adds the result of another instance
+    void merge(const boolean_or& other)
+    {
+        _result = _result || other._result;
+    }
+
 private:
     bool _result;
 };
@@ -145,6 +219,18 @@ public:
         _result = 0;
     }
 
+    /// Adds the result of another instance
+    void merge(const sum& other)
+    {
+        _result += other._result;
+    }
+
+    /// Adds the results of many instances
+    void merge(const sum* others, size_t num)
+    {
+        _result += internal::lane_sum<result_type>(others, num, [](const sum& s) -> const result_type& { return s._result; });
+    }
+
 private:
     result_type _result;
 };
@@ -166,10 +252,11 @@ public:
         , _num_results(0)
     {}
 
-    /// The function called by the multicast caller to set the number of results
+    /// The function called by the multicast caller to add the number of results
+    /// of a multicast chain
     void set_num_results(size_t num)
     {
-        _num_results = num;
+        _num_results += num;
     }
 
     /// The function used by the code generated for multicast messages.
@@ -190,6 +277,21 @@ public:
     void reset()
     {
         _sum = 0;
+        _num_results = 0;
+    }
+
+    /// Adds the results of another instance
+    void merge(const mean& other)
+    {
+        _sum += other._sum;
+        _num_results += other._num_results;
+    }
+
+    /// Adds the results of many instances
+    void merge(const mean* others, size_t num)
+    {
+        _sum += internal::lane_sum<result_type>(others, num, [](const mean& m) -> const result_type& { return m._sum; });
+        _num_results += internal::lane_sum<size_t>(others, num, [](const mean& m) { return m._num_results; });
     }
 
 private:
@@ -10,6 +10,9 @@
 /**
  * \file
  * Common mutation rules classes.
+ *
+ * The rules are compiled when added to a domain, so changing them afterwards has no effect
+ * until they are removed and added again.
  */
 
 #include "config.hpp"
@@ -38,6 +41,9 @@ public:
 
     /// Applies the rule to a mutation.
     virtual void apply_to(object_type_mutation& mutation, const mixin_collection& source) override;
+
+    /// Adds the rule to the compiled rules of a domain.
+    virtual bool compile_to(internal::mutation_rule_compiler& compiler) const override;
 };
 
 /**
@@ -61,6 +67,9 @@ public:
 
     /// Applies the rule to a mutation.
     virtual void apply_to(object_type_mutation& mutation, const mixin_collection& source) override;
+
+    /// Adds the rule to the compiled rules of a domain.
+    virtual bool compile_to(internal::mutation_rule_compiler& compiler) const override;
 };
 
 /**
@@ -93,8 +102,11 @@ public:
     /// Applies the rule to a mutation.
     virtual void apply_to(object_type_mutation& mutation, const mixin_collection& source) override;
 
+    /// Adds the rule to the compiled rules of a domain.
+    virtual bool compile_to(internal::mutation_rule_compiler& compiler) const override;
+
 protected:
-    mixin_id _master_id;
+    mixin_id _master_id = INVALID_MIXIN_ID;
 };
 
 namespace internal
@@ -109,6 +121,7 @@ public:
     }
 
     virtual void apply_to(object_type_mutation& mutation, const mixin_collection& source) override;
+    virtual bool compile_to(mutation_rule_compiler& compiler) const override;
 
 protected:
     const mixin_id _id;
@@ -124,6 +137,7 @@ public:
     }
 
     virtual void apply_to(object_type_mutation& mutation, const mixin_collection& source) override;
+    virtual bool compile_to(mutation_rule_compiler& compiler) const override;
 
 protected:
     const mixin_id _id;
@@ -140,6 +154,7 @@ public:
     }
 
     virtual void apply_to(object_type_mutation& mutation, const mixin_collection& source) override;
+    virtual bool compile_to(mutation_rule_compiler& compiler) const override;
 
 protected:
     const mixin_id _source_id;
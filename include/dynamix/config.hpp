@@ -63,22 +63,18 @@
 #   define DYNAMIX_DEBUG 1
 #endif
 
-// maximum number of registered mixins
-// an assertion will occur if this limit is reached in a program
-// *    the object type creation and the object mutation are proportional
-//      to this value by a factor of o(n log(word, n)) where word is the bit size of size_t
-// *    the object type's size is 2 * <value> / 8 (a bit for each possible mixin)
-//      the more global object of different types you have the more type memory they'll consume
-// ie: minor cost for increase
+// initial capacity of the mixin registry
+// the number of mixins is not limited: the domain grows its registry when needed,
+// but mixins which are registered after it has been exceeded must not be registered
+// concurrently with other uses of the domain (as the registry may be reallocated)
+// the size of an object type doesn't depend on this value but on the biggest mixin id it has
 #if !defined(DYNAMIX_MAX_MIXINS)
 #   define DYNAMIX_MAX_MIXINS 512
 #endif
 
-// maximum number of messages (and consequently max per mixin)
-// an assertion will occur if this limit is reached in a program
-// as with the mixin limits this influences object type with 2 times as many pointers (2 * <word> * value)
-// object creation and mutation is not influenced by this value
-// minor cost for increase
+// initial capacity of the message registry
+// as with mixins, the number of messages is not limited
+// the call table of an object type has an entry for each message registered when it was created
 #if !defined(DYNAMIX_MAX_MESSAGES)
 #   define DYNAMIX_MAX_MESSAGES 1024
 #endif
@@ -114,6 +110,51 @@
 #   define DYNAMIX_OBJECT_REPLACE_MIXIN 1
 #endif
 
+// setting this to a non-zero value will add an inline buffer of this many bytes to each object
+// the mixin data array of an object and its small movable mixins are placed in it when they fit,
+// which saves the allocations of objects with a few small mixins
+// each mixin takes a mixin data element (two pointers) and its size plus a pointer in the buffer,
+// and the mixin data array has two additional elements
+// the mixins in the buffer are moved with the object when it's moved and when its type changes
+// objects with an object allocator don't use the buffer
+#if !defined(DYNAMIX_OBJECT_INLINE_BUFFER_SIZE)
+#   define DYNAMIX_OBJECT_INLINE_BUFFER_SIZE 0
+#endif
+
+// setting this to true will make the call tables and mixin index tables of object types sparse
+// they will be split into pages which are only allocated if the type implements a message
+// (or has a mixin) with an id within them
+// by default each type pays for a call table entry for each registered message
+// and a mixin index for each mixin id up to its biggest one regardless of how many it uses
+// the compact tables make the type sizes proportional to what they use, at the cost of an
+// additional indirection when calling messages
+// it is best for programs with many object types
+#if !defined(DYNAMIX_COMPACT_TYPE_INFO)
+#   define DYNAMIX_COMPACT_TYPE_INFO 0
+#endif
+
+// number of elements in a page of the compact tables (must be a power of two)
+#if !defined(DYNAMIX_COMPACT_TYPE_INFO_PAGE_SIZE)
+#   define DYNAMIX_COMPACT_TYPE_INFO_PAGE_SIZE 16
+#endif
+
+// setting this to true will make each unicast message function keep a small thread-local cache
+// of the calls it resolved for the last few object types it was called for
+// calls for objects of those types skip the call table and dispatch with a compare and a jump
+// the caches are cleared when type infos are destroyed (garbage collection, unloaded plugins)
+// there is a single cache per message (and module), which is shared by all places it's called from,
+// so it is best for programs where the calls for a given message are made for a handful of types
+// the legacy message macros don't use the caches, so they can't be used with this option
+#if !defined(DYNAMIX_MESSAGE_CALL_CACHE)
+#   define DYNAMIX_MESSAGE_CALL_CACHE 0
+#endif
+
+// number of object types in each message call cache
+// the cache is searched linearly, so values between 2 and 4 work best
+#if !defined(DYNAMIX_MESSAGE_CALL_CACHE_SIZE)
+#   define DYNAMIX_MESSAGE_CALL_CACHE_SIZE 4
+#endif
+
 // there is warning push/pop about this in the main header
 #if defined(_MSC_VER)
 // msvc complains that template classes don't have a dll interface (they shouldn't).
@@ -10,5 +10,11 @@
 #include "object.hpp"
 #include "exception.hpp"
 #include "internal/mixin_data_in_object.hpp"
+#include "internal/message_callers.hpp"
 #include "internal/message_macros.hpp"
 #include "gen/legacy_message_macros.ipp"
+
+#if DYNAMIX_MESSAGE_CALL_CACHE
+    // the calling code of the legacy macros is in the macros themselves and doesn't use the caches
+#   error "DYNAMIX_MESSAGE_CALL_CACHE is not supported with the legacy message macros"
+#endif
@@ -13,9 +13,14 @@
 #include "feature.hpp"
 #include "message.hpp"
 #include "mixin_collection.hpp" // for mixin_type_info_vector
+#include "metrics.hpp"
+#include "type_info_gc.hpp"
 #include "internal/assert.hpp"
+#include "internal/type_info_map.hpp"
+#include "internal/name_index.hpp"
 
 #include <unordered_map>
+#include <vector>
 #include <memory>
 #include <type_traits> // alignment of
 
@@ -30,6 +35,12 @@
 
 // The domain collection of mixins and messages
 // It serves as a library instance of sorts
+//
+// The mixins, messages and type classes are registered in the default domain (safe_instance)
+// and are shared by all domains. Each domain has its own object type infos, mutation rules,
+// allocator and garbage collection of type infos, along with the locks which guard them.
+// Additional domains can be created so that independent groups of objects (shards) don't
+// contend for them. Objects, mutators and type templates are bound to a domain.
 
 namespace dynamix
 {
@@ -44,24 +55,36 @@ namespace internal
 {
 
 struct message_t;
+class compiled_mutation_rules;
+class type_indexed_table_base;
 
 class DYNAMIX_API domain
 {
 public:
+    // the default domain
     // contains static local variable which has thread-safe initialization
     // so this function is a bit slower, but it's safe to call globally
     static domain& safe_instance();
 
+    // the default domain
     // no static variables, not safe to call globally
     static const domain& instance();
 
+    // creates an additional domain
+    // it must outlive all objects, mutators and type templates which are bound to it
+    domain();
+    ~domain();
+
+    bool is_default() const { return _is_default; }
+
     mutation_rule_id add_mutation_rule(std::shared_ptr<mutation_rule> rule);
     mutation_rule_id add_mutation_rule(mutation_rule* rule);
     std::shared_ptr<mutation_rule> remove_mutation_rule(mutation_rule_id id);
     void apply_mutation_rules(object_type_mutation& mutation, const mixin_collection& source_mixins);
 
-    size_t num_registered_mixins() const { return _num_registered_mixins; }
+    size_t num_registered_mixins() const { return _mixin_type_infos.size(); }
 
+    // the following registration functions must be called on the default domain
     void register_mixin_type(mixin_type_info& info);
     void unregister_mixin_type(const mixin_type_info& info);
 
@@ -74,12 +97,23 @@ public:
     void unregister_type_class(const type_class& t);
 
     // creates a new type info if needed
-    const object_type_info* get_object_type_info(mixin_collection mixins);
+    // the source is an optional hint: an existing type whose call table can be partially reused
+    // if it's not provided, an existing type which differs by a single mixin is used, if any
+    // the returned type info is pinned and the caller must unpin it when it has objects or is no longer needed
+    const object_type_info* get_object_type_info(mixin_collection mixins, const object_type_info* source = nullptr);
+
+    // builds a type info without adding it to the domain or matching it to type classes
+    // if a source is provided, its call table is partially reused
+    std::unique_ptr<object_type_info> build_object_type_info(mixin_collection mixins, const object_type_info* source) const;
+
+    // finds an existing type info which has all mixins but one of a collection
+    // returns nullptr if there's no such type
+    const object_type_info* find_derivation_source(const mixin_collection& mixins) const;
 
     const mixin_type_info& mixin_info(mixin_id id) const
     {
         I_DYNAMIX_ASSERT(id != INVALID_MIXIN_ID);
-        I_DYNAMIX_ASSERT(id <= _num_registered_mixins);
+        I_DYNAMIX_ASSERT(id < _mixin_type_infos.size());
         I_DYNAMIX_ASSERT(_mixin_type_infos[id]);
 
         return *_mixin_type_infos[id];
@@ -87,58 +121,170 @@ public:
 
     const message_t& message_data(feature_id id) const
     {
-        I_DYNAMIX_ASSERT(id <= _num_registered_messages);
+        I_DYNAMIX_ASSERT(id < _messages.size());
         I_DYNAMIX_ASSERT(_messages[id]);
         return *_messages[id];
     }
 
+    // the id of a mixin or a message if it's currently registered, or an invalid id otherwise
+    // unregistering doesn't reset the id, and it may be reused by another mixin or message
+    mixin_id registered_id(const mixin_type_info& info) const
+    {
+        return info.id < _mixin_type_infos.size() && _mixin_type_infos[info.id] == &info ? info.id : INVALID_MIXIN_ID;
+    }
+
+    feature_id registered_id(const feature& f) const
+    {
+        return f.id < _messages.size() && _messages[f.id] == &f ? f.id : INVALID_FEATURE_ID;
+    }
+
     // sets the current domain allocator
+    // the allocator of the default domain is also the allocator of the mixins which don't have their own
+    // in other domains it replaces it for the objects bound to them
     void set_allocator(domain_allocator* allocator);
     domain_allocator* allocator() const { return _allocator; }
 
     // get mixin id by name string
     mixin_id get_mixin_id_by_name(const char* mixin_name) const;
 
+    // returns the interned entry of a mixin name, adding it if it isn't known
+    // see mixin_name_handle
+    const name_index::entry& intern_mixin_name(const char* mixin_name);
+
+    // adds all type infos in the domain to the vector
+    // they stay valid until the next call to garbage_collect_type_infos or until one of their mixins
+    // is unregistered, and while a type_info_read_guard which was created before the call is alive
+    void get_object_type_infos(std::vector<const object_type_info*>& out_type_infos);
+
     // erases all type infos with zero objects
+    // must not be called concurrently with mutations or object creation
     void garbage_collect_type_infos();
 
+    // a bounded collection of the least recently used type infos with zero objects
+    // can be called concurrently with mutations
+    // it's called automatically when type infos are created and the limits of the policy are exceeded
+    void collect_type_infos();
+
+    void set_gc_policy(const type_info_gc_policy& policy);
+    type_info_gc_stats gc_stats();
+
+    // type infos which are not pinned and have no objects may be collected concurrently
+    // they must be accessed while a guard is alive, and the collected ones are destroyed
+    // only after all guards which were created before their collection are destroyed
+    class DYNAMIX_API type_info_read_guard
+    {
+    public:
+        explicit type_info_read_guard(const domain& dom = domain::instance());
+        ~type_info_read_guard();
+
+        type_info_read_guard(const type_info_read_guard&) = delete;
+        type_info_read_guard& operator=(const type_info_read_guard&) = delete;
+
+    private:
+        const domain& _domain;
+        size_t _epoch;
+    };
+
+    // a logical clock which is advanced when type infos are created
+    // type infos are stamped with it when pinned, so that the least recently used ones are collected first
+    size_t type_use_clock() const { return _type_use_clock; }
+
+    // a number which changes every time type infos are destroyed in any domain
+    // caches which keep pointers to type infos use it to detect that they might be stale
+    // (a newly created type info can reuse the address of a destroyed one)
+    static size_t type_info_generation() { return _instance._type_info_generation; }
+
+    // incremented when mutation rules are added or removed in any domain
+    // used to invalidate the type transitions (see object_type_info::find_transition)
+    static size_t mutation_rules_generation() { return _instance._mutation_rules_generation; }
+
 private:
-    domain();
-    ~domain();
+    struct default_domain_tag {};
+    explicit domain(default_domain_tag);
 
     friend class dynamix::object_type_info;
     friend class object_mutator;
+    friend class type_indexed_table_base;
+
+    // the ids of type infos are global: the ones of the default domain are used by all domains
+    uint32_t acquire_type_id();
+    void release_type_id(uint32_t id);
+
+    // removes the type infos which have a mixin which is being unregistered
+    void erase_type_infos_with(const mixin_type_info& info);
+
+    class all_type_infos_lock;
+
+    // updates the masks of the declarative type classes after mixins or messages are registered
+    // or unregistered
+    void compile_type_classes();
+
+    // clears the transitions of all type infos
+    // called after type infos have been destroyed
+    void clear_type_transitions();
+
+    // must be called with the lock of _object_type_infos
+    void collect_type_infos_locked();
 
     // non-copyable
     domain(const domain&) = delete;
     domain& operator=(const domain&) = delete;
 
-    // sparse list of all mixin infos
+    // sparse list of all mixin infos indexed by id
     // some elements might be nullptr
     // such elements have been registered from a loadable module (plugin)
     // and then unregistered when it was unloaded
-    mixin_type_info* _mixin_type_infos[DYNAMIX_MAX_MIXINS];
-    size_t _num_registered_mixins; // max registered mixin
+    // it grows when mixins are registered, which must not happen concurrently with other
+    // uses of the domain if it exceeds its initial capacity of DYNAMIX_MAX_MIXINS
+    std::vector<mixin_type_info*> _mixin_type_infos;
 
-    // sparse list of all message infos
+    // sparse list of all message infos indexed by id
     // some elements might be nullptr
     // such elements have been registered from a loadable module (plugin)
     // and then unregistered when it was unloaded
-    message_t* _messages[DYNAMIX_MAX_MESSAGES];
-    size_t _num_registered_messages;
+    // as with mixins it has an initial capacity of DYNAMIX_MAX_MESSAGES
+    std::vector<message_t*> _messages;
+
+    // the ids of the nullptr elements of the registries, which are reused first
+    std::vector<mixin_id> _free_mixin_ids;
+    std::vector<feature_id> _free_message_ids;
+
+    // the ids of the registered mixins and messages by name
+    // they make registration and lookups by name independent of the number of registered entries
+    name_index _mixin_names;
+    name_index _message_names;
+
+    // the ids of the type infos of all domains and the tables indexed by them
+    // only used in the default domain
+    // declared before the type infos, so that they outlive them when the domain is destroyed
+    std::vector<uint32_t> _free_type_ids; // a min-heap
+    uint32_t _num_type_ids = 1; // zero is the id of the null type info
+    std::vector<type_indexed_table_base*> _type_indexed_tables;
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    std::mutex _type_ids_mutex;
+#endif
 
     // sparse list of all registered type classes
     // some elements might be nullptr
     // such elements have been registered from a loadable module (plugin)
     // and then unregistered when it was unloaded
+    // the type infos of all domains are matched with them when created
+    // so modifications lock the type infos of all domains
     std::vector<type_class*> _type_classes;
 
-    typedef std::unordered_map<available_mixins_bitset, std::unique_ptr<object_type_info>> object_type_info_map;
+    // lookups are lock-free, modifications are guarded by _object_type_infos_mutex
     object_type_info_map _object_type_infos;
 
     // mutation rules for this domain
     std::vector<std::shared_ptr<mutation_rule>> _mutation_rules;
 
+    // an immutable snapshot of the rules, replaced whenever they change
+    // mutations read it atomically without taking _mutation_rules_mutex
+    std::shared_ptr<const compiled_mutation_rules> _compiled_mutation_rules;
+
+    // must be called with _mutation_rules_mutex
+    void compile_mutation_rules();
+
 #if DYNAMIX_THREAD_SAFE_MUTATIONS
     std::mutex _object_type_infos_mutex;
     std::mutex _mutation_rules_mutex;
@@ -147,6 +293,28 @@ private:
     // allocators
     domain_allocator* _allocator;
 
+    // incremented before type infos are destroyed
+    // the generations are global: the ones of the default domain are used by all domains
+    metric _type_info_generation;
+
+    metric _mutation_rules_generation;
+
+    metric _type_use_clock;
+
+    // the state of the automatic garbage collection of type infos
+    // guarded by _object_type_infos_mutex
+    struct gc_state;
+    std::unique_ptr<gc_state> _gc;
+
+    const bool _is_default;
+
+    // the additional domains, which must be updated when mixins and type classes are unregistered
+    // only used in the default domain
+    std::vector<domain*> _additional_domains;
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    std::mutex _additional_domains_mutex;
+#endif
+
     static const domain& _instance; // used for the fast version of the instance getter
 };
 
@@ -49,6 +49,10 @@
 #include "mutation_rule.hpp"
 #include "common_mutation_rules.hpp"
 #include "combinators.hpp"
+#include "bulk_call.hpp"
+#include "message_handle.hpp"
+#include "message_pipeline.hpp"
+#include "static_object.hpp"
 
 #if defined(_MSC_VER)
 #   pragma warning( pop )
@@ -0,0 +1,122 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+/**
+ * \file
+ * Executors which run batches of tasks on multiple threads.
+ */
+
+#include "config.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dynamix
+{
+
+/**
+ * This class should be the parent to your custom executors.
+ * For example ones which run the tasks in your own job system.
+ *
+ * An executor runs batches of tasks, which are identified by their index in the batch.
+ */
+class DYNAMIX_API executor
+{
+public:
+    virtual ~executor() {}
+
+    /// Pure virtual.
+    /// Returns the number of threads which run the tasks (including the calling thread)
+    virtual size_t concurrency() const = 0;
+
+    /// Pure virtual.
+    /// Calls `task(i)` for each `i` in `[0; num_tasks)` and returns when all calls have completed.
+    /// The calls can be made from multiple threads, including the calling one.
+    virtual void run(size_t num_tasks, const std::function<void(size_t)>& task) = 0;
+};
+
+/**
+ * An executor with a pool of threads, each of which has its own queue of tasks.
+ *
+ * Each batch is split evenly between the queues. When a thread empties its queue it
+ * steals half of the remaining tasks of another thread.
+ *
+ * The thread which calls `run` works on the batch as well, so a pool for N threads
+ * creates N-1 threads.
+ *
+ * If tasks throw exceptions the first one is rethrown by `run` after all tasks of the
+ * batch have completed.
+ *
+ * Batches from multiple threads are run one after the other.
+ */
+class DYNAMIX_API work_stealing_executor : public executor
+{
+public:
+    /// Creates an executor for a number of threads.
+    /// Zero means `std::thread::hardware_concurrency()`
+    explicit work_stealing_executor(size_t num_threads = 0);
+    ~work_stealing_executor();
+
+    work_stealing_executor(const work_stealing_executor&) = delete;
+    work_stealing_executor& operator=(const work_stealing_executor&) = delete;
+
+    virtual size_t concurrency() const override;
+    virtual void run(size_t num_tasks, const std::function<void(size_t)>& task) override;
+
+private:
+    // the tasks of a thread: indices in [begin; end)
+    // begin is in the lower 32 bits and end in the upper ones, so that the owner can pop from
+    // the front and thieves can steal from the back with compare-and-swap
+    // padded to a cache line so the threads don't contend for unrelated queues
+    struct task_queue
+    {
+        std::atomic<uint64_t> range;
+        char padding[64 - sizeof(std::atomic<uint64_t>)];
+    };
+
+    bool pop_task(size_t queue, size_t& out_task);
+    bool steal_task(size_t queue, size_t& out_task);
+    void run_task(size_t task);
+
+    // runs the tasks from a queue and then steals from the others until all are empty
+    void work(size_t queue);
+
+    void thread_func(size_t queue);
+
+    std::vector<std::thread> _threads;
+    std::unique_ptr<task_queue[]> _queues;
+    size_t _num_queues;
+
+    // batches are run one at a time
+    std::mutex _run_mutex;
+
+    // guards the batch state below
+    std::mutex _mutex;
+    std::condition_variable _work_cv;
+    std::condition_variable _done_cv;
+
+    uint64_t _batch = 0; // index of the current batch, so that threads know there's new work
+    size_t _num_working = 0; // number of pool threads still working on the current batch
+    bool _stop = false;
+
+    const std::function<void(size_t)>* _task = nullptr;
+
+#if DYNAMIX_USE_EXCEPTIONS
+    std::exception_ptr _error;
+#endif
+};
+
+} // namespace dynamix
@@ -93,6 +93,7 @@
             reinterpret_cast<::dynamix::internal::func_ptr>(&DYNAMIX_DEFAULT_IMPL_STRUCT(message_name)::caller), \
             ::std::numeric_limits<int>::min(), \
             ::std::numeric_limits<int>::min(), \
+            nullptr, \
         }; \
         msg.default_impl_data = &default_impl; \
     } \
@@ -188,6 +189,7 @@
             reinterpret_cast<::dynamix::internal::func_ptr>(&DYNAMIX_DEFAULT_IMPL_STRUCT(message_name)::caller), \
             ::std::numeric_limits<int>::min(), \
             ::std::numeric_limits<int>::min(), \
+            nullptr, \
         }; \
         msg.default_impl_data = &default_impl; \
     } \
@@ -283,6 +285,7 @@
             reinterpret_cast<::dynamix::internal::func_ptr>(&DYNAMIX_DEFAULT_IMPL_STRUCT(message_name)::caller), \
             ::std::numeric_limits<int>::min(), \
             ::std::numeric_limits<int>::min(), \
+            nullptr, \
         }; \
         msg.default_impl_data = &default_impl; \
     } \
@@ -378,6 +381,7 @@
             reinterpret_cast<::dynamix::internal::func_ptr>(&DYNAMIX_DEFAULT_IMPL_STRUCT(message_name)::caller), \
             ::std::numeric_limits<int>::min(), \
             ::std::numeric_limits<int>::min(), \
+            nullptr, \
         }; \
         msg.default_impl_data = &default_impl; \
     } \
@@ -473,6 +477,7 @@
             reinterpret_cast<::dynamix::internal::func_ptr>(&DYNAMIX_DEFAULT_IMPL_STRUCT(message_name)::caller), \
             ::std::numeric_limits<int>::min(), \
             ::std::numeric_limits<int>::min(), \
+            nullptr, \
         }; \
         msg.default_impl_data = &default_impl; \
     } \
@@ -568,6 +573,7 @@
             reinterpret_cast<::dynamix::internal::func_ptr>(&DYNAMIX_DEFAULT_IMPL_STRUCT(message_name)::caller), \
             ::std::numeric_limits<int>::min(), \
             ::std::numeric_limits<int>::min(), \
+            nullptr, \
         }; \
         msg.default_impl_data = &default_impl; \
     } \
@@ -663,6 +669,7 @@
             reinterpret_cast<::dynamix::internal::func_ptr>(&DYNAMIX_DEFAULT_IMPL_STRUCT(message_name)::caller), \
             ::std::numeric_limits<int>::min(), \
             ::std::numeric_limits<int>::min(), \
+            nullptr, \
         }; \
         msg.default_impl_data = &default_impl; \
     } \
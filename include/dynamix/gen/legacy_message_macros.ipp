@@ -16,6 +16,7 @@
     struct export I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name) : public ::dynamix::internal::message_t \
     { \
         typedef return_type (*caller_func)(void* ); \
+        typedef ::dynamix::internal::msg_caller<return_type >::batch_caller_func batch_caller_func; \
         I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name)() \
             : ::dynamix::internal::message_t(I_DYNAMIX_PP_STRINGIZE(message_name), message_mechanism, false) \
         {} \
@@ -31,6 +32,26 @@
             /* cast the caller to a void (*)() - safe according to the standard */ \
             return reinterpret_cast< ::dynamix::internal::func_ptr>(the_caller); \
         } \
+        /* the calls for ranges of objects, the combinator and the cached calls are the same as the ones of the new-style macros */ \
+        /* since they're templates they're only instantiated for messages which use them */ \
+        typedef ::dynamix::internal::I_DYNAMIX_MESSAGE_CALLER_STRUCT(message_mechanism) \
+            <I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name), constness ::dynamix::object, return_type > caller_struct; \
+        template <typename... CallArgs> \
+        static auto make_bulk_call(CallArgs&&... _d_args) -> decltype(caller_struct::make_bulk_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return caller_struct::make_bulk_call(std::forward<CallArgs>(_d_args)...); \
+        } \
+        /* the caller is a template argument, so that calls which only one of the mechanisms has aren't looked up for the other one */ \
+        template <typename Caller = caller_struct, typename... CallArgs> \
+        static auto make_combinator_bulk_call(CallArgs&&... _d_args) -> decltype(Caller::make_combinator_bulk_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return Caller::make_combinator_bulk_call(std::forward<CallArgs>(_d_args)...); \
+        } \
+        template <typename Caller = caller_struct, typename... CallArgs> \
+        static auto make_cached_call(CallArgs&&... _d_args) -> decltype(Caller::make_cached_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return Caller::make_cached_call(std::forward<CallArgs>(_d_args)...); \
+        } \
     }; \
     /* step 2: define a message tag, that will be used to identify the message in feature lists */ \
     /* it would have been nice if we could set this global variable to the unique global instance of the feature*/ \
@@ -140,6 +161,7 @@
     struct export I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name) : public ::dynamix::internal::message_t \
     { \
         typedef return_type (*caller_func)(void* , arg0_type); \
+        typedef ::dynamix::internal::msg_caller<return_type , arg0_type>::batch_caller_func batch_caller_func; \
         I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name)() \
             : ::dynamix::internal::message_t(I_DYNAMIX_PP_STRINGIZE(message_name), message_mechanism, false) \
         {} \
@@ -155,6 +177,26 @@
             /* cast the caller to a void (*)() - safe according to the standard */ \
             return reinterpret_cast< ::dynamix::internal::func_ptr>(the_caller); \
         } \
+        /* the calls for ranges of objects, the combinator and the cached calls are the same as the ones of the new-style macros */ \
+        /* since they're templates they're only instantiated for messages which use them */ \
+        typedef ::dynamix::internal::I_DYNAMIX_MESSAGE_CALLER_STRUCT(message_mechanism) \
+            <I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name), constness ::dynamix::object, return_type , arg0_type> caller_struct; \
+        template <typename... CallArgs> \
+        static auto make_bulk_call(CallArgs&&... _d_args) -> decltype(caller_struct::make_bulk_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return caller_struct::make_bulk_call(std::forward<CallArgs>(_d_args)...); \
+        } \
+        /* the caller is a template argument, so that calls which only one of the mechanisms has aren't looked up for the other one */ \
+        template <typename Caller = caller_struct, typename... CallArgs> \
+        static auto make_combinator_bulk_call(CallArgs&&... _d_args) -> decltype(Caller::make_combinator_bulk_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return Caller::make_combinator_bulk_call(std::forward<CallArgs>(_d_args)...); \
+        } \
+        template <typename Caller = caller_struct, typename... CallArgs> \
+        static auto make_cached_call(CallArgs&&... _d_args) -> decltype(Caller::make_cached_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return Caller::make_cached_call(std::forward<CallArgs>(_d_args)...); \
+        } \
     }; \
     /* step 2: define a message tag, that will be used to identify the message in feature lists */ \
     /* it would have been nice if we could set this global variable to the unique global instance of the feature*/ \
@@ -264,6 +306,7 @@
     struct export I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name) : public ::dynamix::internal::message_t \
     { \
         typedef return_type (*caller_func)(void* , arg0_type, arg1_type); \
+        typedef ::dynamix::internal::msg_caller<return_type , arg0_type, arg1_type>::batch_caller_func batch_caller_func; \
         I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name)() \
             : ::dynamix::internal::message_t(I_DYNAMIX_PP_STRINGIZE(message_name), message_mechanism, false) \
         {} \
@@ -279,6 +322,26 @@
             /* cast the caller to a void (*)() - safe according to the standard */ \
             return reinterpret_cast< ::dynamix::internal::func_ptr>(the_caller); \
         } \
+        /* the calls for ranges of objects, the combinator and the cached calls are the same as the ones of the new-style macros */ \
+        /* since they're templates they're only instantiated for messages which use them */ \
+        typedef ::dynamix::internal::I_DYNAMIX_MESSAGE_CALLER_STRUCT(message_mechanism) \
+            <I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name), constness ::dynamix::object, return_type , arg0_type, arg1_type> caller_struct; \
+        template <typename... CallArgs> \
+        static auto make_bulk_call(CallArgs&&... _d_args) -> decltype(caller_struct::make_bulk_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return caller_struct::make_bulk_call(std::forward<CallArgs>(_d_args)...); \
+        } \
+        /* the caller is a template argument, so that calls which only one of the mechanisms has aren't looked up for the other one */ \
+        template <typename Caller = caller_struct, typename... CallArgs> \
+        static auto make_combinator_bulk_call(CallArgs&&... _d_args) -> decltype(Caller::make_combinator_bulk_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return Caller::make_combinator_bulk_call(std::forward<CallArgs>(_d_args)...); \
+        } \
+        template <typename Caller = caller_struct, typename... CallArgs> \
+        static auto make_cached_call(CallArgs&&... _d_args) -> decltype(Caller::make_cached_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return Caller::make_cached_call(std::forward<CallArgs>(_d_args)...); \
+        } \
     }; \
     /* step 2: define a message tag, that will be used to identify the message in feature lists */ \
     /* it would have been nice if we could set this global variable to the unique global instance of the feature*/ \
@@ -388,6 +451,7 @@
     struct export I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name) : public ::dynamix::internal::message_t \
     { \
         typedef return_type (*caller_func)(void* , arg0_type, arg1_type, arg2_type); \
+        typedef ::dynamix::internal::msg_caller<return_type , arg0_type, arg1_type, arg2_type>::batch_caller_func batch_caller_func; \
         I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name)() \
             : ::dynamix::internal::message_t(I_DYNAMIX_PP_STRINGIZE(message_name), message_mechanism, false) \
         {} \
@@ -403,6 +467,26 @@
             /* cast the caller to a void (*)() - safe according to the standard */ \
             return reinterpret_cast< ::dynamix::internal::func_ptr>(the_caller); \
         } \
+        /* the calls for ranges of objects, the combinator and the cached calls are the same as the ones of the new-style macros */ \
+        /* since they're templates they're only instantiated for messages which use them */ \
+        typedef ::dynamix::internal::I_DYNAMIX_MESSAGE_CALLER_STRUCT(message_mechanism) \
+            <I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name), constness ::dynamix::object, return_type , arg0_type, arg1_type, arg2_type> caller_struct; \
+        template <typename... CallArgs> \
+        static auto make_bulk_call(CallArgs&&... _d_args) -> decltype(caller_struct::make_bulk_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return caller_struct::make_bulk_call(std::forward<CallArgs>(_d_args)...); \
+        } \
+        /* the caller is a template argument, so that calls which only one of the mechanisms has aren't looked up for the other one */ \
+        template <typename Caller = caller_struct, typename... CallArgs> \
+        static auto make_combinator_bulk_call(CallArgs&&... _d_args) -> decltype(Caller::make_combinator_bulk_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return Caller::make_combinator_bulk_call(std::forward<CallArgs>(_d_args)...); \
+        } \
+        template <typename Caller = caller_struct, typename... CallArgs> \
+        static auto make_cached_call(CallArgs&&... _d_args) -> decltype(Caller::make_cached_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return Caller::make_cached_call(std::forward<CallArgs>(_d_args)...); \
+        } \
     }; \
     /* step 2: define a message tag, that will be used to identify the message in feature lists */ \
     /* it would have been nice if we could set this global variable to the unique global instance of the feature*/ \
@@ -512,6 +596,7 @@
     struct export I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name) : public ::dynamix::internal::message_t \
     { \
         typedef return_type (*caller_func)(void* , arg0_type, arg1_type, arg2_type, arg3_type); \
+        typedef ::dynamix::internal::msg_caller<return_type , arg0_type, arg1_type, arg2_type, arg3_type>::batch_caller_func batch_caller_func; \
         I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name)() \
             : ::dynamix::internal::message_t(I_DYNAMIX_PP_STRINGIZE(message_name), message_mechanism, false) \
         {} \
@@ -527,6 +612,26 @@
             /* cast the caller to a void (*)() - safe according to the standard */ \
             return reinterpret_cast< ::dynamix::internal::func_ptr>(the_caller); \
         } \
+        /* the calls for ranges of objects, the combinator and the cached calls are the same as the ones of the new-style macros */ \
+        /* since they're templates they're only instantiated for messages which use them */ \
+        typedef ::dynamix::internal::I_DYNAMIX_MESSAGE_CALLER_STRUCT(message_mechanism) \
+            <I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name), constness ::dynamix::object, return_type , arg0_type, arg1_type, arg2_type, arg3_type> caller_struct; \
+        template <typename... CallArgs> \
+        static auto make_bulk_call(CallArgs&&... _d_args) -> decltype(caller_struct::make_bulk_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return caller_struct::make_bulk_call(std::forward<CallArgs>(_d_args)...); \
+        } \
+        /* the caller is a template argument, so that calls which only one of the mechanisms has aren't looked up for the other one */ \
+        template <typename Caller = caller_struct, typename... CallArgs> \
+        static auto make_combinator_bulk_call(CallArgs&&... _d_args) -> decltype(Caller::make_combinator_bulk_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return Caller::make_combinator_bulk_call(std::forward<CallArgs>(_d_args)...); \
+        } \
+        template <typename Caller = caller_struct, typename... CallArgs> \
+        static auto make_cached_call(CallArgs&&... _d_args) -> decltype(Caller::make_cached_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return Caller::make_cached_call(std::forward<CallArgs>(_d_args)...); \
+        } \
     }; \
     /* step 2: define a message tag, that will be used to identify the message in feature lists */ \
     /* it would have been nice if we could set this global variable to the unique global instance of the feature*/ \
@@ -636,6 +741,7 @@
     struct export I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name) : public ::dynamix::internal::message_t \
     { \
         typedef return_type (*caller_func)(void* , arg0_type, arg1_type, arg2_type, arg3_type, arg4_type); \
+        typedef ::dynamix::internal::msg_caller<return_type , arg0_type, arg1_type, arg2_type, arg3_type, arg4_type>::batch_caller_func batch_caller_func; \
         I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name)() \
             : ::dynamix::internal::message_t(I_DYNAMIX_PP_STRINGIZE(message_name), message_mechanism, false) \
         {} \
@@ -651,6 +757,26 @@
             /* cast the caller to a void (*)() - safe according to the standard */ \
             return reinterpret_cast< ::dynamix::internal::func_ptr>(the_caller); \
         } \
+        /* the calls for ranges of objects, the combinator and the cached calls are the same as the ones of the new-style macros */ \
+        /* since they're templates they're only instantiated for messages which use them */ \
+        typedef ::dynamix::internal::I_DYNAMIX_MESSAGE_CALLER_STRUCT(message_mechanism) \
+            <I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name), constness ::dynamix::object, return_type , arg0_type, arg1_type, arg2_type, arg3_type, arg4_type> caller_struct; \
+        template <typename... CallArgs> \
+        static auto make_bulk_call(CallArgs&&... _d_args) -> decltype(caller_struct::make_bulk_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return caller_struct::make_bulk_call(std::forward<CallArgs>(_d_args)...); \
+        } \
+        /* the caller is a template argument, so that calls which only one of the mechanisms has aren't looked up for the other one */ \
+        template <typename Caller = caller_struct, typename... CallArgs> \
+        static auto make_combinator_bulk_call(CallArgs&&... _d_args) -> decltype(Caller::make_combinator_bulk_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return Caller::make_combinator_bulk_call(std::forward<CallArgs>(_d_args)...); \
+        } \
+        template <typename Caller = caller_struct, typename... CallArgs> \
+        static auto make_cached_call(CallArgs&&... _d_args) -> decltype(Caller::make_cached_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return Caller::make_cached_call(std::forward<CallArgs>(_d_args)...); \
+        } \
     }; \
     /* step 2: define a message tag, that will be used to identify the message in feature lists */ \
     /* it would have been nice if we could set this global variable to the unique global instance of the feature*/ \
@@ -760,6 +886,7 @@
     struct export I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name) : public ::dynamix::internal::message_t \
     { \
         typedef return_type (*caller_func)(void* , arg0_type, arg1_type, arg2_type, arg3_type, arg4_type, arg5_type); \
+        typedef ::dynamix::internal::msg_caller<return_type , arg0_type, arg1_type, arg2_type, arg3_type, arg4_type, arg5_type>::batch_caller_func batch_caller_func; \
         I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name)() \
             : ::dynamix::internal::message_t(I_DYNAMIX_PP_STRINGIZE(message_name), message_mechanism, false) \
         {} \
@@ -775,6 +902,26 @@
             /* cast the caller to a void (*)() - safe according to the standard */ \
             return reinterpret_cast< ::dynamix::internal::func_ptr>(the_caller); \
         } \
+        /* the calls for ranges of objects, the combinator and the cached calls are the same as the ones of the new-style macros */ \
+        /* since they're templates they're only instantiated for messages which use them */ \
+        typedef ::dynamix::internal::I_DYNAMIX_MESSAGE_CALLER_STRUCT(message_mechanism) \
+            <I_DYNAMIX_MESSAGE_STRUCT_NAME(message_name), constness ::dynamix::object, return_type , arg0_type, arg1_type, arg2_type, arg3_type, arg4_type, arg5_type> caller_struct; \
+        template <typename... CallArgs> \
+        static auto make_bulk_call(CallArgs&&... _d_args) -> decltype(caller_struct::make_bulk_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return caller_struct::make_bulk_call(std::forward<CallArgs>(_d_args)...); \
+        } \
+        /* the caller is a template argument, so that calls which only one of the mechanisms has aren't looked up for the other one */ \
+        template <typename Caller = caller_struct, typename... CallArgs> \
+        static auto make_combinator_bulk_call(CallArgs&&... _d_args) -> decltype(Caller::make_combinator_bulk_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return Caller::make_combinator_bulk_call(std::forward<CallArgs>(_d_args)...); \
+        } \
+        template <typename Caller = caller_struct, typename... CallArgs> \
+        static auto make_cached_call(CallArgs&&... _d_args) -> decltype(Caller::make_cached_call(std::forward<CallArgs>(_d_args)...)) \
+        { \
+            return Caller::make_cached_call(std::forward<CallArgs>(_d_args)...); \
+        } \
     }; \
     /* step 2: define a message tag, that will be used to identify the message in feature lists */ \
     /* it would have been nice if we could set this global variable to the unique global instance of the feature*/ \
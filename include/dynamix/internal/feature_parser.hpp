@@ -116,6 +116,14 @@ public:
         return *this;
     }
 
+    template <typename Message>
+    feature_parser_phase_2& operator & (message_perks_and_batch_caller<Message> mp)
+    {
+        Message& msg = get_registered_feature<Message>();
+        parse_message(msg, mp.bid, mp.priority, msg.template get_caller_for<Mixin>(), mp.batch_caller);
+        return *this;
+    }
+
     // unique_features which we con't care about at this phase
     feature_parser_phase_2& operator & (mixin_allocator&) { return *this; }
     feature_parser_phase_2& operator & (mixin_name_feature) { return *this; }
@@ -138,7 +146,7 @@ private:
         parse_message(msg, 0, 0, msg.template get_caller_for<Mixin>());
     }
 
-    void parse_message(message_t& msg, int bid, int priority, func_ptr caller)
+    void parse_message(message_t& msg, int bid, int priority, func_ptr caller, func_ptr batch_caller = nullptr)
     {
 #if DYNAMIX_DEBUG
         // check for duplicate entries
@@ -154,6 +162,12 @@ private:
         mfm.caller = caller;
         mfm.bid = bid;
         mfm.priority = priority;
+        mfm.batch_caller = batch_caller;
+
+        if (batch_caller)
+        {
+            info.has_batch_messages = true;
+        }
     }
 
     mixin_type_info& info;
@@ -0,0 +1,147 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+/**
+ * \file
+ * A set of small ids (of mixins, messages or type classes) as bits.
+ */
+
+#include "../config.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+namespace dynamix
+{
+namespace internal
+{
+
+// a set of ids as bits
+// it grows to fit the ids added to it, so sets of different sizes can be combined
+// and testing an id which is out of bounds is the same as testing one which isn't in the set
+class id_bitset
+{
+public:
+    bool has(size_t id) const
+    {
+        const size_t w = id / 64;
+        return w < _words.size() && (_words[w] & (uint64_t(1) << (id % 64)));
+    }
+
+    void add(size_t id)
+    {
+        const size_t w = id / 64;
+        if (w >= _words.size()) _words.resize(w + 1, 0);
+        _words[w] |= uint64_t(1) << (id % 64);
+    }
+
+    void add(const id_bitset& other)
+    {
+        if (other._words.size() > _words.size()) _words.resize(other._words.size(), 0);
+        for (size_t i = 0; i < other._words.size(); ++i)
+        {
+            _words[i] |= other._words[i];
+        }
+    }
+
+    void remove(const id_bitset& other)
+    {
+        const size_t n = std::min(_words.size(), other._words.size());
+        for (size_t i = 0; i < n; ++i)
+        {
+            _words[i] &= ~other._words[i];
+        }
+    }
+
+    // checks if all ids of the other set are in this one
+    bool has_all(const id_bitset& other) const
+    {
+        for (size_t i = 0; i < other._words.size(); ++i)
+        {
+            const uint64_t w = i < _words.size() ? _words[i] : 0;
+            if ((w & other._words[i]) != other._words[i]) return false;
+        }
+        return true;
+    }
+
+    // checks if any id of the other set is in this one
+    bool intersects(const id_bitset& other) const
+    {
+        const size_t n = std::min(_words.size(), other._words.size());
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (_words[i] & other._words[i]) return true;
+        }
+        return false;
+    }
+
+    bool empty() const
+    {
+        for (auto w : _words)
+        {
+            if (w) return false;
+        }
+        return true;
+    }
+
+    size_t count() const
+    {
+        size_t ret = 0;
+        for (auto w : _words)
+        {
+            for (; w; w &= w - 1) ++ret;
+        }
+        return ret;
+    }
+
+    // keeps the allocated memory
+    void clear()
+    {
+        std::fill(_words.begin(), _words.end(), uint64_t(0));
+    }
+
+    // calls f with the ids in the set in ascending order
+    template <typename F>
+    void for_each(F f) const
+    {
+        for (size_t i = 0; i < _words.size(); ++i)
+        {
+            for (uint64_t w = _words[i]; w; w &= w - 1)
+            {
+                f(i * 64 + lowest_bit(w));
+            }
+        }
+    }
+
+    // memory allocated outside of the set object
+    size_t allocated_size() const { return _words.capacity() * sizeof(uint64_t); }
+
+private:
+    static size_t lowest_bit(uint64_t w)
+    {
+#if defined(__GNUC__)
+        return size_t(__builtin_ctzll(w));
+#else
+        size_t i = 0;
+        while (!(w & 1))
+        {
+            w >>= 1;
+            ++i;
+        }
+        return i;
+#endif
+    }
+
+    std::vector<uint64_t> _words;
+};
+
+} // namespace internal
+} // namespace dynamix
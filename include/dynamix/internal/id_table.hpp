@@ -0,0 +1,162 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+/**
+ * \file
+ * Tables indexed by mixin or message ids used by object type infos.
+ */
+
+#include "../config.hpp"
+#include "assert.hpp"
+
+#include <memory>
+#include <cstddef>
+
+namespace dynamix
+{
+namespace internal
+{
+
+// the tables are for trivial types only: their elements start zero-initialized
+// reading is done with operator[] and writing with edit
+// a table is sized with resize before it's edited
+// reading an id which is out of bounds returns a zero element, so a table only needs to be
+// big enough for the ids it has and ids which are registered after it was created are safe to read
+
+// a plain array with an element for each id up to the size
+// the fastest to access but a type info pays for all ids below the biggest one it has
+template <typename T>
+class flat_id_table
+{
+public:
+    flat_id_table() = default;
+
+    flat_id_table(const flat_id_table&) = delete;
+    flat_id_table& operator=(const flat_id_table&) = delete;
+
+    // discards the existing elements
+    void resize(size_t size)
+    {
+        _data.reset(size ? new T[size]() : nullptr);
+        _size = size;
+    }
+
+    size_t size() const { return _size; }
+
+    const T& operator[](size_t id) const { return id < _size ? _data[id] : zero_element(); }
+
+    T& edit(size_t id)
+    {
+        I_DYNAMIX_ASSERT(id < _size);
+        return _data[id];
+    }
+
+    // memory allocated outside of the table object
+    size_t allocated_size() const { return _size * sizeof(T); }
+
+private:
+    static const T& zero_element()
+    {
+        static const T element = T();
+        return element;
+    }
+
+    std::unique_ptr<T[]> _data;
+    size_t _size = 0;
+};
+
+// a two-level table where a page of elements is only allocated if an id
+// within it is edited
+// all pages which are never edited point to a single shared page of zeroes,
+// so access is still two loads (plus the bounds check)
+template <typename T, size_t PageSize>
+class paged_id_table
+{
+    static_assert((PageSize & (PageSize - 1)) == 0, "page size must be a power of two");
+public:
+    paged_id_table() = default;
+
+    ~paged_id_table()
+    {
+        free_pages();
+    }
+
+    paged_id_table(const paged_id_table&) = delete;
+    paged_id_table& operator=(const paged_id_table&) = delete;
+
+    // discards the existing elements
+    void resize(size_t size)
+    {
+        free_pages();
+        _num_pages = (size + PageSize - 1) / PageSize;
+        _pages.reset(_num_pages ? new T*[_num_pages] : nullptr);
+        for (size_t i = 0; i < _num_pages; ++i)
+        {
+            _pages[i] = empty_page();
+        }
+    }
+
+    size_t size() const { return _num_pages * PageSize; }
+
+    const T& operator[](size_t id) const
+    {
+        const size_t page = id / PageSize;
+        return page < _num_pages ? _pages[page][id % PageSize] : empty_page()[0];
+    }
+
+    T& edit(size_t id)
+    {
+        I_DYNAMIX_ASSERT(id / PageSize < _num_pages);
+        T*& page = _pages[id / PageSize];
+        if (page == empty_page())
+        {
+            page = new T[PageSize]();
+        }
+        return page[id % PageSize];
+    }
+
+    // memory allocated outside of the table object
+    size_t allocated_size() const
+    {
+        size_t ret = _num_pages * sizeof(T*);
+        for (size_t i = 0; i < _num_pages; ++i)
+        {
+            if (_pages[i] != empty_page())
+            {
+                ret += sizeof(T) * PageSize;
+            }
+        }
+        return ret;
+    }
+
+private:
+    static T* empty_page()
+    {
+        // zero-initialized and never written to
+        static T page[PageSize];
+        return page;
+    }
+
+    void free_pages()
+    {
+        for (size_t i = 0; i < _num_pages; ++i)
+        {
+            if (_pages[i] != empty_page())
+            {
+                delete[] _pages[i];
+            }
+        }
+    }
+
+    std::unique_ptr<T*[]> _pages;
+    size_t _num_pages = 0;
+};
+
+} // namespace internal
+} // namespace dynamix
@@ -11,20 +11,139 @@
 #include "../message.hpp"
 #include "../exception.hpp"
 #include "../object_type_info.hpp"
+#include "../domain.hpp"
 #include "assert.hpp"
+#include "preprocessor.hpp"
 
 namespace dynamix
 {
 namespace internal
 {
 
+// bulk calls accept ranges of objects or ranges of pointers to objects
+template <typename Object>
+Object& bulk_call_object(Object& obj) { return obj; }
+
+template <typename Object>
+Object& bulk_call_object(Object* obj) { return *obj; }
+
+// finds the end of the run of objects of the same type which starts at begin
+template <typename ObjectIterator>
+ObjectIterator bulk_call_run_end(ObjectIterator begin, ObjectIterator end)
+{
+    const object_type_info* type = bulk_call_object(*begin)._type_info;
+    while (++begin != end && bulk_call_object(*begin)._type_info == type);
+    return begin;
+}
+
 // defines calling function
+// the mixins of consecutive objects of the same type are passed to batch callers
+// in chunks of at most this many
+static constexpr size_t bulk_call_batch_size = 64;
+
 template <typename Ret, typename... Args>
 struct msg_caller
 {
     using caller_func = Ret (*)(void*, Args...);
+
+    // batch callers return nothing, since they're only used when the results are discarded
+    using batch_caller_func = void (*)(void* const*, size_t, Args...);
+
+    // calls a batch caller for the mixins at an index of all objects in a range
+    // (which must all be of the same type)
+    template <typename ObjectIterator>
+    static void make_batch_call(ObjectIterator begin, ObjectIterator end, uint32_t mixin_index, batch_caller_func func, const Args&... args)
+    {
+        void* mixins[bulk_call_batch_size];
+        while (begin != end)
+        {
+            size_t num = 0;
+            do
+            {
+                mixins[num++] = const_cast<void*>(bulk_call_object(*begin)._mixin_data[mixin_index].mixin());
+            } while (++begin != end && num < bulk_call_batch_size);
+
+            func(mixins, num, args...);
+        }
+    }
 };
 
+// a unicast call resolved for a single type info
+// used by message handles to skip the call table for consecutive calls for the same type
+struct unicast_call_cache
+{
+    const object_type_info* type = nullptr;
+    size_t type_info_generation = 0;
+    func_ptr caller = nullptr;
+    uint32_t mixin_index = 0;
+    feature_id id = INVALID_FEATURE_ID;
+
+    size_t num_hits = 0;
+    size_t num_misses = 0;
+};
+
+#if DYNAMIX_MESSAGE_CALL_CACHE
+// a small polymorphic cache of resolved unicast calls for the last few types
+// used as a thread-local static in the unicast message functions
+// thus all calls of a message on a thread share a cache
+// it must stay trivial, so that no thread-local initialization is needed
+template <size_t Size>
+struct message_call_cache
+{
+    static_assert(Size > 0, "the message call cache needs at least one entry");
+
+    struct entry
+    {
+        const object_type_info* type;
+        object_type_info::call_table_message msg;
+    };
+
+    entry entries[Size];
+    size_t type_info_generation;
+    size_t next_replaced;
+
+    const object_type_info::call_table_message* find(const object_type_info* type)
+    {
+        const size_t generation = domain::type_info_generation();
+        if (generation != type_info_generation)
+        {
+            // some type infos have been destroyed since the entries were cached
+            // one of them might have had the address of a new one
+            for (auto& e : entries) e.type = nullptr;
+            type_info_generation = generation;
+            return nullptr;
+        }
+
+        for (auto& e : entries)
+        {
+            if (e.type == type) return &e.msg;
+        }
+
+        return nullptr;
+    }
+
+    const object_type_info::call_table_message* add(const object_type_info* type, const object_type_info::call_table_message& msg)
+    {
+        entry& e = entries[next_replaced];
+        next_replaced = (next_replaced + 1) % Size;
+        e.type = type;
+        e.msg = msg;
+        return &e.msg;
+    }
+};
+#endif
+
+// while calling a message for an object in a bulk call, start loading the mixin of the next one
+// only objects of the same type are guaranteed to have a mixin at this index
+template <typename Object>
+void bulk_call_prefetch(const Object& next, const object_type_info* type, uint32_t mixin_index)
+{
+    if (next._type_info == type)
+    {
+        I_DYNAMIX_PREFETCH(next._mixin_data[mixin_index].mixin());
+    }
+}
+
 // instead of adding the multi and unicast calls in the same struct, we split it in two
 // thus multicast messages, won't also instantiate and compile the unicast call and vice-versa
 
@@ -40,6 +159,32 @@ struct msg_unicast : public message_t, public msg_caller<Ret, Args...>
     {}
 
     static Ret make_call(Object& obj, Args&&... args)
+    {
+#if DYNAMIX_MESSAGE_CALL_CACHE
+        static thread_local message_call_cache<DYNAMIX_MESSAGE_CALL_CACHE_SIZE> cache;
+
+        const object_type_info::call_table_message* cached = cache.find(obj._type_info);
+        if (!cached)
+        {
+            cached = cache.add(obj._type_info, resolve_call(obj));
+        }
+        const object_type_info::call_table_message& msg = *cached;
+#else
+        const object_type_info::call_table_message& msg = resolve_call(obj);
+#endif
+
+        // unfortunately we can't assert(msg_data.data->message == &self); since the data might come from a different module
+
+        // skipping several function calls, which greatly improves build time
+        char* mixin_data = reinterpret_cast<char*>(const_cast<void*>(obj._mixin_data[msg.mixin_index].mixin()));
+
+        auto func = reinterpret_cast<typename msg_caller<Ret, Args...>::caller_func>(msg.caller);
+
+        return func(mixin_data, std::forward<Args>(args)...);
+    }
+
+    // finds the top bidder for the message in the object's call table
+    static const object_type_info::call_table_message& resolve_call(Object& obj)
     {
         const ::dynamix::feature& self = _dynamix_get_mixin_feature_fast(static_cast<Derived*>(nullptr));
         I_DYNAMIX_ASSERT(static_cast<const message_t&>(self).mechanism
@@ -51,15 +196,96 @@ struct msg_unicast : public message_t, public msg_caller<Ret, Args...>
         const object_type_info::call_table_message& msg = call_entry.top_bid_message;
         DYNAMIX_MSG_THROW_UNLESS(!!msg, ::dynamix::bad_message_call);
 
-        // unfortunately we can't assert(msg_data.data->message == &self); since the data might come from a different module
+        return msg;
+    }
 
-        // skipping several function calls, which greatly improves build time
-        char* mixin_data = reinterpret_cast<char*>(const_cast<void*>(obj._mixin_data[msg.mixin_index].mixin()));
+    // same as make_call, but the resolved call is taken from the cache if it is for the same type
+    // the arguments are passed by value, as they are in the message functions
+    static Ret make_cached_call(unicast_call_cache& cache, Object& obj, Args... args)
+    {
+        if (obj._type_info == cache.type && cache.type_info_generation == domain::type_info_generation())
+        {
+            ++cache.num_hits;
+        }
+        else
+        {
+            if (cache.id == INVALID_FEATURE_ID)
+            {
+                const ::dynamix::feature& self = _dynamix_get_mixin_feature_fast(static_cast<Derived*>(nullptr));
+                I_DYNAMIX_ASSERT(static_cast<const message_t&>(self).mechanism
+                    == message_t::unicast);
+                cache.id = self.id;
+            }
 
-        auto func = reinterpret_cast<typename msg_caller<Ret, Args...>::caller_func>(msg.caller);
+            const object_type_info::call_table_message& msg =
+                obj._type_info->_call_table[cache.id].top_bid_message;
+            DYNAMIX_MSG_THROW_UNLESS(!!msg, ::dynamix::bad_message_call);
+
+            cache.type = obj._type_info;
+            cache.type_info_generation = domain::type_info_generation();
+            cache.caller = msg.caller;
+            cache.mixin_index = msg.mixin_index;
+            ++cache.num_misses;
+        }
+
+        char* mixin_data = reinterpret_cast<char*>(const_cast<void*>(obj._mixin_data[cache.mixin_index].mixin()));
+
+        auto func = reinterpret_cast<typename msg_caller<Ret, Args...>::caller_func>(cache.caller);
 
         return func(mixin_data, std::forward<Args>(args)...);
     }
+
+    // calls the message for all objects in a range discarding the results
+    // the call table is only accessed when the type changes between consecutive objects
+    // arguments are not forwarded since they are used for multiple calls
+    template <typename ObjectIterator>
+    static void make_bulk_call(ObjectIterator begin, ObjectIterator end, const Args&... args)
+    {
+        const ::dynamix::feature& self = _dynamix_get_mixin_feature_fast(static_cast<Derived*>(nullptr));
+        I_DYNAMIX_ASSERT(static_cast<const message_t&>(self).mechanism
+            == message_t::unicast);
+
+        const object_type_info* run_type = nullptr;
+        uint32_t mixin_index = 0;
+        typename msg_caller<Ret, Args...>::caller_func func = nullptr;
+        typename msg_caller<Ret, Args...>::batch_caller_func batch_func = nullptr;
+
+        for (auto iter = begin; iter != end; )
+        {
+            Object& obj = bulk_call_object(*iter);
+
+            if (obj._type_info != run_type)
+            {
+                run_type = obj._type_info;
+
+                const object_type_info::call_table_message& msg =
+                    run_type->_call_table[self.id].top_bid_message;
+                DYNAMIX_MSG_THROW_UNLESS(!!msg, ::dynamix::bad_message_call);
+
+                mixin_index = msg.mixin_index;
+                func = reinterpret_cast<typename msg_caller<Ret, Args...>::caller_func>(msg.caller);
+                batch_func = reinterpret_cast<typename msg_caller<Ret, Args...>::batch_caller_func>(run_type->batch_caller(self.id, mixin_index));
+            }
+
+            if (batch_func)
+            {
+                // the mixin has a batch implementation for this message
+                // call it for the whole run of objects of this type
+                auto run_end = bulk_call_run_end(iter, end);
+                msg_caller<Ret, Args...>::make_batch_call(iter, run_end, mixin_index, batch_func, args...);
+                iter = run_end;
+                continue;
+            }
+
+            if (++iter != end)
+            {
+                bulk_call_prefetch(bulk_call_object(*iter), run_type, mixin_index);
+            }
+
+            char* mixin_data = reinterpret_cast<char*>(const_cast<void*>(obj._mixin_data[mixin_index].mixin()));
+            func(mixin_data, args...);
+        }
+    }
 };
 
 // caller struct instantiated by message macros
@@ -146,6 +372,141 @@ struct msg_multicast : public message_t, public msg_caller<Ret, Args...>
             func(mixin_data, args...);
         }
     }
+
+    // calls the message for all objects in a range
+    // the call table is only accessed when the type changes between consecutive objects
+    template <typename ObjectIterator>
+    static void make_bulk_call(ObjectIterator begin, ObjectIterator end, const Args&... args)
+    {
+        const ::dynamix::feature& self = _dynamix_get_mixin_feature_fast(static_cast<Derived*>(nullptr));
+        I_DYNAMIX_ASSERT(static_cast<const message_t&>(self).mechanism
+            == message_t::multicast);
+
+        const object_type_info* run_type = nullptr;
+        const object_type_info::call_table_message* msg_begin = nullptr;
+        const object_type_info::call_table_message* msg_end = nullptr;
+        bool run_has_batch = false;
+
+        for (auto iter = begin; iter != end; )
+        {
+            Object& obj = bulk_call_object(*iter);
+
+            if (obj._type_info != run_type)
+            {
+                run_type = obj._type_info;
+
+                const object_type_info::call_table_entry& call_entry = run_type->_call_table[self.id];
+                msg_begin = call_entry.begin;
+                msg_end = call_entry.end;
+
+                DYNAMIX_MULTICAST_MSG_THROW_UNLESS(msg_begin, ::dynamix::bad_message_call);
+
+                run_has_batch = false;
+                for (auto msg = msg_begin; msg != msg_end; ++msg)
+                {
+                    if (run_type->batch_caller(self.id, msg->mixin_index))
+                    {
+                        run_has_batch = true;
+                        break;
+                    }
+                }
+            }
+
+            if (run_has_batch)
+            {
+                // some mixins have a batch implementation for this message
+                // call each message in the chain for the whole run of objects of this type
+                // thus the messages for a single object are still called in the chain order
+                auto run_end = bulk_call_run_end(iter, end);
+                for (auto msg = msg_begin; msg != msg_end; ++msg)
+                {
+                    auto batch_func = reinterpret_cast<typename msg_caller<Ret, Args...>::batch_caller_func>(run_type->batch_caller(self.id, msg->mixin_index));
+                    if (batch_func)
+                    {
+                        msg_caller<Ret, Args...>::make_batch_call(iter, run_end, msg->mixin_index, batch_func, args...);
+                        continue;
+                    }
+
+                    auto func = reinterpret_cast<typename msg_caller<Ret, Args...>::caller_func>(msg->caller);
+                    for (auto run_iter = iter; run_iter != run_end; ++run_iter)
+                    {
+                        char* mixin_data = reinterpret_cast<char*>(const_cast<void*>(bulk_call_object(*run_iter)._mixin_data[msg->mixin_index].mixin()));
+                        func(mixin_data, args...);
+                    }
+                }
+                iter = run_end;
+                continue;
+            }
+
+            if (++iter != end && msg_begin)
+            {
+                bulk_call_prefetch(bulk_call_object(*iter), run_type, msg_begin->mixin_index);
+            }
+
+            for (auto msg = msg_begin; msg != msg_end; ++msg)
+            {
+                I_DYNAMIX_ASSERT(!!*msg);
+
+                char* mixin_data = reinterpret_cast<char*>(const_cast<void*>(obj._mixin_data[msg->mixin_index].mixin()));
+
+                auto func = reinterpret_cast<typename msg_caller<Ret, Args...>::caller_func>(msg->caller);
+
+                func(mixin_data, args...);
+            }
+        }
+    }
+
+    // calls the message for all objects in a range adding the results to a combinator
+    // same as calling make_combinator_call for each object with the same combinator
+    // the call table is only accessed when the type changes between consecutive objects
+    template <typename ObjectIterator, typename Combinator>
+    static void make_combinator_bulk_call(ObjectIterator begin, ObjectIterator end, Combinator& combinator, const Args&... args)
+    {
+        const ::dynamix::feature& self = _dynamix_get_mixin_feature_fast(static_cast<Derived*>(nullptr));
+        I_DYNAMIX_ASSERT(static_cast<const message_t&>(self).mechanism
+            == message_t::multicast);
+
+        const object_type_info* run_type = nullptr;
+        const object_type_info::call_table_message* msg_begin = nullptr;
+        const object_type_info::call_table_message* msg_end = nullptr;
+
+        for (auto iter = begin; iter != end; )
+        {
+            Object& obj = bulk_call_object(*iter);
+
+            if (obj._type_info != run_type)
+            {
+                run_type = obj._type_info;
+
+                const object_type_info::call_table_entry& call_entry = run_type->_call_table[self.id];
+                msg_begin = call_entry.begin;
+                msg_end = call_entry.end;
+
+                DYNAMIX_MULTICAST_MSG_THROW_UNLESS(msg_begin, ::dynamix::bad_message_call);
+            }
+
+            if (++iter != end && msg_begin)
+            {
+                bulk_call_prefetch(bulk_call_object(*iter), run_type, msg_begin->mixin_index);
+            }
+
+            set_num_results_for(combinator, size_t(msg_end - msg_begin));
+            for (auto msg = msg_begin; msg != msg_end; ++msg)
+            {
+                I_DYNAMIX_ASSERT(!!*msg);
+
+                char* mixin_data = reinterpret_cast<char*>(const_cast<void*>(obj._mixin_data[msg->mixin_index].mixin()));
+
+                auto func = reinterpret_cast<typename msg_caller<Ret, Args...>::caller_func>(msg->caller);
+
+                if (!combinator.add_result(func(mixin_data, args...)))
+                {
+                    // stop the chain of this object only
+                    break;
+                }
+            }
+        }
+    }
 };
 } // namespace internal
 } // namespace dynamix
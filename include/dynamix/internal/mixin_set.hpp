@@ -0,0 +1,194 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+/**
+ * \file
+ * A set of mixin ids used to identify object types.
+ */
+
+#include "../config.hpp"
+#include "../mixin_id.hpp"
+
+#include <memory>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+
+namespace dynamix
+{
+namespace internal
+{
+
+// a set of mixin ids
+// the ids are kept sorted in an array so the size of a set and the cost of its operations
+// are proportional to the number of mixins in it and not to the number of registered mixins
+// small sets are stored inline, so the sets in mutations typically don't allocate
+// the hash of the set is updated with each change so hashing it is free
+class mixin_set
+{
+public:
+    using const_iterator = const mixin_id*;
+
+    static constexpr size_t inline_capacity = 8;
+
+    mixin_set() noexcept = default;
+
+    mixin_set(const mixin_set& other)
+    {
+        *this = other;
+    }
+
+    mixin_set& operator=(const mixin_set& other)
+    {
+        if (this == &other) return *this;
+
+        if (other._size > _capacity)
+        {
+            // no need to keep the current elements
+            _heap.reset(new mixin_id[other._size]);
+            _capacity = other._size;
+        }
+
+        std::copy(other.begin(), other.end(), data());
+        _size = other._size;
+        _hash = other._hash;
+        return *this;
+    }
+
+    // moved-from sets are empty
+    mixin_set(mixin_set&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    mixin_set& operator=(mixin_set&& other) noexcept
+    {
+        if (this == &other) return *this;
+
+        if (other._heap)
+        {
+            _heap = std::move(other._heap);
+            _capacity = other._capacity;
+            other._capacity = inline_capacity;
+        }
+        else
+        {
+            _heap.reset();
+            _capacity = inline_capacity;
+            std::copy(other.begin(), other.end(), _inline);
+        }
+
+        _size = other._size;
+        _hash = other._hash;
+        other.clear();
+        return *this;
+    }
+
+    bool has(mixin_id id) const noexcept
+    {
+        return std::binary_search(begin(), end(), id);
+    }
+
+    // returns false if the id was already in the set
+    bool add(mixin_id id)
+    {
+        auto pos = size_t(std::lower_bound(begin(), end(), id) - begin());
+        if (pos != _size && data()[pos] == id) return false;
+
+        if (_size == _capacity)
+        {
+            grow(_capacity * 2);
+        }
+
+        mixin_id* d = data();
+        std::copy_backward(d + pos, d + _size, d + _size + 1);
+        d[pos] = id;
+        ++_size;
+        _hash += hash_of(id);
+        return true;
+    }
+
+    // returns false if the id wasn't in the set
+    bool remove(mixin_id id)
+    {
+        auto i = std::lower_bound(begin(), end(), id);
+        if (i == end() || *i != id) return false;
+
+        mixin_id* d = data();
+        const size_t pos = size_t(i - begin());
+        std::copy(d + pos + 1, d + _size, d + pos);
+        --_size;
+        _hash -= hash_of(id);
+        return true;
+    }
+
+    // keeps the allocated memory
+    void clear()
+    {
+        _size = 0;
+        _hash = 0;
+    }
+
+    bool empty() const { return _size == 0; }
+    size_t size() const { return _size; }
+
+    // the ids in ascending order
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + _size; }
+
+    // the biggest id in the set plus one (zero for an empty set)
+    size_t id_bound() const { return _size ? data()[_size - 1] + 1 : 0; }
+
+    size_t hash() const { return _hash; }
+
+    // memory allocated outside of the set object
+    size_t allocated_size() const { return _heap ? _capacity * sizeof(mixin_id) : 0; }
+
+    bool operator==(const mixin_set& other) const
+    {
+        return _hash == other._hash
+            && _size == other._size
+            && std::equal(begin(), end(), other.begin());
+    }
+
+    bool operator!=(const mixin_set& other) const { return !(*this == other); }
+
+private:
+    mixin_id* data() { return _heap ? _heap.get() : _inline; }
+    const mixin_id* data() const { return _heap ? _heap.get() : _inline; }
+
+    void grow(size_t capacity)
+    {
+        std::unique_ptr<mixin_id[]> heap(new mixin_id[capacity]);
+        std::copy(begin(), end(), heap.get());
+        _heap = std::move(heap);
+        _capacity = capacity;
+    }
+
+    // the hash of a set is the sum of the hashes of its ids, so it doesn't depend on the order
+    // in which they were added and it can be updated when a single id is added or removed
+    static size_t hash_of(mixin_id id)
+    {
+        // the finalizer of splitmix64 (truncated on 32-bit platforms)
+        // mixes the bits, so that the sums of close ids don't collide
+        unsigned long long x = id + 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return size_t(x ^ (x >> 31));
+    }
+
+    mixin_id _inline[inline_capacity];
+    std::unique_ptr<mixin_id[]> _heap; // used when the ids don't fit inline
+    size_t _size = 0;
+    size_t _capacity = inline_capacity;
+    size_t _hash = 0;
+};
+
+} // namespace internal
+} // namespace dynamix
@@ -24,7 +24,8 @@ namespace internal
 
 // getters of type info based on typeid
 #if DYNAMIX_USE_TYPEID
-    extern DYNAMIX_API const char* get_mixin_name_from_typeid(const char* typeid_name);
+    // out_owns_name is set to true if the name must be freed with free_mixin_name_from_typeid
+    extern DYNAMIX_API const char* get_mixin_name_from_typeid(const char* typeid_name, bool& out_owns_name);
 #   if defined(__GNUC__)
     extern DYNAMIX_API void free_mixin_name_from_typeid(const char* typeid_name);
 #   endif
@@ -138,9 +139,12 @@ void set_missing_traits_to_info(mixin_type_info& info)
     if (!info.name)
     {
 #if DYNAMIX_USE_TYPEID
-        info.name = get_mixin_name_from_typeid(typeid(Mixin).name());
+        bool owns_name;
+        info.name = get_mixin_name_from_typeid(typeid(Mixin).name(), owns_name);
 #   if defined(__GNUC__)
-        info.owns_name = true;
+        info.owns_name = owns_name;
+#   else
+        (void)owns_name;
 #   endif
 #elif DYNAMIX_USE_STATIC_MEMBER_NAME
         // defining DYNAMIX_USE_STATIC_MEMBER_NAME means that you must provide
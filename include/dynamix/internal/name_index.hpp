@@ -0,0 +1,92 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+/**
+ * \file
+ * A hash index of the names of registered mixins or messages.
+ */
+
+#include "../config.hpp"
+
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+namespace dynamix
+{
+namespace internal
+{
+
+// a hash index from names to the ids of the registered mixins or messages
+//
+// the names are interned: the index keeps its own copy of each name it has seen
+// and the interned copy of a name never changes, even if its entry is unregistered
+// and registered again (as happens when a plugin is reloaded)
+// thus the interned names can be compared by address
+//
+// each interned name has an entry with the id currently associated with it
+// the entries are never moved or destroyed, so they can be referenced by handles
+// which need the id of a name without looking it up
+//
+// it's not thread safe: it's modified only when registering, which must be serialized
+class DYNAMIX_API name_index
+{
+private:
+    struct name_hash
+    {
+        size_t operator()(const char* name) const;
+    };
+
+    struct name_equal
+    {
+        bool operator()(const char* a, const char* b) const;
+    };
+
+    using map = std::unordered_map<const char*, size_t, name_hash, name_equal>;
+
+public:
+    static constexpr size_t npos = ~size_t(0);
+
+    // an interned name (first) and its id (second) which is npos if there is none
+    // it lives as long as the index
+    using entry = map::value_type;
+
+    name_index();
+    ~name_index();
+
+    name_index(const name_index&) = delete;
+    name_index& operator=(const name_index&) = delete;
+
+    // returns the id associated with the name or npos if there is none
+    size_t find(const char* name) const;
+
+    // associates the name with an id
+    // returns false and doesn't change the index if the name already has an id
+    bool insert(const char* name, size_t id);
+
+    // removes the id associated with the name, but keeps the interned name
+    void erase(const char* name);
+
+    // returns the entry of the name, adding it to the index if needed
+    const entry& intern(const char* name);
+
+    // returns the entry of the name or nullptr if the index hasn't seen it
+    const entry* find_entry(const char* name) const;
+
+private:
+    map::iterator intern_entry(const char* name);
+
+    // the keys point to the interned names
+    map _ids;
+    std::vector<std::unique_ptr<char[]>> _interned_names;
+};
+
+} // namespace internal
+} // namespace dynamix
@@ -19,4 +19,14 @@
 
 #define I_DYNAMIX_PP_STRINGIZE(x) #x
 
-#define I_DYNAMIX_MAYBE_UNUSED(x) (void)(x)
\ No newline at end of file
+#define I_DYNAMIX_MAYBE_UNUSED(x) (void)(x)
+
+// hint the cpu that the memory at an address will soon be read
+#if defined(__GNUC__)
+#   define I_DYNAMIX_PREFETCH(addr) __builtin_prefetch(addr)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#   include <xmmintrin.h>
+#   define I_DYNAMIX_PREFETCH(addr) _mm_prefetch(reinterpret_cast<const char*>(addr), _MM_HINT_T0)
+#else
+#   define I_DYNAMIX_PREFETCH(addr) I_DYNAMIX_MAYBE_UNUSED(addr)
+#endif
@@ -0,0 +1,114 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+#include "../config.hpp"
+#include "../mixin_collection.hpp"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace dynamix
+{
+
+class object_type_info;
+
+namespace internal
+{
+
+// a hash map of the object type infos in a domain, which owns them
+//
+// it's read-mostly: lookups are lock-free and may run concurrently with a single writer,
+// while all modifications must be serialized by the owner
+//
+// it's an open-addressing table with linear probing whose slots are atomic pointers,
+// so a type info is published with a single store after it has been fully built
+// a lookup which runs concurrently with a modification may miss an existing type info
+// but never returns a wrong one, so a miss must be confirmed under the writers' lock
+//
+// when the table grows the old one is kept alive, since lookups may still be reading it
+// old tables are freed by erase, which must not run concurrently with lookups
+class DYNAMIX_API object_type_info_map
+{
+public:
+    object_type_info_map();
+    ~object_type_info_map();
+
+    object_type_info_map(const object_type_info_map&) = delete;
+    object_type_info_map& operator=(const object_type_info_map&) = delete;
+
+    // lock-free
+    // returns nullptr if no type info with these mixins is found
+    const object_type_info* find(const mixin_set& mixins) const;
+
+    // the following functions must be serialized by the owner
+
+    // takes ownership of the type info
+    // there must be no type info with the same mixins in the map
+    void insert(std::unique_ptr<object_type_info> info);
+
+    // removes and destroys all type infos for which pred returns true
+    // must not run concurrently with lookups
+    template <typename Pred>
+    void erase_if(Pred pred)
+    {
+        std::vector<const object_type_info*> erased;
+        for_each([&](const object_type_info& info)
+        {
+            if (pred(info)) erased.push_back(&info);
+        });
+
+        for (auto info : erased)
+        {
+            erase(info);
+        }
+
+        _retired_tables.clear();
+    }
+
+    // removes a type info without destroying it
+    // unlike erase_if it can run concurrently with lookups, which may still find the type info
+    // the caller becomes its owner and must keep it alive while lookups can be reading it
+    void unlink(const object_type_info* info);
+
+    template <typename Func>
+    void for_each(Func func) const
+    {
+        const table* t = _table.load(std::memory_order_relaxed);
+        for (size_t i = 0; i <= t->mask; ++i)
+        {
+            const object_type_info* info = t->slots[i].load(std::memory_order_relaxed);
+            if (info) func(*info);
+        }
+    }
+
+    size_t size() const { return _size; }
+
+private:
+    struct table
+    {
+        explicit table(size_t capacity);
+
+        size_t mask; // capacity - 1
+        std::unique_ptr<std::atomic<const object_type_info*>[]> slots;
+    };
+
+    void erase(const object_type_info* info);
+
+    // adds a type info to a table without checking the load
+    static void add(table& t, const object_type_info* info);
+
+    std::atomic<table*> _table;
+    std::unique_ptr<table> _current_table; // owns _table
+    std::vector<std::unique_ptr<table>> _retired_tables;
+    size_t _size = 0;
+};
+
+} // namespace internal
+} // namespace dynamix
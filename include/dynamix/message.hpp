@@ -71,6 +71,12 @@ struct DYNAMIX_API message_for_mixin
     // message perks
     int bid;
     int priority;
+
+    // optional caller which calls the message for many mixins at once
+    // it takes an array of mixin pointers, their number and the message arguments
+    // (see batch in message_features.hpp)
+    // used by bulk calls for consecutive objects of the same type
+    func_ptr batch_caller;
 };
 
 // check if a class has a method set_num_results
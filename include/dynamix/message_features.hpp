@@ -30,6 +30,13 @@ struct message_perks_and_caller : public message_perks<Message>
     func_ptr caller = nullptr;
 };
 
+// used for batch callers
+template <typename Message>
+struct message_perks_and_batch_caller : public message_perks<Message>
+{
+    func_ptr batch_caller = nullptr;
+};
+
 } // namespace internal
 
 // Used in the mixin's feature list to set perks to messages
@@ -58,6 +65,19 @@ internal::message_perks_and_caller<Message> bind(Message*, typename Message::cal
     return mp;
 }
 
+// bind a batch function to the message in addition to the mixin's method
+// the function takes an array of `void*` mixins, their number and the message arguments
+// bulk calls (call_all, parallel_call) will call it once for many consecutive objects
+// of the same type instead of calling the method for each of them
+// single calls and combinator calls still use the method
+template <typename Message>
+internal::message_perks_and_batch_caller<Message> batch(Message*, typename Message::batch_caller_func batch_caller)
+{
+    internal::message_perks_and_batch_caller<Message> mp;
+    mp.batch_caller = reinterpret_cast<internal::func_ptr>(batch_caller);
+    return mp;
+}
+
 // if we ever want type safety to the bound functions we need to use this implementation:
 //
 // template <typename Message, typename Caller>
@@ -0,0 +1,82 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+/**
+ * \file
+ * A handle for calling a unicast message with a cache of the last resolved call.
+ */
+
+#include "config.hpp"
+#include "object.hpp"
+#include "internal/message_callers.hpp"
+
+#include <utility>
+
+namespace dynamix
+{
+
+/**
+ * A handle for calling a unicast message.
+ *
+ * The handle remembers the type of the last object it was called for, along with
+ * the mixin and the function which implement the message for that type. Calling
+ * it for an object of the same type skips the lookup in the type's call table.
+ * On a type miss the call goes through the call table and the cache is updated.
+ *
+ * The cache is invalidated when type infos are destroyed (by
+ * a garbage collection of type infos or the unloading of a plugin)
+ *
+ * The handle is not thread safe. Use a separate instance for each thread.
+ *
+ * \par Example:
+ * \code
+ * message_handle<dynamix_msg_update> update_handle(update_msg);
+ * for (auto& obj : objects)
+ * {
+ *     update_handle(obj, dt);
+ * }
+ * \endcode
+ */
+template <typename Message>
+class message_handle
+{
+public:
+    message_handle() = default;
+    explicit message_handle(Message*) {}
+
+    /// Calls the message for an object
+    template <typename Object, typename... Args>
+    auto operator()(Object& obj, Args&&... args)
+        -> decltype(Message::make_cached_call(std::declval<internal::unicast_call_cache&>(), obj, std::forward<Args>(args)...))
+    {
+        return Message::make_cached_call(_cache, obj, std::forward<Args>(args)...);
+    }
+
+    /// Calls the message for an object
+    template <typename Object, typename... Args>
+    auto operator()(Object* obj, Args&&... args)
+        -> decltype(Message::make_cached_call(std::declval<internal::unicast_call_cache&>(), *obj, std::forward<Args>(args)...))
+    {
+        return Message::make_cached_call(_cache, *obj, std::forward<Args>(args)...);
+    }
+
+    /// Number of calls which used the cached type
+    size_t num_hits() const { return _cache.num_hits; }
+
+    /// Number of calls which had to look up the call table
+    size_t num_misses() const { return _cache.num_misses; }
+
+    /// Forgets the cached type and resets the counters
+    void reset() { _cache = internal::unicast_call_cache(); }
+
+private:
+    internal::unicast_call_cache _cache;
+};
+
+} // namespace dynamix
@@ -0,0 +1,229 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+/**
+ * \file
+ * A sequence of messages which is called for objects as a whole.
+ */
+
+#include "config.hpp"
+#include "object.hpp"
+#include "internal/message_callers.hpp"
+
+#include <iterator>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace dynamix
+{
+
+/**
+ * A sequence of messages with the same arguments which are called one after the other.
+ *
+ * For each object type the pipeline is compiled to a flat list of the functions and mixins
+ * which implement its messages: the top bidder of unicast messages and all top bidders of
+ * multicast messages, in the order of the sequence. Thus calling it for an object costs a
+ * single type lookup and a linear sweep through the list.
+ *
+ * The compiled lists are cached per type info. The cache is invalidated when type infos are
+ * destroyed (by a garbage collection of type infos or the unloading of a plugin)
+ *
+ * All messages must return `void` and take the argument types of the pipeline. Since the
+ * arguments are used for multiple calls, rvalue reference arguments are not supported.
+ * If a unicast message (or a multicast one, unless `DYNAMIX_NO_BAD_MULTICASTS` is defined)
+ * is not implemented for an object, `bad_message_call` is thrown before any of the
+ * messages is called.
+ *
+ * The pipeline is not thread safe. Use a separate instance for each thread.
+ *
+ * \par Example:
+ * \code
+ * message_pipeline<float> update(pre_update_msg, update_msg, post_update_msg);
+ * for (auto& obj : objects)
+ * {
+ *     update(obj, dt);
+ * }
+ * // or
+ * update.call_all(objects, dt);
+ * \endcode
+ */
+template <typename... Args>
+class message_pipeline
+{
+public:
+    template <typename... Messages>
+    explicit message_pipeline(Messages*... messages)
+    {
+        add_messages(messages...);
+    }
+
+    /// Calls the messages for an object
+    void operator()(object& obj, const Args&... args)
+    {
+        call(obj, get_compiled(obj._type_info), args...);
+    }
+
+    /// Calls the messages for an object
+    void operator()(object* obj, const Args&... args)
+    {
+        operator()(*obj, args...);
+    }
+
+    /// Calls the messages for all objects in the range `[begin; end)`.
+    /// The range can be of objects or of pointers to objects.
+    /// The compiled list is only looked up when the type changes between consecutive objects.
+    template <typename ObjectIterator>
+    void call_all(ObjectIterator begin, ObjectIterator end, const Args&... args)
+    {
+        const object_type_info* run_type = nullptr;
+        const compiled_pipeline* compiled = nullptr;
+
+        for (auto iter = begin; iter != end; ++iter)
+        {
+            object& obj = internal::bulk_call_object(*iter);
+
+            if (obj._type_info != run_type)
+            {
+                run_type = obj._type_info;
+                compiled = &get_compiled(run_type);
+            }
+
+            call(obj, *compiled, args...);
+        }
+    }
+
+    /// Calls the messages for all objects in a container.
+    /// Same as `call_all(begin(objects), end(objects), args...)`
+    template <typename Container>
+    auto call_all(Container& objects, const Args&... args)
+        -> decltype(std::begin(objects), void())
+    {
+        call_all(std::begin(objects), std::end(objects), args...);
+    }
+
+    /// Number of messages in the pipeline
+    size_t num_messages() const { return _messages.size(); }
+
+    /// Number of types for which the pipeline is currently compiled
+    size_t num_compiled_types() const { return _compiled.size(); }
+
+    /// Forgets all compiled lists
+    void reset()
+    {
+        _compiled.clear();
+        for (auto& r : _recent) r = recent_type();
+        _next_recent = 0;
+    }
+
+private:
+    using caller_func = typename internal::msg_caller<void, Args...>::caller_func;
+    using compiled_pipeline = std::vector<object_type_info::call_table_message>;
+
+    template <typename Message, typename... Messages>
+    void add_messages(Message*, Messages*... messages)
+    {
+        static_assert(std::is_same<typename Message::caller_func, caller_func>::value,
+            "all messages in a pipeline must return void and have the arguments of the pipeline");
+
+        const ::dynamix::feature& f = _dynamix_get_mixin_feature_safe(static_cast<Message*>(nullptr));
+        _messages.push_back(&static_cast<const internal::message_t&>(f));
+
+        add_messages(messages...);
+    }
+
+    void add_messages() {}
+
+    static void call(object& obj, const compiled_pipeline& compiled, const Args&... args)
+    {
+        for (auto& msg : compiled)
+        {
+            char* mixin_data = reinterpret_cast<char*>(const_cast<void*>(obj._mixin_data[msg.mixin_index].mixin()));
+
+            auto func = reinterpret_cast<caller_func>(msg.caller);
+
+            func(mixin_data, args...);
+        }
+    }
+
+    const compiled_pipeline& get_compiled(const object_type_info* type)
+    {
+        const size_t generation = internal::domain::type_info_generation();
+        if (generation != _type_info_generation)
+        {
+            // some type infos have been destroyed since the lists were compiled
+            // one of them might have had the address of a new one
+            reset();
+            _type_info_generation = generation;
+        }
+
+        for (auto& r : _recent)
+        {
+            if (r.type == type) return *r.compiled;
+        }
+
+        auto found = _compiled.find(type);
+        if (found == _compiled.end())
+        {
+            // compile before adding it, so that nothing is cached if it throws
+            compiled_pipeline compiled;
+            compile(type, compiled);
+            found = _compiled.emplace(type, std::move(compiled)).first;
+        }
+
+        recent_type& r = _recent[_next_recent];
+        _next_recent = (_next_recent + 1) % num_recent_types;
+        r.type = type;
+        r.compiled = &found->second;
+        return found->second;
+    }
+
+    void compile(const object_type_info* type, compiled_pipeline& out) const
+    {
+        for (const internal::message_t* message : _messages)
+        {
+            // the id of a message which no mixin implements is invalid
+            const bool registered = message->id != INVALID_FEATURE_ID;
+
+            if (message->mechanism == internal::message_t::unicast)
+            {
+                DYNAMIX_MSG_THROW_UNLESS(registered && type->_call_table[message->id].top_bid_message, ::dynamix::bad_message_call);
+                out.push_back(type->_call_table[message->id].top_bid_message);
+            }
+            else
+            {
+                const object_type_info::call_table_message* begin = registered ? type->_call_table[message->id].begin : nullptr;
+                DYNAMIX_MULTICAST_MSG_THROW_UNLESS(begin, ::dynamix::bad_message_call);
+                if (begin)
+                {
+                    const object_type_info::call_table_message* end = type->_call_table[message->id].end;
+                    out.insert(out.end(), begin, end);
+                }
+            }
+        }
+    }
+
+    std::vector<const internal::message_t*> _messages;
+
+    std::unordered_map<const object_type_info*, compiled_pipeline> _compiled;
+    size_t _type_info_generation = internal::domain::type_info_generation();
+
+    // the lists for the types of the last few calls, searched before the map
+    // the nodes of the unordered map aren't moved on rehashing, so they stay valid
+    struct recent_type
+    {
+        const object_type_info* type = nullptr;
+        const compiled_pipeline* compiled = nullptr;
+    };
+    static constexpr size_t num_recent_types = 4;
+    recent_type _recent[num_recent_types];
+    size_t _next_recent = 0;
+};
+
+} // namespace dynamix
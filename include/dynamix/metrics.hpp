@@ -35,9 +35,11 @@ struct metric
         return *this;
     }
 
+    // release, so that when the object count of a type info drops to zero, the garbage collection
+    // which sees it also sees all uses of the type info by the objects
     metric& operator--()
     {
-        value.fetch_sub(1, std::memory_order_relaxed);
+        value.fetch_sub(1, std::memory_order_release);
         return *this;
     }
 
@@ -9,8 +9,8 @@
 
 #include "config.hpp"
 #include "mixin_type_info.hpp"
+#include "internal/mixin_set.hpp"
 
-#include <bitset>
 #include <vector>
 
 namespace dynamix
@@ -19,7 +19,6 @@ namespace dynamix
 namespace internal
 {
 using mixin_type_info_vector = std::vector<const mixin_type_info*>;
-using available_mixins_bitset = std::bitset<DYNAMIX_MAX_MIXINS>;
 } // namespace internal
 
 /// A mixin collection is a class that allows the user to
@@ -47,7 +46,7 @@ public:
         return has(info.id);
     }
     bool has(const mixin_type_info& info) const noexcept { return has(info.id); }
-    bool has(mixin_id id) const noexcept { return _mixins[id]; }
+    bool has(mixin_id id) const noexcept { return _mixins.has(id); }
 
     /// Adds a mixin type is to the collection
     template <typename Mixin>
@@ -76,7 +75,7 @@ public:
     bool empty() const { return _compact_mixins.empty(); }
 
     void rebuild_from_compact_mixins();
-    internal::available_mixins_bitset _mixins;
+    internal::mixin_set _mixins;
     internal::mixin_type_info_vector _compact_mixins;
 };
 
@@ -0,0 +1,70 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+/**
+ * \file
+ * A handle of a mixin name for fast by-name access to mixins.
+ */
+
+#include "config.hpp"
+#include "mixin_id.hpp"
+#include "mixin_type_info.hpp"
+#include "internal/name_index.hpp"
+
+namespace dynamix
+{
+
+/**
+ * A handle of an interned mixin name.
+ *
+ * The name is resolved once, when the handle is created. After that getting the id of
+ * the mixin with this name doesn't look it up and costs a single load. The handle follows the
+ * registration of the mixin: if a mixin with this name is registered after the handle has
+ * been created, or a plugin which registers it is reloaded, the handle gets its new id.
+ *
+ * Handles of the same name refer to the same interned name, so they can be compared cheaply.
+ *
+ * Creating a handle for a name which has never been registered adds it to the names of the
+ * domain. As with registering a mixin, this must not happen concurrently with other uses of
+ * the domain.
+ *
+ * \par Example:
+ * \code
+ * static const mixin_name_handle transform("transform");
+ * if (obj.has(transform)) ...
+ * \endcode
+ */
+class DYNAMIX_API mixin_name_handle
+{
+public:
+    /// Creates a null handle which refers to no mixin
+    mixin_name_handle() = default;
+
+    /// Creates a handle of a mixin name
+    explicit mixin_name_handle(const char* name);
+
+    /// The interned name or nullptr for a null handle
+    const char* name() const { return _entry ? _entry->first : nullptr; }
+
+    /// The id of the mixin with this name or `INVALID_MIXIN_ID` if none is registered
+    mixin_id id() const { return _entry ? mixin_id(_entry->second) : INVALID_MIXIN_ID; }
+
+    /// Checks if a mixin with this name is registered
+    bool is_registered() const { return id() != INVALID_MIXIN_ID; }
+
+    bool operator==(const mixin_name_handle& other) const { return _entry == other._entry; }
+    bool operator!=(const mixin_name_handle& other) const { return _entry != other._entry; }
+
+private:
+    static_assert(internal::name_index::npos == INVALID_MIXIN_ID, "the id of an unregistered name must be invalid");
+
+    const internal::name_index::entry* _entry = nullptr;
+};
+
+} // namespace dynamix
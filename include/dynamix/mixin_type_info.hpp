@@ -90,6 +90,9 @@ public:
     /// All the message infos for the messages this mixin supports
     std::vector<internal::message_for_mixin> message_infos;
 
+    /// True if some of the message infos have a batch caller
+    bool has_batch_messages = false;
+
     /// User data associated with this type info
     uintptr_t user_data = 0;
 
@@ -23,6 +23,11 @@ namespace dynamix
 class object_type_mutation;
 class mixin_collection;
 
+namespace internal
+{
+class mutation_rule_compiler;
+}
+
 /// Base class for all mutation rules
 class DYNAMIX_API mutation_rule
 {
@@ -30,7 +35,17 @@ public:
     virtual ~mutation_rule() {}
 
     /// Called when applying the mutation rule.
+    /// The result must depend only on the mutation and the source mixins, since the
+    /// resulting types of mutations of single objects are cached per source type
+    /// until a mutation rule is added or removed.
     virtual void apply_to(object_type_mutation& mutation, const mixin_collection& source) = 0;
+
+    /// \internal
+    /// Called when the mutation rules of a domain change.
+    /// The built-in rules describe themselves to the compiler and return true. Then they're
+    /// applied together with the other built-in rules instead of with `apply_to`.
+    /// Custom rules return false and are applied by calling `apply_to`.
+    virtual bool compile_to(internal::mutation_rule_compiler&) const { return false; }
 };
 
 // the following functions are defined in domain.cpp
@@ -31,69 +31,30 @@ auto call_next_bidder(Mixin* mixin, Message* message, Args&&... args)
     const uint32_t mixin_index = obj->_type_info->_mixin_indices[mixin_info.id];
 
     DYNAMIX_MSG_THROW_UNLESS(entry.top_bid_message, bad_message_call);
+    DYNAMIX_THROW_UNLESS(entry.next_bidders, bad_next_bidder_call); // no next bidder calls
+    I_DYNAMIX_ASSERT(mixin_index >= object_type_info::MIXIN_INDEX_OFFSET);
 
-    if (msg.mechanism == internal::message_t::unicast)
-    {
-        // find function after the current one
-        auto ptr = entry.begin;
-        DYNAMIX_THROW_UNLESS(ptr, bad_next_bidder_call); // no next bidder calls
+    // the next bidders are precomputed by the type info
+    // for unicasts the range is a single message - the one with the next bid
+    // for multicasts it's all messages with the next bid
+    const object_type_info::next_bidder_range& next = entry.next_bidders[mixin_index - object_type_info::MIXIN_INDEX_OFFSET];
+    DYNAMIX_THROW_UNLESS(next.begin != next.end, bad_next_bidder_call);
 
-        // since this is called from a mixin this loop must end eventually
-        while (ptr++->mixin_index != mixin_index) I_DYNAMIX_ASSERT(ptr < entry.end);
-        DYNAMIX_THROW_UNLESS(ptr < entry.end, bad_next_bidder_call);
+    auto ptr = entry.begin + next.begin;
+    const auto last = entry.begin + next.end - 1;
 
-        // for unicasts the next message for mixin (pointed by ptr) must be the one
-        // we want to execute (with the next bid)
+    // execute all but the last
+    for (; ptr != last; ++ptr)
+    {
         auto data = reinterpret_cast<char*>(const_cast<void*>(obj->_mixin_data[ptr->mixin_index].mixin()));
         auto func = reinterpret_cast<typename Message::caller_func>(ptr->caller);
-        return func(data, std::forward<Args>(args)...);
+        func(data, std::forward<Args>(args)...);
     }
-    else
-    {
-        // find function after the current one
-        auto ptr = entry.begin;
-        // since this is called from a mixin this loop must end eventually
-        // no way to assert anything sensible here
-        while (ptr++->mixin_index != mixin_index);
-
-        // buffer ends here, so there are no next bidders
-        DYNAMIX_THROW_UNLESS(*ptr, bad_next_bidder_call);
-
-        // for multicasts this might be the message we're looking for or simply the next
-        // in the chain of priorities
-        // so check the previous one's bid and if it's the same search for the next one that's different
-        const object_type_info::call_table_message* prev_msg = ptr - 1;
-
-        // loop to the end of the bid chain
-        while (ptr->data->bid == prev_msg->data->bid) ++ptr;
-
-        I_DYNAMIX_ASSERT(ptr >= entry.end); // we must be past the end here
 
-        // after the end of the bid chain we could STILL have reached the end of the buffer
-        DYNAMIX_THROW_UNLESS(*ptr, bad_next_bidder_call);
-
-        auto bid = ptr->data->bid;
-
-        // execute the bid chain
-        for (;;)
-        {
-            auto data = reinterpret_cast<char*>(const_cast<void*>(obj->_mixin_data[ptr->mixin_index].mixin()));
-            auto func = reinterpret_cast<typename Message::caller_func>(ptr->caller);
-            ++ptr;
-            // check next message data
-            if (!(*ptr) || ptr->data->bid != bid)
-            {
-                // end of bid chain
-                // return last call
-                return func(data, std::forward<Args>(args)...);
-            }
-            else
-            {
-                // just execute function
-                func(data, std::forward<Args>(args)...);
-            }
-        }
-    }
+    // return the result of the last call
+    auto data = reinterpret_cast<char*>(const_cast<void*>(obj->_mixin_data[ptr->mixin_index].mixin()));
+    auto func = reinterpret_cast<typename Message::caller_func>(ptr->caller);
+    return func(data, std::forward<Args>(args)...);
 }
 
 template <typename Mixin, typename Message>
@@ -105,24 +66,11 @@ bool has_next_bidder(Mixin* mixin, Message* message)
     const object_type_info::call_table_entry& entry = obj->_type_info->_call_table[msg.id];
     const uint32_t mixin_index = obj->_type_info->_mixin_indices[mixin_info.id];
 
-    if (!entry.top_bid_message) return false;
+    if (!entry.next_bidders) return false;
+    I_DYNAMIX_ASSERT(mixin_index >= object_type_info::MIXIN_INDEX_OFFSET);
 
-    if (msg.mechanism == internal::message_t::unicast)
-    {
-        auto ptr = entry.begin;
-        if (!ptr) return false;
-        while (ptr++->mixin_index != mixin_index) I_DYNAMIX_ASSERT(ptr < entry.end);
-        return ptr < entry.end;
-    }
-    else
-    {
-        auto ptr = entry.begin;
-        while (ptr++->mixin_index != mixin_index);
-        if (!*ptr) return false;
-        const object_type_info::call_table_message* prev_msg = ptr - 1;
-        while (ptr->data->bid == prev_msg->data->bid) ++ptr;
-        return !!*ptr;
-    }
+    const object_type_info::next_bidder_range& next = entry.next_bidders[mixin_index - object_type_info::MIXIN_INDEX_OFFSET];
+    return next.begin != next.end;
 }
 
 } // namespace dynamix
@@ -10,6 +10,9 @@
 #include "config.hpp"
 #include "internal/assert.hpp"
 #include "mixin_type_info.hpp"
+#include "mixin_name_handle.hpp"
+
+#include <cstddef>
 
 namespace dynamix
 {
@@ -17,6 +20,7 @@ namespace dynamix
 namespace internal
 {
 class mixin_data_in_object;
+class domain;
 struct message_t;
 struct message_feature_tag;
 } // namespace internal
@@ -24,6 +28,7 @@ struct message_feature_tag;
 class object_type_info;
 class object_type_template;
 class object_allocator;
+class mixin_allocator;
 class type_class;
 
 /// The main object class.
@@ -36,8 +41,15 @@ public:
     /// Constructs an object with an object allocator
     explicit object(object_allocator* allocator);
     /// Constructs an object from a specific type template.
+    /// The object is bound to the domain of the template.
     explicit object(const object_type_template& type_template, object_allocator* allocator = nullptr);
 
+    /// Constructs an empty object which is bound to a domain.
+    /// The object's types are created in this domain, with its mutation rules, and the mixins
+    /// which don't have an allocator of their own are allocated with the domain's allocator.
+    /// The domain must outlive the object.
+    explicit object(internal::domain& dom, object_allocator* allocator = nullptr);
+
     ~object();
 
     /// Move constructor from an existing object
@@ -131,6 +143,10 @@ public:
     /// manual name provided by the `mixin_name` feature).
     bool has(const char* mixin_name) const noexcept;
 
+    /// Checks if the object has a specific mixin by a handle of its name.
+    /// Unlike the overload which takes a string, this doesn't look up the name.
+    bool has(const mixin_name_handle& mixin_name) const noexcept { return has(mixin_name.id()); }
+
     /// Gets a specific mixin by id from the object. Returns nullptr if the mixin
     /// isn't available. It is the user's responsibility to cast the returned
     /// value to the appropriate type.
@@ -156,6 +172,16 @@ public:
     /// The mixin name is the name of the actual mixin class or a
     /// manual name provided by the `mixin_name` feature.
     const void* get(const char* mixin_name) const noexcept;
+
+    /// Gets a specific mixin by a handle of its name from the object. Returns nullptr if
+    /// the mixin isn't available. Unlike the overload which takes a string, this doesn't
+    /// look up the name.
+    void* get(const mixin_name_handle& mixin_name) noexcept { return get(mixin_name.id()); }
+
+    /// Gets a specific mixin by a handle of its name from the object. Returns nullptr if
+    /// the mixin isn't available. Unlike the overload which takes a string, this doesn't
+    /// look up the name.
+    const void* get(const mixin_name_handle& mixin_name) const noexcept { return get(mixin_name.id()); }
     /////////////////////////////////////////////////////////////////
 
     /////////////////////////////////////////////////////////////////
@@ -205,8 +231,10 @@ public:
     /// Moves a mixin to the designated buffer, by invocating its move constructor.
     /// Throws an exception if the mixin is not movable.
     /// Returns the old mixin buffer and offset or {nullptr, 0} if the object doesn't have such mixin
+    /// If the mixin was in the object's block (see `domain_allocator::alloc_object_block`), the old buffer
+    /// is a part of the block and must not be deallocated.
     /// The library never calls this function internally. Unless the user calls it, an object's mixins will always
-    /// have the same addresses
+    /// have the same addresses (except for the ones in an object block)
     std::pair<char*, size_t> move_mixin(mixin_id id, char* buffer, size_t mixin_offset);
 
     /// Replaces a mixin's buffer with another. Returns the old buffer and offset.
@@ -229,6 +257,10 @@ public:
     /// Get the object's type info
     const object_type_info& type_info() const { return *_type_info; }
 
+    /// Get the domain to which the object is bound.
+    /// Objects which are moved or copied from other objects are bound to their domain.
+    internal::domain& bound_domain() const;
+
     // the following need to be public in order for the message macros to work
 _dynamix_internal:
     const object_type_info* _type_info;
@@ -238,6 +270,10 @@ _dynamix_internal:
     // thus each mixin can get its own object
     internal::mixin_data_in_object* _mixin_data;
 
+    // the domain to which the object is bound or null for the default domain
+    // its type info belongs to it
+    internal::domain* _domain = nullptr;
+
 private:
     void* internal_get_mixin(mixin_id id);
     const void* internal_get_mixin(mixin_id id) const;
@@ -270,11 +306,40 @@ private:
     // destroys mixin and deallocates memory
     void delete_mixin(const mixin_type_info& mixin_info);
 
+    // sets the buffer of a mixin: its place in the object block or memory from its allocator
+    // returns the allocator of the mixin
+    mixin_allocator* alloc_mixin_buffer(const mixin_type_info& mixin_info, internal::mixin_data_in_object& data);
+
+    // checks whether a mixin buffer is a part of the object block
+    bool in_object_block(const char* buffer) const;
+
+    // frees the mixin data of a type (and the block if it's a block)
+    void free_mixin_data(const object_type_info* type, internal::mixin_data_in_object* data, size_t block_size, bool in_inline_buffer);
+
     bool internal_implements(feature_id id, const internal::message_feature_tag&) const;
 
     // optional allocator for this object
     object_allocator* _allocator = nullptr;
 
+    // the size of the block which starts with _mixin_data and also contains the mixins that
+    // have a place in it within this size: an allocated object block (see domain_allocator::alloc_object_block)
+    // or the inline buffer
+    // zero if _mixin_data is an array without mixins
+    size_t _block_size = 0;
+
+#if DYNAMIX_OBJECT_INLINE_BUFFER_SIZE > 0
+    // the mixin data and the mixins which fit in it (see DYNAMIX_OBJECT_INLINE_BUFFER_SIZE)
+    alignas(std::max_align_t) char _inline_buffer[DYNAMIX_OBJECT_INLINE_BUFFER_SIZE];
+
+    // moves the contents of the inline buffer to a buffer of the same size
+    void move_inline_buffer(char* dest);
+#endif
+
+    bool uses_inline_buffer() const;
+
+    // the allocator of a mixin of this object
+    mixin_allocator* mixin_allocator_for(const mixin_type_info& mixin_info) const;
+
     // virtual mixin for default message implementation
     // used only so as to not have a null pointer cast to the appropriate type for default implementations
     // which could be treated as an error in some debuggers
@@ -22,16 +22,20 @@ namespace dynamix
 {
 
 class object;
+class mixin_name_handle;
 class object_type_info;
 
 namespace internal
 {
 
+class domain;
+
 class DYNAMIX_API object_mutator
 {
 public:
     object_mutator();
     object_mutator(const mixin_collection* source_mixins);
+    ~object_mutator();
 
     // non-copyable
     object_mutator(const object_mutator&) = delete;
@@ -60,6 +64,10 @@ public:
     bool add(const char* mixin_type_name);
     bool remove(const char* mixin_type_name);
 
+    // same as above, but without looking up the name
+    bool add(const mixin_name_handle& mixin_name);
+    bool remove(const mixin_name_handle& mixin_name);
+
     // add/remove mixin by mixin id
     // ann exception is thrown if a mixin with this id doesn't exist
     void add(mixin_id id);
@@ -73,14 +81,33 @@ public:
 
     const object_type_mutation& mutation() const { return _mutation; }
 
+    // the domain in which the target type is created
+    domain& bound_domain() const;
+
 protected:
     void apply_to(object& obj) const;
 
     object_type_mutation _mutation;
+
+    // the domain of the objects being mutated or null for the default domain
+    domain* _domain = nullptr;
+    void set_domain(domain& dom);
     const mixin_collection* _source_mixins = nullptr; // mixins the object being mutated
-    const object_type_info* _target_type_info = nullptr; // new type info of the object
+    const object_type_info* _target_type_info = nullptr; // new type info of the object (pinned unless it's null)
 
     bool _is_created = false;
+
+    // when set, the target type of the mutation is memoized as a transition of this type
+    // only for mutators whose mutation is not accessed after create, since on a cache hit
+    // the mutation rules are not applied to it
+    const object_type_info* _transition_source = nullptr;
+
+private:
+    // applies the mutation rules and finds the target type info
+    void create_target_type_info();
+
+    // unpins the target type info
+    void release_target_type_info();
 };
 
 } // namespace internal
@@ -17,10 +17,14 @@
 #include "mixin_collection.hpp"
 #include "message.hpp"
 #include "internal/assert.hpp"
+#include "internal/id_table.hpp"
+#include "internal/id_bitset.hpp"
 #include "type_class_id.hpp"
 
 #include <memory>
+#include <vector>
 #include <cstdint>
+#include <atomic>
 
 // object type info is an immutable class that represents the type information for a
 // group of objects
@@ -35,6 +39,7 @@ class object;
 namespace internal
 {
 class mixin_data_in_object;
+class domain;
 } // namespace internal
 
 class DYNAMIX_API object_type_info : private mixin_collection
@@ -43,7 +48,17 @@ public:
     object_type_info();
     ~object_type_info();
 
-    using mixin_collection::has;
+    /// Checks if a mixin type is present in the type
+    template <typename Mixin>
+    bool has() const noexcept
+    {
+        const mixin_type_info& info = _dynamix_get_mixin_type_info(static_cast<Mixin*>(nullptr));
+        return has(info.id);
+    }
+    bool has(const mixin_type_info& info) const noexcept { return has(info.id); }
+
+    // unlike the search in the mixin collection this is a single lookup
+    bool has(mixin_id id) const noexcept { return _mixin_indices[id] != NULL_MIXIN_DATA_INDEX; }
 
     const mixin_collection* as_mixin_collection() const { return this; }
 
@@ -51,9 +66,23 @@ public:
 
     static const object_type_info& null();
 
+    /// A dense id of the type info, unique among the living type infos of all domains.
+    /// The ids of destroyed type infos are reused, so the ids stay small and can index
+    /// arrays (see `type_indexed_table`). The null type info has the id 0.
+    uint32_t id() const { return _id; }
+
     internal::mixin_data_in_object* alloc_mixin_data(const object* obj) const;
     void dealloc_mixin_data(internal::mixin_data_in_object* data, const object* obj) const;
 
+    /// Allocates a block with the mixin data array and room for the mixins of an object of this type
+    /// (see `domain_allocator::alloc_object_block`).
+    /// Returns nullptr if the allocator of the object doesn't allocate blocks.
+    internal::mixin_data_in_object* alloc_object_block(const object* obj) const;
+    void dealloc_object_block(internal::mixin_data_in_object* data, const object* obj) const;
+
+    /// The size of the block allocated by `alloc_object_block`
+    size_t object_block_size() const { return _object_block_size; }
+
     /// Checks if the type implements a feature.
     template <typename Feature>
     bool implements(const Feature*) const noexcept
@@ -108,6 +137,10 @@ public:
     /// Adds the names of the type's mixins to the vector
     void get_mixin_names(std::vector<const char*>& out_mixin_names) const;
 
+    /// Returns the number of bytes the type info occupies in memory, including
+    /// its call table and other dynamically allocated data
+    size_t memory_footprint() const;
+
     /// Checks if the type belongs to a type class
     bool is_a(const type_class& tc) const;
 
@@ -122,8 +155,17 @@ _dynamix_internal:
     using mixin_collection::_mixins;
     using mixin_collection::_compact_mixins;
 
+#if DYNAMIX_COMPACT_TYPE_INFO
+    template <typename T>
+    using id_table = internal::paged_id_table<T, DYNAMIX_COMPACT_TYPE_INFO_PAGE_SIZE>;
+#else
+    template <typename T>
+    using id_table = internal::flat_id_table<T>;
+#endif
+
     // indices in the object::_mixin_data
-    uint32_t _mixin_indices[DYNAMIX_MAX_MIXINS];
+    // sized for the biggest id of the type's mixins
+    id_table<uint32_t> _mixin_indices;
 
     // special indices in an object's _mixin_data member
     enum reserved_mixin_indices : uint32_t
@@ -141,23 +183,34 @@ _dynamix_internal:
 
     // message data for the call table which consists of tighly packed elements
     // for faster acciess
+    // only what's needed to make the call is here (16 bytes on 64-bit platforms)
+    // the message_for_mixin data (bid, priority) is kept in a parallel cold buffer
     struct call_table_message
     {
-        uint32_t mixin_index; // index of mixin within the _compact_mixins vector
         internal::func_ptr caller;
-        const internal::message_for_mixin* data;
+        uint32_t mixin_index; // index of mixin within the _compact_mixins vector
 
         explicit operator bool() const { return !!caller; }
         void reset()
         {
-            mixin_index = ~0u;
             caller = nullptr;
-            data = nullptr;
+            mixin_index = ~0u;
         }
     };
 
     call_table_message make_call_table_message(mixin_id id, const internal::message_for_mixin& data) const;
 
+    // the messages in a call table entry's buffer, which are to be called by
+    // DYNAMIX_CALL_NEXT_BIDDER (offsets from its begin)
+    // for unicasts it's a single message with the next bid
+    // for multicasts it's all messages with the next bid
+    // begin == end means there's no next bidder
+    struct next_bidder_range
+    {
+        uint32_t begin;
+        uint32_t end;
+    };
+
     struct call_table_entry
     {
         // used when building the buffer to hold the top-bid message for the top priority
@@ -171,25 +224,126 @@ _dynamix_internal:
         // for unicasts it will hold pointers to all top-prirority messages for each bid
         // or be nullptr if there are no bids except a single one. It's used for DYNAMIX_CALL_NEXT_BIDDER
         // for multicasts it will hold groups of message datas sorted by priority sorted by bid
-        // thus calling DYNAMIX_CALL_NEXT_BIDDER will result in a search in this array
-        // (being progressively slower for the deph of bidders we use)
         // WARNING: for multicasts end points to the top-bid end only
         // when multiple bids are involved the buffer will continue after end until a nullptr address is pointed
-        // also for multicasts it will be even slower depending on how many messages with the same bid exist
         // we pay this price to achieve the maximum performance for the straight-forward simple message call case
         call_table_message* begin;
         call_table_message* end;
+
+        // the next bidders of each mixin for DYNAMIX_CALL_NEXT_BIDDER
+        // indexed by the mixin index (minus MIXIN_INDEX_OFFSET)
+        // nullptr if the message has no buffer (and thus no next bidders)
+        const next_bidder_range* next_bidders;
     };
 
     // a single buffer for all dynamically allocated message pointers to minimize allocations
     std::unique_ptr<call_table_message[]> _message_data_buffer;
-    call_table_entry _call_table[DYNAMIX_MAX_MESSAGES];
+    size_t _message_data_buffer_size = 0;
+
+    // the message_for_mixin data of each element of _message_data_buffer (at the same index)
+    // it's only used when building the call table
+    // (nullptr for the terminators of multicasts)
+    std::unique_ptr<const internal::message_for_mixin*[]> _message_data_cold_buffer;
+
+    // the message data of an element of _message_data_buffer
+    const internal::message_for_mixin* message_data(const call_table_message* msg) const
+    {
+        I_DYNAMIX_ASSERT(msg >= _message_data_buffer.get() && msg < _message_data_buffer.get() + _message_data_buffer_size);
+        return _message_data_cold_buffer[msg - _message_data_buffer.get()];
+    }
+
+    // the batch caller of a message for a mixin of this type (or nullptr if it doesn't have one)
+    // used by bulk calls when the type changes between consecutive objects
+    internal::func_ptr batch_caller(feature_id id, uint32_t mixin_index) const;
+
+    // a single buffer for the next bidder ranges of all call table entries which have a buffer
+    std::unique_ptr<next_bidder_range[]> _next_bidder_buffer;
+    size_t _next_bidder_buffer_size = 0;
+
+    // sized for the messages registered when the type was created
+    id_table<call_table_entry> _call_table;
+
+    // the layout of an object block (see domain_allocator::alloc_object_block)
+    // the block starts with the mixin data array which is followed by the mixin buffers,
+    // each with room for the owning object in front of the mixin
+    // the positions of the mixins in the block indexed by the mixin index (minus MIXIN_INDEX_OFFSET)
+    // zero for the mixins which are never in a block: the ones which can't be moved to a new block
+    // when the type of the object changes or need a greater alignment than that of the block
+    std::vector<uint32_t> _object_block_mixin_positions;
+    size_t _object_block_size = 0;
+
+    // called when the mixins of the type have been set
+    void compute_object_block_layout();
+
+    uint32_t object_block_mixin_position(uint32_t mixin_index) const
+    {
+        return _object_block_mixin_positions[mixin_index - MIXIN_INDEX_OFFSET];
+    }
 
     // number of living objects with this type info
     mutable metric num_objects = {size_t(0)};
 
+    // memoized results of mutations of objects of this type (like hidden class transitions)
+    // a transition maps a normalized mutation (the mixins it adds and removes) before the
+    // mutation rules are applied to the resulting type info (this if the mutation doesn't change the type)
+    // the entries are valid for the generation of the mutation rules they were created with
+    // lookups and additions are lock-free and the number of transitions per type is bounded
+    struct transition;
+    static constexpr size_t MAX_TRANSITIONS = 16;
+
+    // returns nullptr if there's no transition for this mutation
+    const object_type_info* find_transition(const internal::mixin_set& adding, const internal::mixin_set& removing, size_t rules_generation) const;
+
+    void add_transition(const internal::mixin_set& adding, const internal::mixin_set& removing, size_t rules_generation, const object_type_info* target) const;
+
+    // must not be called concurrently with mutations
+    // called when type infos, which may be transition targets, are destroyed
+    void clear_transitions() const;
+
+    // removes all transitions from the list and returns them
+    // unlike clear_transitions it can be called concurrently with mutations, but the returned
+    // transitions must be kept alive until no lookup can be reading them and then deleted with delete_transitions
+    const transition* detach_transitions() const;
+    static void delete_transitions(const transition* t);
+
+    // pins keep type infos with no objects from being destroyed by the automatic garbage collection
+    // mutators pin their target type infos until they are destroyed (see domain::collect_type_infos)
+    // pinning fails if the type info is being collected, in which case it must not be used
+    bool try_pin() const;
+    void unpin() const;
+
+    // called by the collector with the domain's lock
+    // if the type info has no objects and no pins, it's marked as collected and can't be pinned anymore
+    bool try_mark_collected() const;
+
+    // the number of pins or COLLECTED_PINS if the type info has been marked as collected
+    mutable std::atomic<size_t> _num_pins;
+    static constexpr size_t COLLECTED_PINS = ~size_t(0);
+
+    // the value of domain's type use clock when the type info was last pinned
+    // the garbage collection keeps the most recently used type infos without objects
+    mutable std::atomic<size_t> _last_use;
+
+    // the domain which owns the type info
+    // null for the null type info, which is shared by all domains
+    internal::domain* _domain = nullptr;
+
+    // given when the type info is added to its domain and released when it's destroyed
+    // zero for the null type info and for type infos which aren't in a domain
+    uint32_t _id = 0;
+
+    // the memory footprint of the type info when it was added to the domain
+    // used for the domain's memory budget for type infos
+    size_t _footprint_in_domain = 0;
+
+    // a push-only list
+    mutable std::atomic<const transition*> _transitions;
+    mutable std::atomic<size_t> _num_transitions;
+
     // this should be called after the mixins have been initialized
-    void fill_call_table();
+    // if a source type is provided, the entries of the messages which are implemented
+    // by the same mixins in both types are copied from it instead of being sorted and checked anew
+    void fill_call_table(const object_type_info* source = nullptr);
 
     bool internal_implements(feature_id id, const internal::message_feature_tag&) const
     {
@@ -212,9 +366,9 @@ _dynamix_internal:
 
     size_t message_num_implementers(feature_id id) const;
 
-    // contains all registered type class ids which were match this type info
-    // thus if a type class is registerd it will be faster to check whether it matches an info
-    std::vector<type_class_id> _matching_type_classes;
+    // the ids of all registered type classes which match this type info
+    // thus checking whether a registered type class matches an info is a single bit test
+    internal::id_bitset _matching_type_classes;
 };
 
 } // namespace dynamix
@@ -16,6 +16,7 @@ namespace dynamix
 namespace internal
 {
     class object_mutator;
+    class compiled_mutation_rules;
 }
 
 /// This class represents an object mutation.
@@ -136,6 +137,7 @@ public:
 
 private:
     friend class internal::object_mutator;
+    friend class internal::compiled_mutation_rules;
 
     mixin_collection _adding;
     mixin_collection _removing;
@@ -23,12 +23,18 @@ class DYNAMIX_API object_type_template : private internal::object_mutator
 public:
     object_type_template();
 
+    /// A template of objects which are bound to a domain
+    /// The domain must outlive the template.
+    explicit object_type_template(internal::domain& dom);
+
     using internal::object_mutator::add;
     // does the actual creation of the type template
     using internal::object_mutator::create;
     using internal::object_mutator::mutation;
+    using internal::object_mutator::bound_domain;
 
     // hiding the parent function, not using it
+    // the object must be bound to the same domain
     void apply_to(object& o) const;
 };
 
@@ -0,0 +1,184 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+/**
+ * \file
+ * Functions which call a message for many objects on multiple threads.
+ */
+
+#include "config.hpp"
+#include "object.hpp"
+#include "bulk_call.hpp"
+#include "executor.hpp"
+#include "combinators.hpp"
+#include "internal/message_callers.hpp"
+#include "internal/preprocessor.hpp"
+
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dynamix
+{
+
+namespace internal
+{
+
+// objects in a range are split in chunks of at least this many objects
+// smaller chunks don't justify the overhead of running them as separate tasks
+static constexpr size_t parallel_call_min_chunk_size = 256;
+
+// splits a range of objects into chunks for a number of threads
+// there are several chunks per thread so that the threads which finish early can steal work
+// the chunk boundaries are moved to the nearby changes of object type where possible,
+// so that most chunks consist of whole runs of the same type
+// out_bounds will contain the chunk boundaries (one more than the number of chunks)
+template <typename ObjectIterator>
+void split_in_type_runs(ObjectIterator begin, ObjectIterator end, size_t concurrency, std::vector<ObjectIterator>& out_bounds)
+{
+    const size_t size = size_t(end - begin);
+    const size_t chunks_per_thread = 4;
+    size_t chunk_size = size / (concurrency * chunks_per_thread);
+    if (chunk_size < parallel_call_min_chunk_size)
+    {
+        chunk_size = parallel_call_min_chunk_size;
+    }
+
+    out_bounds.clear();
+    out_bounds.push_back(begin);
+
+    auto chunk_begin = begin;
+    while (size_t(end - chunk_begin) > chunk_size)
+    {
+        auto chunk_end = chunk_begin + chunk_size;
+
+        // look for a type change up to half a chunk ahead
+        const auto search_end = size_t(end - chunk_end) > chunk_size / 2 ? chunk_end + chunk_size / 2 : end;
+        auto type = bulk_call_object(*(chunk_end - 1))._type_info;
+        for (auto i = chunk_end; i != search_end; ++i)
+        {
+            if (bulk_call_object(*i)._type_info != type)
+            {
+                chunk_end = i;
+                break;
+            }
+        }
+
+        out_bounds.push_back(chunk_end);
+        chunk_begin = chunk_end;
+    }
+
+    if (chunk_begin != end)
+    {
+        out_bounds.push_back(end);
+    }
+}
+
+} // namespace internal
+
+/// Calls a message for all objects in the range `[begin; end)` on the threads of an executor.
+/// The range can be of objects or of pointers to objects and must be random access.
+///
+/// The range is split in chunks which are run as tasks of the executor. Where possible the
+/// chunks are aligned to runs of objects of the same type, so populations which are grouped by
+/// type benefit the most. Each chunk is processed as with `call_all`.
+///
+/// The objects must be distinct and no thread must mutate them during the call. The messages
+/// are called concurrently for different objects, so their implementations must not modify
+/// shared data without synchronization. The results of unicast messages are discarded.
+/// The arguments are shared by all threads.
+///
+/// If a call throws, the exception is rethrown after all tasks have completed. The objects in
+/// chunks after the bad object are not guaranteed to be processed.
+///
+/// \par Example:
+/// \code
+/// dynamix::work_stealing_executor executor;
+/// dynamix::parallel_call(executor, update_msg, objects, dt);
+/// \endcode
+template <typename Message, typename ObjectIterator, typename... Args>
+void parallel_call(executor& ex, Message* message, ObjectIterator begin, ObjectIterator end, Args&&... args)
+{
+    static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<ObjectIterator>::iterator_category>::value,
+        "parallel_call requires random access iterators");
+    I_DYNAMIX_MAYBE_UNUSED(message);
+
+    std::vector<ObjectIterator> bounds;
+    internal::split_in_type_runs(begin, end, ex.concurrency(), bounds);
+
+    if (bounds.size() < 2) return; // empty range
+
+    ex.run(bounds.size() - 1, [&](size_t i)
+    {
+        Message::make_bulk_call(bounds[i], bounds[i + 1], args...);
+    });
+}
+
+/// Calls a message for all objects in a container on the threads of an executor.
+/// Same as `parallel_call(ex, message, begin(objects), end(objects), args...)`
+template <typename Message, typename Container, typename... Args>
+auto parallel_call(executor& ex, Message* message, Container& objects, Args&&... args)
+-> decltype(std::begin(objects), void())
+{
+    parallel_call(ex, message, std::begin(objects), std::end(objects), std::forward<Args>(args)...);
+}
+
+/// Calls a multicast message for all objects in the range `[begin; end)` on the threads of
+/// an executor, adding the results of all of them to a combinator.
+/// The combinator must be a population combinator (see combinators.hpp).
+///
+/// The range is split in chunks as with `parallel_call`. The results of each chunk are
+/// added to a separate default-constructed combinator. After all chunks have been processed
+/// they are merged into the provided one in the order of the chunks, so the merge order does
+/// not depend on which thread processed which chunk. For arithmetic results of `sum` and `mean`
+/// the merge is a vectorizable reduction.
+///
+/// \par Example:
+/// \code
+/// dynamix::work_stealing_executor executor;
+/// dynamix::combinators::sum<int> total;
+/// dynamix::parallel_combine(executor, get_value_msg, objects, total);
+/// total.result(); // the sum for all objects
+/// \endcode
+template <typename Message, typename ObjectIterator, typename Combinator, typename... Args>
+void parallel_combine(executor& ex, Message* message, ObjectIterator begin, ObjectIterator end, Combinator& combinator, Args&&... args)
+{
+    static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<ObjectIterator>::iterator_category>::value,
+        "parallel_combine requires random access iterators");
+    I_DYNAMIX_MAYBE_UNUSED(message);
+
+    std::vector<ObjectIterator> bounds;
+    internal::split_in_type_runs(begin, end, ex.concurrency(), bounds);
+
+    if (bounds.size() < 2) return; // empty range
+
+    const size_t num_chunks = bounds.size() - 1;
+    std::unique_ptr<Combinator[]> partials(new Combinator[num_chunks]);
+
+    ex.run(num_chunks, [&](size_t i)
+    {
+        Message::make_combinator_bulk_call(bounds[i], bounds[i + 1], partials[i], args...);
+    });
+
+    internal::merge_combinators(combinator, partials.get(), num_chunks);
+}
+
+/// Calls a multicast message for all objects in a container on the threads of an executor,
+/// adding the results of all of them to a combinator.
+/// Same as `parallel_combine(ex, message, begin(objects), end(objects), combinator, args...)`
+template <typename Message, typename Container, typename Combinator, typename... Args>
+auto parallel_combine(executor& ex, Message* message, Container& objects, Combinator& combinator, Args&&... args)
+-> decltype(std::begin(objects), void())
+{
+    parallel_combine(ex, message, std::begin(objects), std::end(objects), combinator, std::forward<Args>(args)...);
+}
+
+} // namespace dynamix
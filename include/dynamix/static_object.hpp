@@ -0,0 +1,271 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+/**
+ * \file
+ * An object with a fixed set of mixins, which are stored within it.
+ */
+
+#include "config.hpp"
+#include "object.hpp"
+#include "object_type_info.hpp"
+#include "allocators.hpp"
+#include "domain.hpp"
+#include "internal/message_callers.hpp"
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+namespace dynamix
+{
+
+namespace internal
+{
+
+// checks whether a type is in a pack
+template <typename T, typename... Pack>
+struct pack_contains : std::false_type {};
+
+template <typename T, typename First, typename... Rest>
+struct pack_contains<T, First, Rest...>
+    : std::integral_constant<bool, std::is_same<T, First>::value || pack_contains<T, Rest...>::value> {};
+
+// the memory for a single mixin in a static object
+// as with mixin_allocator::mixin_offset there's room for the owning object in front of the mixin
+template <typename Mixin>
+struct static_mixin_slot
+{
+    static constexpr size_t mixin_offset = next_multiple(sizeof(object*), alignof(Mixin));
+    static constexpr size_t alignment = alignof(Mixin) > alignof(object*) ? alignof(Mixin) : alignof(object*);
+
+    alignas(alignment) char buffer[mixin_offset + sizeof(Mixin)];
+};
+
+// the memory for all mixins of a static object
+// the slot of a mixin can be obtained with a static_cast to static_mixin_slot<Mixin>
+template <typename... Mixins>
+struct static_mixin_storage : public static_mixin_slot<Mixins>... {};
+
+} // namespace internal
+
+/**
+ * An object with a fixed set of mixins.
+ *
+ * The mixins of a static object and their `mixin_data_in_object` array are stored within it,
+ * so creating one makes no allocations, and the mixin of a given type is found at an offset
+ * which is known at compile time.
+ *
+ * A static object has a regular object type info (the one with exactly these mixins; no
+ * mutation rules are applied) so it can be used with all functions which take an object,
+ * including the message functions generated by the message macros.
+ *
+ * The message calls made through `call` skip the call table. They are resolved once per
+ * static object type and thread, since all static objects with the same mixins share a
+ * type info.
+ *
+ * The mixin classes must be complete where the static object is used. The mixins are
+ * default constructed. Custom mixin allocators are not used for them.
+ *
+ * Static objects can't be copied or moved. They also must not be mutated. If the inner
+ * object is mutated, the mixins which don't fit in it are allocated as in regular objects,
+ * but the accessors of the static object will assert in debug builds.
+ *
+ * \par Example:
+ * \code
+ * static_object<transform, physics> obj;
+ * obj.get<transform>()->set_position(0, 0); // no lookup
+ * obj.call(update_msg, dt); // no call table lookup
+ * update(obj, dt); // a regular message call
+ * \endcode
+ */
+template <typename... Mixins>
+class static_object
+{
+public:
+    static_assert(sizeof...(Mixins) > 0, "static objects must have at least one mixin");
+
+    static_object()
+        : _allocator(*this)
+        , _object(&_allocator)
+    {
+        auto type = internal::domain::safe_instance().get_object_type_info(mixins());
+        _object.change_type(type);
+        type->unpin();
+    }
+
+    static_object(const static_object&) = delete;
+    static_object& operator=(const static_object&) = delete;
+
+    /// Checks if the static object has a given mixin
+    template <typename Mixin>
+    static constexpr bool has()
+    {
+        return internal::pack_contains<Mixin, Mixins...>::value;
+    }
+
+    /// Returns a given mixin of the static object.
+    /// Fails to compile if the mixin is not one of its mixins.
+    template <typename Mixin>
+    Mixin* get()
+    {
+        static_assert(has<Mixin>(), "the mixin is not a part of the static object");
+        Mixin* ret = reinterpret_cast<Mixin*>(slot<Mixin>().buffer + internal::static_mixin_slot<Mixin>::mixin_offset);
+        I_DYNAMIX_ASSERT_MSG(ret == _object.get<Mixin>(), "static objects must not be mutated");
+        return ret;
+    }
+
+    /// Returns a given mixin of the static object.
+    /// Fails to compile if the mixin is not one of its mixins.
+    template <typename Mixin>
+    const Mixin* get() const
+    {
+        return const_cast<static_object*>(this)->get<Mixin>();
+    }
+
+    /// Calls a unicast message for the static object.
+    /// The call is resolved for the static object type on the first call on each thread.
+    template <typename Message, typename... Args>
+    auto call(Message*, Args&&... args)
+        -> decltype(Message::make_cached_call(std::declval<internal::unicast_call_cache&>(), std::declval<object&>(), std::forward<Args>(args)...))
+    {
+        // constant-initialized (its default member initializers are constants), so no dynamic thread-local initialization is needed
+        static thread_local internal::unicast_call_cache cache;
+        return Message::make_cached_call(cache, _object, std::forward<Args>(args)...);
+    }
+
+    /// Calls a unicast message for the static object.
+    /// The call is resolved for the static object type on the first call on each thread.
+    template <typename Message, typename... Args>
+    auto call(Message*, Args&&... args) const
+        -> decltype(Message::make_cached_call(std::declval<internal::unicast_call_cache&>(), std::declval<const object&>(), std::forward<Args>(args)...))
+    {
+        static thread_local internal::unicast_call_cache cache;
+        return Message::make_cached_call(cache, _object, std::forward<Args>(args)...);
+    }
+
+    /// The object type info of all static objects with these mixins
+    const object_type_info& type_info() const { return _object.type_info(); }
+
+    /// The inner object
+    object& as_object() { return _object; }
+    const object& as_object() const { return _object; }
+
+    operator object&() { return _object; }
+    operator const object&() const { return _object; }
+
+    /// The mixins of the static object as a mixin collection
+    static mixin_collection mixins()
+    {
+        mixin_collection ret;
+        int expand[] = { (ret.add<Mixins>(), 0)... };
+        I_DYNAMIX_MAYBE_UNUSED(expand);
+        // as in mutations the mixins of a type are sorted, regardless of the order in which they're listed
+        std::sort(ret._compact_mixins.begin(), ret._compact_mixins.end());
+        return ret;
+    }
+
+private:
+    template <typename Mixin>
+    internal::static_mixin_slot<Mixin>& slot()
+    {
+        return static_cast<internal::static_mixin_slot<Mixin>&>(_storage);
+    }
+
+    static constexpr size_t num_mixins = sizeof...(Mixins);
+    static constexpr size_t num_mixin_datas = num_mixins + object_type_info::MIXIN_INDEX_OFFSET;
+
+    // hands out the memory of the static object to the inner object
+    // falls back to the regular allocators if the inner object has been mutated
+    class storage_allocator : public object_allocator
+    {
+    public:
+        explicit storage_allocator(static_object& owner) : _owner(owner) {}
+
+        virtual char* alloc_mixin_data(size_t count, const object* obj) override
+        {
+            if (_mixin_data_used || count > num_mixin_datas)
+            {
+                return internal::domain::instance().allocator()->alloc_mixin_data(count, obj);
+            }
+            _mixin_data_used = true;
+            return _owner._mixin_data_buffer;
+        }
+
+        virtual void dealloc_mixin_data(char* ptr, size_t count, const object* obj) override
+        {
+            if (ptr != _owner._mixin_data_buffer)
+            {
+                internal::domain::instance().allocator()->dealloc_mixin_data(ptr, count, obj);
+                return;
+            }
+            _mixin_data_used = false;
+        }
+
+        virtual std::pair<char*, size_t> alloc_mixin(const mixin_type_info& info, const object* obj) override
+        {
+            char* buffers[] = { _owner.template slot<Mixins>().buffer... };
+            const size_t offsets[] = { internal::static_mixin_slot<Mixins>::mixin_offset... };
+            const mixin_type_info* infos[] = { &_dynamix_get_mixin_type_info(static_cast<Mixins*>(nullptr))... };
+
+            for (size_t i = 0; i < num_mixins; ++i)
+            {
+                if (infos[i] == &info && !_slot_used[i])
+                {
+                    _slot_used[i] = true;
+                    return std::make_pair(buffers[i], offsets[i]);
+                }
+            }
+
+            return info.allocator->alloc_mixin(info, obj);
+        }
+
+        virtual void dealloc_mixin(char* ptr, size_t mixin_offset, const mixin_type_info& info, const object* obj) override
+        {
+            char* buffers[] = { _owner.template slot<Mixins>().buffer... };
+
+            for (size_t i = 0; i < num_mixins; ++i)
+            {
+                if (buffers[i] == ptr)
+                {
+                    _slot_used[i] = false;
+                    return;
+                }
+            }
+
+            info.allocator->dealloc_mixin(ptr, mixin_offset, info, obj);
+        }
+
+        virtual object_allocator* on_copy_construct(object&, const object&) override
+        {
+            // copies are regular objects
+            return nullptr;
+        }
+
+        virtual object_allocator* on_move(object&, object&) noexcept override
+        {
+            // the mixins of the moved object would still be within the static object
+            I_DYNAMIX_ASSERT_MSG(false, "static objects can't be moved");
+            return nullptr;
+        }
+
+    private:
+        static_object& _owner;
+        bool _mixin_data_used = false;
+        bool _slot_used[num_mixins] = {};
+    };
+
+    // the inner object must be destroyed first, so it's declared last
+    internal::static_mixin_storage<Mixins...> _storage;
+    alignas(internal::mixin_data_in_object) char _mixin_data_buffer[num_mixin_datas * sizeof(internal::mixin_data_in_object)];
+    storage_allocator _allocator;
+    object _object;
+};
+
+} // namespace dynamix
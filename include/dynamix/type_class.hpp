@@ -11,9 +11,12 @@
 
 #include "type_class_id.hpp"
 #include "mixin_id.hpp"
+#include "mixin_type_info.hpp"
 #include "feature.hpp"
+#include "internal/id_bitset.hpp"
 
 #include <vector>
+#include <initializer_list>
 
 namespace dynamix
 {
@@ -27,6 +30,72 @@ namespace internal
 class domain;
 }
 
+/// A declarative description of the object type infos which belong to a type class
+///
+/// It's compiled to bitset masks of mixin ids, so matching a type info is a few word-wide
+/// operations instead of a call to a function which checks each mixin.
+///
+/// \par Example:
+/// \code
+/// type_class_filter f;
+/// f.all_of<transform, mesh>().none_of<hidden>().implements(draw_msg);
+/// \endcode
+class DYNAMIX_API type_class_filter
+{
+public:
+    /// The type must have all of these mixins
+    template <typename... Mixins>
+    type_class_filter& all_of()
+    {
+        add_infos<Mixins...>(_all_of);
+        return *this;
+    }
+
+    /// The type must have at least one of these mixins
+    template <typename... Mixins>
+    type_class_filter& any_of()
+    {
+        add_infos<Mixins...>(_any_of);
+        return *this;
+    }
+
+    /// The type must have none of these mixins
+    template <typename... Mixins>
+    type_class_filter& none_of()
+    {
+        add_infos<Mixins...>(_none_of);
+        return *this;
+    }
+
+    /// The type must implement all of these messages
+    template <typename... Messages>
+    type_class_filter& implements(const Messages*... messages)
+    {
+        std::initializer_list<const feature*> features = { &_dynamix_get_mixin_feature_safe(messages)... };
+        _implements.insert(_implements.end(), features.begin(), features.end());
+        return *this;
+    }
+
+    type_class_filter& all_of(const mixin_type_info& info) { _all_of.push_back(&info); return *this; }
+    type_class_filter& any_of(const mixin_type_info& info) { _any_of.push_back(&info); return *this; }
+    type_class_filter& none_of(const mixin_type_info& info) { _none_of.push_back(&info); return *this; }
+
+private:
+    friend class type_class;
+
+    template <typename... Mixins>
+    static void add_infos(std::vector<const mixin_type_info*>& out)
+    {
+        std::initializer_list<const mixin_type_info*> infos = { &_dynamix_get_mixin_type_info(static_cast<Mixins*>(nullptr))... };
+        out.insert(out.end(), infos.begin(), infos.end());
+    }
+
+    std::vector<const mixin_type_info*> _all_of;
+    std::vector<const mixin_type_info*> _any_of;
+    std::vector<const mixin_type_info*> _none_of;
+    std::vector<const feature*> _implements;
+};
+
 /// A type class is a desciption of an object type info which may or may not match an existing one
 /// An object may belong to multiple type classes (or none)
 class DYNAMIX_API type_class
@@ -34,6 +103,10 @@ class DYNAMIX_API type_class
 public:
     typedef bool (*match_func)(const object_type_info&);
     type_class(match_func func, bool register_globally = false);
+
+    /// Creates a declarative type class
+    type_class(type_class_filter filter, bool register_globally = false);
+
     ~type_class();
 
     // do not copy or move
@@ -45,12 +118,30 @@ public:
     type_class_id id() const { return _id; }
     bool is_registered() const { return _id != INVALID_TYPE_CLASS_ID; }
 
-    bool matches(const object_type_info& ti) const { return _match_func(ti); }
+    bool matches(const object_type_info& ti) const;
 
 private:
     friend class internal::domain;
+
+    // the mixins of the type info are provided as a bitset, so that they can be tested against
+    // the masks of declarative type classes
+    bool matches(const object_type_info& ti, const internal::id_bitset& mixins) const;
+
+    // updates the masks of a declarative type class with the current ids of its mixins and messages
+    // called when it's registered and when mixins or messages are registered or unregistered,
+    // since it may be created before them
+    // local type classes aren't compiled and resolve their filter when they're matched
+    void compile();
+
     type_class_id _id = INVALID_TYPE_CLASS_ID;
-    match_func _match_func;
+    match_func _match_func = nullptr;
+
+    type_class_filter _filter;
+    internal::id_bitset _all_of;
+    internal::id_bitset _any_of;
+    internal::id_bitset _none_of;
+    std::vector<feature_id> _implements;
+    bool _never_matches = false; // when the filter requires mixins or messages which aren't registered
 };
 
 }
@@ -61,3 +152,7 @@ private:
     static bool _impl##tc(const dynamix::object_type_info&); \
     const dynamix::type_class tc::_dynamix_type_class(_impl##tc, true); \
     bool _impl##tc(const dynamix::object_type_info& type)
+
+// defines a declarative type class with a type_class_filter expression
+#define DYNAMIX_DEFINE_TYPE_CLASS_FILTER(tc, ...) \
+    const dynamix::type_class tc::_dynamix_type_class(dynamix::type_class_filter() __VA_ARGS__, true)
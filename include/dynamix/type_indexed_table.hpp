@@ -0,0 +1,158 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+/**
+ * \file
+ * A table with an element for each object type info, indexed by the ids of the type infos.
+ */
+
+#include "config.hpp"
+#include "object_type_info.hpp"
+#include "internal/assert.hpp"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace dynamix
+{
+
+namespace internal
+{
+class domain;
+
+/// \internal
+/// The part of the type indexed tables which the domain knows about
+class DYNAMIX_API type_indexed_table_base
+{
+public:
+    virtual ~type_indexed_table_base();
+
+protected:
+    // adds the table to the domain, which then resets a slot when a type info gets an id
+    // and when it's destroyed
+    // must be called by the constructor and destructor of the derived class,
+    // since the domain calls its virtual functions
+    void attach();
+    void detach();
+
+private:
+    friend class domain;
+
+    // called by the domain with the lock of the type ids
+    // makes sure that there are slots for all ids below num_ids
+    virtual void reserve_slots(size_t num_ids) = 0;
+
+    // called by the domain with the lock of the type ids
+    // replaces the slot of an id with a default-constructed element
+    virtual void reset_slot(uint32_t id) = 0;
+};
+} // namespace internal
+
+/**
+ * A table with an element for each object type info of all domains.
+ *
+ * The element of a type info is accessed by its dense id (see `object_type_info::id`)
+ * which is a single array lookup, unlike the lookup of a hash map by type.
+ *
+ * The element of a type info is default-constructed when the type info is created and is
+ * replaced with a default-constructed one when the type info is destroyed, so the elements
+ * don't carry over when the ids of destroyed type infos are reused.
+ *
+ * Accessing the element of an existing type info is lock-free and can happen concurrently with
+ * the creation and destruction of other type infos. Accessing the same element concurrently
+ * must be synchronized by the user.
+ *
+ * \tparam T The type of the elements. It must be default-constructible and move-assignable.
+ * \tparam PageSize The number of elements which are allocated at once.
+ *
+ * \par Example:
+ * \code
+ * static type_indexed_table<serialization_plan> plans;
+ * auto& plan = plans[obj.type_info()];
+ * \endcode
+ */
+template <typename T, size_t PageSize = 64>
+class type_indexed_table : private internal::type_indexed_table_base
+{
+    static_assert((PageSize & (PageSize - 1)) == 0, "page size must be a power of two");
+public:
+    type_indexed_table()
+        : _directory(nullptr)
+    {
+        attach();
+    }
+
+    ~type_indexed_table()
+    {
+        detach();
+    }
+
+    type_indexed_table(const type_indexed_table&) = delete;
+    type_indexed_table& operator=(const type_indexed_table&) = delete;
+
+    T& operator[](const object_type_info& info) { return slot(info.id()); }
+    const T& operator[](const object_type_info& info) const { return slot(info.id()); }
+
+private:
+    // an array of pointers to the pages
+    // growing the table replaces the directory, but never moves the pages
+    struct directory
+    {
+        explicit directory(size_t n)
+            : num_pages(n)
+            , pages(new T*[n])
+        {}
+
+        const size_t num_pages;
+        std::unique_ptr<T*[]> pages;
+    };
+
+    T& slot(uint32_t id) const
+    {
+        const directory* dir = _directory.load(std::memory_order_acquire);
+        I_DYNAMIX_ASSERT(dir && id / PageSize < dir->num_pages);
+        return dir->pages[id / PageSize][id % PageSize];
+    }
+
+    virtual void reserve_slots(size_t num_ids) override
+    {
+        const size_t num_pages = (num_ids + PageSize - 1) / PageSize;
+        const size_t cur_num_pages = _pages.size();
+        if (num_pages <= cur_num_pages) return;
+
+        std::unique_ptr<directory> dir(new directory(num_pages));
+        for (size_t i = 0; i < num_pages; ++i)
+        {
+            if (i >= cur_num_pages)
+            {
+                _pages.emplace_back(new T[PageSize]());
+            }
+            dir->pages[i] = _pages[i].get();
+        }
+
+        // the previous directories are kept, since they may be read concurrently
+        _directory.store(dir.get(), std::memory_order_release);
+        _directories.emplace_back(std::move(dir));
+    }
+
+    virtual void reset_slot(uint32_t id) override
+    {
+        reserve_slots(size_t(id) + 1);
+        slot(id) = T();
+    }
+
+    std::atomic<const directory*> _directory;
+    std::vector<std::unique_ptr<directory>> _directories;
+    std::vector<std::unique_ptr<T[]>> _pages;
+};
+
+} // namespace dynamix
@@ -0,0 +1,88 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+/**
+ * \file
+ * Automatic garbage collection of object type infos.
+ */
+
+#include "config.hpp"
+
+#include <cstddef>
+
+namespace dynamix
+{
+
+/**
+ * The policy of the automatic garbage collection of object type infos.
+ *
+ * Object type infos which have no objects are kept by the domain, so that they can be reused
+ * when objects of their type are created again. A program which creates many different types
+ * can use the automatic collection to keep their number or their memory bounded.
+ *
+ * When the limits are exceeded, a collection is made after a new type info is created.
+ * Each collection destroys a bounded number of the least recently used type infos which have
+ * no objects. It's safe to run it concurrently with mutations.
+ *
+ * Type infos which are the targets of living mutators or type templates are never collected.
+ */
+struct type_info_gc_policy
+{
+    /// Collect when the domain has more type infos than this. Zero means no limit.
+    size_t max_type_infos = 0;
+
+    /// Collect when the type infos occupy more bytes than this. Zero means no limit.
+    size_t max_type_infos_size = 0;
+
+    /// The number of most recently used type infos without objects which are never collected.
+    size_t num_retained_unused = 0;
+
+    /// The maximum number of type infos collected by a single collection.
+    size_t max_collected_per_pass = 64;
+
+    /// The minimum number of type infos created between two automatic collections.
+    /// Prevents collections after each new type info when the limits can't be met because
+    /// most type infos have objects.
+    size_t collection_interval = 16;
+};
+
+/// Statistics of the garbage collection of object type infos
+struct type_info_gc_stats
+{
+    /// Number of type infos in the domain
+    size_t num_type_infos = 0;
+
+    /// Memory footprint of the type infos in the domain in bytes
+    size_t type_infos_size = 0;
+
+    /// Number of collections made
+    size_t num_collections = 0;
+
+    /// Number of type infos collected
+    size_t num_collected = 0;
+
+    /// Memory footprint of the collected type infos in bytes
+    size_t collected_size = 0;
+
+    /// Number of collected type infos which are not destroyed yet because concurrent
+    /// mutations might be reading them. They are destroyed by subsequent collections.
+    size_t num_pending = 0;
+};
+
+/// Sets the policy of the automatic garbage collection of type infos.
+void DYNAMIX_API set_type_info_gc_policy(const type_info_gc_policy& policy);
+
+/// Returns the statistics of the garbage collection of type infos.
+type_info_gc_stats DYNAMIX_API get_type_info_gc_stats();
+
+/// Makes a single collection of type infos, regardless of the limits of the policy.
+/// Unlike `garbage_collect_type_infos` it can be called concurrently with mutations.
+void DYNAMIX_API collect_type_infos();
+
+} // namespace dynamix
@@ -0,0 +1,74 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+/**
+ * \file
+ * Functions which save the object types of the domain and create them again.
+ */
+
+#include "config.hpp"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace dynamix
+{
+
+class executor;
+
+/**
+ * A type manifest is a binary list of object types, each of which is a list of mixin names.
+ *
+ * Saving the manifest of a program and loading it on its next start will create the object
+ * types up front, instead of on the first mutations which need them.
+ *
+ * The manifest doesn't depend on the mixin ids, so it can be loaded by a program whose mixins
+ * are registered in a different order.
+ */
+
+/// The result of loading a type manifest
+struct type_manifest_load_result
+{
+    /// False if the data couldn't be read or is not a valid manifest.
+    /// In this case no types have been created.
+    bool valid = false;
+
+    /// Number of types in the manifest
+    size_t num_types = 0;
+
+    /// Number of types which couldn't be created because some of their mixins aren't registered
+    size_t num_skipped_types = 0;
+
+    /// The names from the manifest of the mixins which aren't registered
+    std::vector<std::string> unresolved_mixin_names;
+};
+
+/// Writes the manifest of all object types in the domain.
+/// Returns false if the data couldn't be written.
+/// Must not be called concurrently with `garbage_collect_type_infos` or mixin unregistration.
+bool DYNAMIX_API save_type_manifest(std::ostream& out);
+
+/// Writes the manifest of all object types in the domain to a file.
+bool DYNAMIX_API save_type_manifest(const char* path);
+
+/// Creates the object types from a manifest.
+///
+/// The types with fewer mixins are created first, so that the ones with more can be derived
+/// from them. If an executor is provided, the types with the same number of mixins are
+/// created in parallel (only if `DYNAMIX_THREAD_SAFE_MUTATIONS` is true).
+///
+/// Types which are created this way have no objects, so they will be erased by
+/// `garbage_collect_type_infos` if it's called before they are used.
+type_manifest_load_result DYNAMIX_API load_type_manifest(std::istream& in, executor* exec = nullptr);
+
+/// Creates the object types from a manifest file.
+type_manifest_load_result DYNAMIX_API load_type_manifest(const char* path, executor* exec = nullptr);
+
+} // namespace dynamix
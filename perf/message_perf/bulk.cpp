@@ -0,0 +1,139 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+
+// compare calling a message for each object in a loop
+// with calling it for all objects at once
+//
+// make sure link time optimizations are turned of
+// gcc with no -flto
+// msvc with no link time code generation
+#include "perf.hpp"
+#include "picobench.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace
+{
+vector<dynamix::object> make_objects(int n, bool multi, bool group_by_type)
+{
+    vector<dynamix::object> data;
+    data.reserve(n);
+    for (int i = 0; i < n; ++i)
+    {
+        data.emplace_back(multi ? new_multi_object(rand()) : new_object(rand()));
+    }
+
+    if (group_by_type)
+    {
+        stable_sort(data.begin(), data.end(), [](const dynamix::object& a, const dynamix::object& b) {
+            return a._type_info < b._type_info;
+        });
+    }
+
+    return data;
+}
+
+unsigned total_sum(const vector<dynamix::object>& data)
+{
+    unsigned isum = 0;
+    for (auto& d : data)
+    {
+        isum += sum(d);
+    }
+    return isum;
+}
+}
+
+PICOBENCH_SUITE("bulk setter");
+
+static void loop_setter(picobench::state& s)
+{
+    auto data = make_objects(s.iterations(), false, false);
+
+    {
+        picobench::scope time(s);
+        for (auto& d : data)
+        {
+            add(d, 1);
+        }
+    }
+
+    assert(total_sum(data) == unsigned(s.iterations()));
+}
+PICOBENCH(loop_setter).baseline();
+
+static void call_all_setter(picobench::state& s)
+{
+    auto data = make_objects(s.iterations(), false, false);
+
+    {
+        picobench::scope time(s);
+        dynamix::call_all(add_msg, data, 1);
+    }
+
+    assert(total_sum(data) == unsigned(s.iterations()));
+}
+PICOBENCH(call_all_setter);
+
+static void loop_grouped_setter(picobench::state& s)
+{
+    auto data = make_objects(s.iterations(), false, true);
+
+    {
+        picobench::scope time(s);
+        for (auto& d : data)
+        {
+            add(d, 1);
+        }
+    }
+
+    assert(total_sum(data) == unsigned(s.iterations()));
+}
+PICOBENCH(loop_grouped_setter);
+
+static void call_all_grouped_setter(picobench::state& s)
+{
+    auto data = make_objects(s.iterations(), false, true);
+
+    {
+        picobench::scope time(s);
+        dynamix::call_all(add_msg, data, 1);
+    }
+
+    assert(total_sum(data) == unsigned(s.iterations()));
+}
+PICOBENCH(call_all_grouped_setter);
+
+PICOBENCH_SUITE("bulk 3x multi setter");
+
+static void loop_multi_setter(picobench::state& s)
+{
+    auto data = make_objects(s.iterations(), true, true);
+
+    {
+        picobench::scope time(s);
+        for (auto& d : data)
+        {
+            multi_add(d, 1);
+        }
+    }
+}
+PICOBENCH(loop_multi_setter).baseline();
+
+static void call_all_multi_setter(picobench::state& s)
+{
+    auto data = make_objects(s.iterations(), true, true);
+
+    {
+        picobench::scope time(s);
+        dynamix::call_all(multi_add_msg, data, 1);
+    }
+}
+PICOBENCH(call_all_multi_setter);
@@ -0,0 +1,121 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+
+// compare calling a message for all objects on a single thread
+// with calling it on multiple threads with parallel_call
+//
+// make sure link time optimizations are turned of
+// gcc with no -flto
+// msvc with no link time code generation
+#include "perf.hpp"
+#include "picobench.hpp"
+
+#include <dynamix/parallel_call.hpp>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace
+{
+vector<dynamix::object> make_grouped_multi_objects(int n)
+{
+    vector<dynamix::object> data;
+    data.reserve(n);
+    for (int i = 0; i < n; ++i)
+    {
+        data.emplace_back(new_multi_object(rand()));
+    }
+
+    stable_sort(data.begin(), data.end(), [](const dynamix::object& a, const dynamix::object& b) {
+        return a._type_info < b._type_info;
+    });
+
+    return data;
+}
+}
+
+PICOBENCH_SUITE("parallel 3x multi setter");
+
+static void call_all_multi_setter(picobench::state& s)
+{
+    auto data = make_grouped_multi_objects(s.iterations());
+
+    {
+        picobench::scope time(s);
+        dynamix::call_all(multi_add_msg, data, 1);
+    }
+}
+PICOBENCH(call_all_multi_setter).baseline();
+
+template <size_t NumThreads>
+static void parallel_multi_setter(picobench::state& s)
+{
+    dynamix::work_stealing_executor executor(NumThreads);
+    auto data = make_grouped_multi_objects(s.iterations());
+
+    {
+        picobench::scope time(s);
+        dynamix::parallel_call(executor, multi_add_msg, data, 1);
+    }
+}
+PICOBENCH(parallel_multi_setter<1>).label("1 thread");
+PICOBENCH(parallel_multi_setter<2>).label("2 threads");
+PICOBENCH(parallel_multi_setter<4>).label("4 threads");
+PICOBENCH(parallel_multi_setter<8>).label("8 threads");
+PICOBENCH(parallel_multi_setter<0>).label("all cores");
+
+PICOBENCH_SUITE("parallel 3x multi sum");
+
+static void loop_multi_sum(picobench::state& s)
+{
+    auto data = make_grouped_multi_objects(s.iterations());
+
+    dynamix::combinators::sum<unsigned> total;
+    {
+        picobench::scope time(s);
+        for (auto& d : data)
+        {
+            multi_sum(d, total);
+        }
+    }
+    s.set_result(total.result());
+}
+PICOBENCH(loop_multi_sum).baseline();
+
+static void combine_all_multi_sum(picobench::state& s)
+{
+    auto data = make_grouped_multi_objects(s.iterations());
+
+    dynamix::combinators::sum<unsigned> total;
+    {
+        picobench::scope time(s);
+        dynamix::combine_all(multi_sum_msg, data, total);
+    }
+    s.set_result(total.result());
+}
+PICOBENCH(combine_all_multi_sum);
+
+template <size_t NumThreads>
+static void parallel_multi_sum(picobench::state& s)
+{
+    dynamix::work_stealing_executor executor(NumThreads);
+    auto data = make_grouped_multi_objects(s.iterations());
+
+    dynamix::combinators::sum<unsigned> total;
+    {
+        picobench::scope time(s);
+        dynamix::parallel_combine(executor, multi_sum_msg, data, total);
+    }
+    s.set_result(total.result());
+}
+PICOBENCH(parallel_multi_sum<1>).label("1 thread");
+PICOBENCH(parallel_multi_sum<2>).label("2 threads");
+PICOBENCH(parallel_multi_sum<4>).label("4 threads");
+PICOBENCH(parallel_multi_sum<8>).label("8 threads");
+PICOBENCH(parallel_multi_sum<0>).label("all cores");
@@ -0,0 +1,101 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+
+// compare calling a sequence of messages for each object one by one
+// with calling them through a message pipeline
+//
+// make sure link time optimizations are turned of
+// gcc with no -flto
+// msvc with no link time code generation
+#include "perf.hpp"
+#include "picobench.hpp"
+
+#include <dynamix/message_pipeline.hpp>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace
+{
+vector<dynamix::object> make_multi_objects(int n, bool group_by_type = false)
+{
+    vector<dynamix::object> data;
+    data.reserve(n);
+    for (int i = 0; i < n; ++i)
+    {
+        data.emplace_back(new_multi_object(rand()));
+    }
+
+    if (group_by_type)
+    {
+        stable_sort(data.begin(), data.end(), [](const dynamix::object& a, const dynamix::object& b) {
+            return a._type_info < b._type_info;
+        });
+    }
+
+    return data;
+}
+}
+
+PICOBENCH_SUITE("pipeline add, 3x multi add, add");
+
+static void loop_messages(picobench::state& s)
+{
+    auto data = make_multi_objects(s.iterations());
+
+    {
+        picobench::scope time(s);
+        for (auto& d : data)
+        {
+            add(d, 1);
+            multi_add(d, 1);
+            add(d, 1);
+        }
+    }
+}
+PICOBENCH(loop_messages).baseline();
+
+static void loop_pipeline(picobench::state& s)
+{
+    auto data = make_multi_objects(s.iterations());
+    dynamix::message_pipeline<int> pipeline(add_msg, multi_add_msg, add_msg);
+
+    {
+        picobench::scope time(s);
+        for (auto& d : data)
+        {
+            pipeline(d, 1);
+        }
+    }
+}
+PICOBENCH(loop_pipeline);
+
+static void call_all_pipeline(picobench::state& s)
+{
+    auto data = make_multi_objects(s.iterations());
+    dynamix::message_pipeline<int> pipeline(add_msg, multi_add_msg, add_msg);
+
+    {
+        picobench::scope time(s);
+        pipeline.call_all(data, 1);
+    }
+}
+PICOBENCH(call_all_pipeline);
+
+static void call_all_grouped_pipeline(picobench::state& s)
+{
+    auto data = make_multi_objects(s.iterations(), true);
+    dynamix::message_pipeline<int> pipeline(add_msg, multi_add_msg, add_msg);
+
+    {
+        picobench::scope time(s);
+        pipeline.call_all(data, 1);
+    }
+}
+PICOBENCH(call_all_grouped_pipeline);
@@ -13,21 +13,75 @@
 
 #include "fast_allocator.hpp"
 
+#include <dynamix/type_indexed_table.hpp>
+#include <dynamix/allocators.hpp>
+
 #include <iostream>
+#include <thread>
+#include <string>
+#include <new>
+#include <unordered_map>
 
 using namespace std;
 using namespace dynamix;
 
 PICOBENCH_SUITE("Type creation");
 
+// the mixins of the types of all generated templates
+const vector<internal::mixin_type_info_vector>& get_template_mixins()
+{
+    static vector<internal::mixin_type_info_vector> v;
+    if (!v.empty()) return v;
+    for (auto& t : get_type_templates())
+    {
+        object obj;
+        t->apply_to(obj);
+        v.push_back(obj.type_info()._compact_mixins);
+    }
+    return v;
+}
+
+// since the types of the templates are created only once, and the benchmarks run in a random order
+// this builds new type infos with the same mixins without adding them to the domain
+// as the domain does it: deriving the call table from an existing type, if there is one
 void new_type(picobench::state& s)
 {
+    auto& dom = internal::domain::safe_instance();
+    auto& mixins = get_template_mixins();
+    assert(s.iterations() == int(mixins.size()));
+
+    vector<unique_ptr<object_type_info>> types;
+    types.reserve(mixins.size());
+
     s.start_timer();
-    auto& templates = get_type_templates();
+    for (auto& m : mixins)
+    {
+        mixin_collection collection(m);
+        auto source = dom.find_derivation_source(collection);
+        types.emplace_back(dom.build_object_type_info(std::move(collection), source));
+    }
     s.stop_timer();
-    assert(s.iterations() == templates.size());
 }
-PICOBENCH(new_type).samples(1).iterations({ 1023 });
+PICOBENCH(new_type).iterations({ 1023 });
+
+// same, but building each call table from scratch
+void new_type_full(picobench::state& s)
+{
+    auto& dom = internal::domain::safe_instance();
+    auto& mixins = get_template_mixins();
+    assert(s.iterations() == int(mixins.size()));
+
+    vector<unique_ptr<object_type_info>> types;
+    types.reserve(mixins.size());
+
+    s.start_timer();
+    for (auto& m : mixins)
+    {
+        types.emplace_back(dom.build_object_type_info(m, nullptr));
+    }
+    s.stop_timer();
+}
+PICOBENCH(new_type_full).iterations({ 1023 });
 
 PICOBENCH_SUITE("Object creation");
 
@@ -79,6 +133,75 @@ void type_template_alloc(picobench::state& s)
 }
 PICOBENCH(type_template_alloc);
 
+// applies the generated templates with up to two mixins
+// (they fit in the inline buffer of objects with DYNAMIX_OBJECT_INLINE_BUFFER_SIZE=128)
+void small_type_template(picobench::state& s)
+{
+    vector<const object_type_template*> templates;
+    for (auto& t : get_type_templates())
+    {
+        object obj;
+        t->apply_to(obj);
+        if (obj.type_info()._compact_mixins.size() <= 2) templates.push_back(t.get());
+    }
+
+    vector<object> objects(s.iterations());
+    int i = 0;
+
+    for (auto _ : s)
+    {
+        templates[i % templates.size()]->apply_to(objects[i]);
+        ++i;
+    }
+}
+PICOBENCH(small_type_template);
+
+// applies templates with the mixins of the generated ones in a domain with an allocator
+void domain_type_template(picobench::state& s, domain_allocator& alloc)
+{
+    internal::domain dom;
+    dom.set_allocator(&alloc);
+
+    vector<unique_ptr<object_type_template>> templates;
+    for (auto& mixins : get_template_mixins())
+    {
+        templates.emplace_back(new object_type_template(dom));
+        for (auto info : mixins)
+        {
+            templates.back()->add(info->id);
+        }
+        templates.back()->create();
+    }
+
+    vector<object> objects;
+    objects.reserve(s.iterations());
+    for (int i = 0; i < s.iterations(); ++i)
+    {
+        objects.emplace_back(dom);
+    }
+
+    int i = 0;
+    for (auto _ : s)
+    {
+        templates[i % templates.size()]->apply_to(objects[i]);
+        ++i;
+    }
+}
+
+void per_mixin_allocation(picobench::state& s)
+{
+    internal::default_allocator alloc;
+    domain_type_template(s, alloc);
+}
+PICOBENCH(per_mixin_allocation);
+
+void single_block_allocation(picobench::state& s)
+{
+    single_block_allocator alloc;
+    domain_type_template(s, alloc);
+}
+PICOBENCH(single_block_allocation);
+
 PICOBENCH_SUITE("Object mutation");
 
 vector<object> create_objects(int n, object_allocator* a = nullptr)
@@ -157,6 +280,293 @@ void same_type_mutator_alloc(picobench::state& s)
 }
 PICOBENCH(same_type_mutator_alloc);
 
+PICOBENCH_SUITE("Threaded mutation");
+
+// the objects are split between the threads and each thread mutates its own
+// the type infos are shared, so this measures how well their lookup scales
+template <int Threads>
+void threaded_mutation(picobench::state& s)
+{
+    auto objects = create_objects(s.iterations());
+
+    auto mutate_range = [&objects](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            mutate(objects[i])
+                .add<mixin_5>()
+                .add<mixin_8>()
+                .remove<mixin_9>();
+        }
+    };
+
+    const size_t per_thread = objects.size() / Threads;
+
+    picobench::scope scope(s);
+
+    vector<thread> threads;
+    for (int t = 0; t < Threads - 1; ++t)
+    {
+        threads.emplace_back(mutate_range, t * per_thread, (t + 1) * per_thread);
+    }
+    mutate_range((Threads - 1) * per_thread, objects.size());
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+}
+PICOBENCH(threaded_mutation<1>).label("1 thread");
+PICOBENCH(threaded_mutation<2>).label("2 threads");
+PICOBENCH(threaded_mutation<4>).label("4 threads");
+PICOBENCH(threaded_mutation<8>).label("8 threads");
+
+PICOBENCH_SUITE("Threaded type templates");
+
+// each thread creates type templates of an existing type, which applies the mutation rules
+// and finds the type in the domain
+// with a shared domain the threads contend for its locks, with a domain per thread they don't
+void threaded_templates(picobench::state& s, int num_threads, bool sharded)
+{
+    vector<unique_ptr<internal::domain>> shards;
+    if (sharded)
+    {
+        for (int t = 0; t < num_threads; ++t)
+        {
+            shards.emplace_back(new internal::domain);
+        }
+    }
+
+    auto create_templates = [&shards, sharded](int t, int n)
+    {
+        internal::domain& dom = sharded ? *shards[t] : internal::domain::safe_instance();
+        for (int i = 0; i < n; ++i)
+        {
+            object_type_template tmpl(dom);
+            tmpl
+                .add<mixin_3>()
+                .add<mixin_5>()
+                .add<mixin_8>();
+            tmpl.create();
+        }
+    };
+
+    const int per_thread = s.iterations() / num_threads;
+
+    picobench::scope scope(s);
+
+    vector<thread> threads;
+    for (int t = 1; t < num_threads; ++t)
+    {
+        threads.emplace_back(create_templates, t, per_thread);
+    }
+    create_templates(0, s.iterations() - (num_threads - 1) * per_thread);
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+}
+
+template <int Threads>
+void shared_domain_templates(picobench::state& s)
+{
+    threaded_templates(s, Threads, false);
+}
+
+template <int Threads>
+void sharded_templates(picobench::state& s)
+{
+    threaded_templates(s, Threads, true);
+}
+PICOBENCH(shared_domain_templates<1>).label("1 thread");
+PICOBENCH(shared_domain_templates<4>).label("4 threads");
+PICOBENCH(sharded_templates<4>).label("4 threads sharded");
+PICOBENCH(shared_domain_templates<8>).label("8 threads");
+PICOBENCH(sharded_templates<8>).label("8 threads sharded");
+
+PICOBENCH_SUITE("Mutation rules");
+
+// the rules are applied directly, since the transitions of types are memoized and mutations
+// of existing types rarely reach them
+namespace
+{
+
+// 300 built-in rules: bundles, dependencies and exclusions of synthetic mixins
+const size_t num_rule_triplets = 100;
+
+const vector<unique_ptr<mixin_type_info>>& get_rule_mixins()
+{
+    static vector<unique_ptr<mixin_type_info>> mixins;
+    static vector<string> names;
+    if (!mixins.empty()) return mixins;
+
+    const size_t n = num_rule_triplets * 5;
+    names.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        names.push_back("rule_mixin_" + to_string(i));
+        mixins.emplace_back(new mixin_type_info);
+        auto& info = *mixins.back();
+        info.name = names.back().c_str();
+        info.size = sizeof(int);
+        info.alignment = alignof(int);
+        info.constructor = [](void* mem) { new (mem) int(0); };
+        info.destructor = [](void*) {};
+        internal::domain::safe_instance().register_mixin_type(info);
+    }
+    return mixins;
+}
+
+// hides a built-in rule behind a virtual call, so that it's applied without being compiled
+class uncompiled_rule : public mutation_rule
+{
+public:
+    explicit uncompiled_rule(shared_ptr<mutation_rule> rule)
+        : _rule(std::move(rule))
+    {}
+
+    virtual void apply_to(object_type_mutation& mutation, const mixin_collection& source) override
+    {
+        _rule->apply_to(mutation, source);
+    }
+
+private:
+    shared_ptr<mutation_rule> _rule;
+};
+
+void add_rules(internal::domain& dom, bool compiled)
+{
+    auto& mixins = get_rule_mixins();
+
+    auto add = [&dom, compiled](shared_ptr<mutation_rule> rule)
+    {
+        if (compiled) dom.add_mutation_rule(std::move(rule));
+        else dom.add_mutation_rule(make_shared<uncompiled_rule>(std::move(rule)));
+    };
+
+    for (size_t i = 0; i < num_rule_triplets; ++i)
+    {
+        auto m = mixins.data() + i * 5;
+
+        auto bundle = make_shared<bundled_mixins>();
+        bundle->add(*m[0]);
+        bundle->add(*m[1]);
+        add(bundle);
+
+        auto dependent = make_shared<dependent_mixins>();
+        dependent->set_master<mixin_1>();
+        dependent->add(*m[2]);
+        add(dependent);
+
+        auto exclusive = make_shared<mutually_exclusive_mixins>();
+        exclusive->add(*m[3]);
+        exclusive->add(*m[4]);
+        add(exclusive);
+    }
+}
+
+void apply_rules(picobench::state& s, bool compiled)
+{
+    internal::domain dom;
+    add_rules(dom, compiled);
+
+    auto& mixins = get_rule_mixins();
+    const mixin_collection source;
+
+    for (auto _ : s)
+    {
+        object_type_mutation mutation;
+        mutation.start_adding<mixin_3>();
+        mutation.start_adding(*mixins[0]);
+        mutation.start_adding(*mixins[3]);
+        dom.apply_mutation_rules(mutation, source);
+    }
+}
+
+}
+
+void virtual_rules(picobench::state& s)
+{
+    apply_rules(s, false);
+}
+PICOBENCH(virtual_rules);
+
+void compiled_rules(picobench::state& s)
+{
+    apply_rules(s, true);
+}
+PICOBENCH(compiled_rules);
+
+PICOBENCH_SUITE("Per-type data");
+
+// objects of the types of all generated templates
+const vector<object>& get_objects_of_all_types()
+{
+    static vector<object> v;
+    if (!v.empty()) return v;
+    for (auto& t : get_type_templates())
+    {
+        v.emplace_back(*t);
+    }
+    return v;
+}
+
+void per_type_map(picobench::state& s)
+{
+    auto& objects = get_objects_of_all_types();
+    unordered_map<const object_type_info*, int> data;
+    for (auto& o : objects)
+    {
+        data[&o.type_info()] = 1;
+    }
+
+    int sum = 0;
+    for (auto _ : s)
+    {
+        sum += data[&objects[_ % objects.size()].type_info()];
+    }
+    s.set_result(uintptr_t(sum));
+}
+PICOBENCH(per_type_map);
+
+void per_type_table(picobench::state& s)
+{
+    auto& objects = get_objects_of_all_types();
+    type_indexed_table<int> data;
+    for (auto& o : objects)
+    {
+        data[o.type_info()] = 1;
+    }
+
+    int sum = 0;
+    for (auto _ : s)
+    {
+        sum += data[objects[_ % objects.size()].type_info()];
+    }
+    s.set_result(uintptr_t(sum));
+}
+PICOBENCH(per_type_table);
+
+// report how much memory the types of the generated templates occupy
+void report_type_memory()
+{
+    auto& templates = get_type_templates();
+
+    size_t total = 0;
+    for (auto& t : templates)
+    {
+        object obj;
+        t->apply_to(obj);
+        total += obj.type_info().memory_footprint();
+    }
+
+    cout << "\nType memory (DYNAMIX_COMPACT_TYPE_INFO=" << DYNAMIX_COMPACT_TYPE_INFO << ")\n";
+    cout << "  types: " << templates.size() << "\n";
+    cout << "  total bytes: " << total << "\n";
+    cout << "  bytes per type: " << total / templates.size() << "\n";
+}
+
 #include "regression_tester.inl"
 
 int main(int argc, char* argv[])
@@ -184,6 +594,8 @@ int main(int argc, char* argv[])
 
     report.to_text(std::cout);
 
+    report_type_memory();
+
     int i;
     for(i=1; i<argc; ++i)
     {
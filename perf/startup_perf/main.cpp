@@ -0,0 +1,185 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include <dynamix/core.hpp>
+
+#define PICOBENCH_IMPLEMENT
+#include "picobench.hpp"
+
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace dynamix;
+
+// what happens at static initialization when many mixins and messages are registered
+// the mixins and messages are synthetic: they're made at run time with generated names
+
+namespace
+{
+
+struct synthetic_message : public internal::message_t
+{
+    explicit synthetic_message(const char* name)
+        : message_t(name, unicast, false)
+    {}
+};
+
+vector<string> make_names(const char* prefix, size_t n)
+{
+    vector<string> names;
+    names.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        names.push_back(prefix + to_string(i));
+    }
+    return names;
+}
+
+vector<unique_ptr<mixin_type_info>> make_mixins(const vector<string>& names)
+{
+    vector<unique_ptr<mixin_type_info>> mixins;
+    mixins.reserve(names.size());
+    for (auto& name : names)
+    {
+        mixins.emplace_back(new mixin_type_info);
+        auto& info = *mixins.back();
+        info.name = name.c_str();
+        info.size = sizeof(int);
+        info.alignment = alignof(int);
+        info.constructor = [](void* mem) { new (mem) int(0); };
+        info.destructor = [](void*) {};
+    }
+    return mixins;
+}
+
+void unregister(vector<unique_ptr<mixin_type_info>>& mixins)
+{
+    auto& dom = internal::domain::safe_instance();
+    for (auto& info : mixins)
+    {
+        dom.unregister_mixin_type(*info);
+    }
+}
+
+}
+
+PICOBENCH_SUITE("Registration");
+
+void register_mixins(picobench::state& s)
+{
+    auto& dom = internal::domain::safe_instance();
+    auto names = make_names("synthetic_mixin_", size_t(s.iterations()));
+    auto mixins = make_mixins(names);
+
+    s.start_timer();
+    for (auto& info : mixins)
+    {
+        dom.register_mixin_type(*info);
+    }
+    s.stop_timer();
+
+    unregister(mixins);
+}
+PICOBENCH(register_mixins);
+
+void register_messages(picobench::state& s)
+{
+    auto& dom = internal::domain::safe_instance();
+    auto names = make_names("synthetic_message_", size_t(s.iterations()));
+
+    vector<unique_ptr<synthetic_message>> messages;
+    messages.reserve(names.size());
+    for (auto& name : names)
+    {
+        messages.emplace_back(new synthetic_message(name.c_str()));
+    }
+
+    s.start_timer();
+    for (auto& m : messages)
+    {
+        dom.register_feature(*m);
+    }
+    s.stop_timer();
+
+    for (auto& m : messages)
+    {
+        dom.unregister_feature(*m);
+    }
+}
+PICOBENCH(register_messages);
+
+PICOBENCH_SUITE("Lookup");
+
+// as done by mutations by name and by type manifests
+void mixin_id_by_name(picobench::state& s)
+{
+    auto& dom = internal::domain::safe_instance();
+    auto names = make_names("synthetic_mixin_", size_t(s.iterations()));
+    auto mixins = make_mixins(names);
+    for (auto& info : mixins)
+    {
+        dom.register_mixin_type(*info);
+    }
+
+    size_t found = 0;
+    s.start_timer();
+    for (auto& name : names)
+    {
+        found += dom.get_mixin_id_by_name(name.c_str()) != INVALID_MIXIN_ID;
+    }
+    s.stop_timer();
+    s.set_result(found);
+
+    unregister(mixins);
+}
+PICOBENCH(mixin_id_by_name);
+
+void mixin_id_by_handle(picobench::state& s)
+{
+    auto& dom = internal::domain::safe_instance();
+    auto names = make_names("synthetic_mixin_", size_t(s.iterations()));
+    auto mixins = make_mixins(names);
+    for (auto& info : mixins)
+    {
+        dom.register_mixin_type(*info);
+    }
+
+    vector<mixin_name_handle> handles;
+    handles.reserve(names.size());
+    for (auto& name : names)
+    {
+        handles.emplace_back(name.c_str());
+    }
+
+    size_t found = 0;
+    s.start_timer();
+    for (auto& handle : handles)
+    {
+        found += handle.id() != INVALID_MIXIN_ID;
+    }
+    s.stop_timer();
+    s.set_result(found);
+
+    unregister(mixins);
+}
+PICOBENCH(mixin_id_by_handle);
+
+int main(int argc, char* argv[])
+{
+    picobench::runner r;
+
+    // set some defaults in case there are no cmd-line arguments
+    r.set_default_samples(3);
+    r.set_default_state_iterations({ 1000, 4000, 16000 });
+
+    r.parse_cmd_line(argc, argv, "--pb");
+
+    return r.run();
+}
@@ -37,6 +37,16 @@ void mixin_allocator::destroy_mixin(const mixin_type_info& info, void* ptr) noex
     info.destructor(ptr);
 }
 
+char* domain_allocator::alloc_object_block(size_t, const object*)
+{
+    return nullptr;
+}
+
+void domain_allocator::dealloc_object_block(char*, size_t, const object*)
+{
+    I_DYNAMIX_ASSERT_MSG(false, "deallocating a block from an allocator which doesn't allocate blocks");
+}
+
 void object_allocator::on_set_to_object(object&)
 {}
 
@@ -102,4 +112,20 @@ void default_allocator::dealloc_mixin(char* ptr, size_t, const mixin_type_info&,
 
 } // namespace internal
 
+char* single_block_allocator::alloc_object_block(size_t size, const object*)
+{
+#if DYNAMIX_DEBUG
+    _has_allocated.store(true, std::memory_order_relaxed);
+#endif
+    return new char[size];
+}
+
+void single_block_allocator::dealloc_object_block(char* ptr, size_t, const object*)
+{
+#if DYNAMIX_DEBUG
+    I_DYNAMIX_ASSERT(has_allocated());
+#endif
+    delete[] ptr;
+}
+
 } // namespace dynamix
@@ -9,6 +9,7 @@
 #include <dynamix/common_mutation_rules.hpp>
 #include <dynamix/object_type_mutation.hpp>
 #include "dynamix/internal/assert.hpp"
+#include "compiled_mutation_rules.hpp"
 
 namespace dynamix
 {
@@ -61,6 +62,12 @@ void mutually_exclusive_mixins::apply_to(object_type_mutation& mutation, const m
     }
 }
 
+bool mutually_exclusive_mixins::compile_to(mutation_rule_compiler& compiler) const
+{
+    compiler.add_exclusion(_compact_mixins);
+    return true;
+}
+
 void bundled_mixins::apply_to(object_type_mutation& mutation, const mixin_collection&)
 {
     // find if the mutation is adding any of the bundled mixins
@@ -102,6 +109,12 @@ void bundled_mixins::apply_to(object_type_mutation& mutation, const mixin_collec
     }
 }
 
+bool bundled_mixins::compile_to(mutation_rule_compiler& compiler) const
+{
+    compiler.add_bundle(_compact_mixins);
+    return true;
+}
+
 void dependent_mixins::apply_to(object_type_mutation& mutation, const mixin_collection&)
 {
     if (mutation.is_adding(_master_id))
@@ -122,6 +135,12 @@ void dependent_mixins::apply_to(object_type_mutation& mutation, const mixin_coll
     }
 }
 
+bool dependent_mixins::compile_to(mutation_rule_compiler& compiler) const
+{
+    compiler.add_dependency(_master_id, _compact_mixins);
+    return true;
+}
+
 namespace internal
 {
 void mandatory_mixin_impl::apply_to(object_type_mutation& mutation, const mixin_collection& source)
@@ -137,6 +156,12 @@ void mandatory_mixin_impl::apply_to(object_type_mutation& mutation, const mixin_
     mutation.start_adding(_id);
 }
 
+bool mandatory_mixin_impl::compile_to(mutation_rule_compiler& compiler) const
+{
+    compiler.add_mandatory(_id);
+    return true;
+}
+
 void deprecated_mixin_impl::apply_to(object_type_mutation& mutation, const mixin_collection& source)
 {
     if(source.has(_id))
@@ -150,6 +175,12 @@ void deprecated_mixin_impl::apply_to(object_type_mutation& mutation, const mixin
     }
 }
 
+bool deprecated_mixin_impl::compile_to(mutation_rule_compiler& compiler) const
+{
+    compiler.add_deprecated(_id);
+    return true;
+}
+
 void substitute_mixin_impl::apply_to(object_type_mutation& mutation, const mixin_collection&)
 {
     if(mutation.is_adding(_source_id))
@@ -159,5 +190,11 @@ void substitute_mixin_impl::apply_to(object_type_mutation& mutation, const mixin
     }
 }
 
+bool substitute_mixin_impl::compile_to(mutation_rule_compiler& compiler) const
+{
+    compiler.add_substitute(_source_id, _target_id);
+    return true;
+}
+
 } // namespace internal
 } // namespace dynamix
@@ -0,0 +1,332 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "internal.hpp"
+#include "compiled_mutation_rules.hpp"
+
+#include <dynamix/mutation_rule.hpp>
+#include <dynamix/object_type_mutation.hpp>
+#include "dynamix/internal/assert.hpp"
+
+namespace dynamix
+{
+namespace internal
+{
+
+void mutation_rule_compiler::add_drag(mixin_id from, mixin_id to)
+{
+    if (from >= _drags.size()) _drags.resize(from + 1);
+    _drags[from].push_back(to);
+}
+
+void mutation_rule_compiler::add_bundle(const mixin_type_info_vector& mixins)
+{
+    for (const mixin_type_info* a : mixins)
+    {
+        for (const mixin_type_info* b : mixins)
+        {
+            if (a != b) add_drag(a->id, b->id);
+        }
+    }
+}
+
+void mutation_rule_compiler::add_dependency(mixin_id master, const mixin_type_info_vector& dependents)
+{
+    if (master == INVALID_MIXIN_ID) return; // no master was set
+
+    for (const mixin_type_info* dep : dependents)
+    {
+        add_drag(master, dep->id);
+    }
+}
+
+void mutation_rule_compiler::add_exclusion(const mixin_type_info_vector& mixins)
+{
+    _exclusions.push_back(mixins);
+}
+
+void mutation_rule_compiler::add_mandatory(mixin_id id)
+{
+    _mandatory.push_back(id);
+}
+
+void mutation_rule_compiler::add_deprecated(mixin_id id)
+{
+    _deprecated.push_back(id);
+}
+
+void mutation_rule_compiler::add_substitute(mixin_id source, mixin_id target)
+{
+    _substitutes.emplace_back(source, target);
+}
+
+bool mutation_rule_compiler::empty() const
+{
+    return _drags.empty()
+        && _exclusions.empty()
+        && _mandatory.empty()
+        && _deprecated.empty()
+        && _substitutes.empty();
+}
+
+struct compiled_mutation_rules::block
+{
+    // the following are indexed by mixin id
+
+    // the mixins which are added or removed along with a mixin
+    std::vector<id_bitset> drags;
+
+    // the mixins which are removed when a mixin is added
+    std::vector<id_bitset> exclusions;
+
+    // the mixin which is added instead of a mixin or INVALID_MIXIN_ID
+    std::vector<mixin_id> substitutes;
+
+    id_bitset deprecated;
+    std::vector<mixin_id> mandatory;
+};
+
+compiled_mutation_rules::compiled_mutation_rules(const std::vector<std::shared_ptr<mutation_rule>>& rules)
+{
+    mutation_rule_compiler compiler;
+
+    for (auto& rule : rules)
+    {
+        if (!rule) continue; // removed rule
+        if (rule->compile_to(compiler)) continue;
+
+        stage s;
+        if (!compiler.empty())
+        {
+            s.compiled = compile(compiler);
+            compiler = mutation_rule_compiler();
+        }
+        s.custom = rule;
+        _stages.emplace_back(std::move(s));
+
+        _has_custom_rules = true;
+    }
+
+    if (!compiler.empty())
+    {
+        stage s;
+        s.compiled = compile(compiler);
+        _stages.emplace_back(std::move(s));
+    }
+}
+
+compiled_mutation_rules::~compiled_mutation_rules() = default;
+
+std::unique_ptr<compiled_mutation_rules::block> compiled_mutation_rules::compile(const mutation_rule_compiler& compiler)
+{
+    std::unique_ptr<block> b(new block);
+
+    // the transitive closure of the drags
+    // a mixin drags along the mixins it drags directly and everything that they drag
+    auto& drags = compiler._drags;
+    if (!drags.empty())
+    {
+        b->drags.resize(drags.size());
+        std::vector<mixin_id> pending;
+        for (mixin_id id = 0; id < drags.size(); ++id)
+        {
+            if (drags[id].empty()) continue;
+
+            auto& closure = b->drags[id];
+            pending.assign(drags[id].begin(), drags[id].end());
+            while (!pending.empty())
+            {
+                const mixin_id dragged = pending.back();
+                pending.pop_back();
+                if (closure.has(dragged)) continue;
+
+                closure.add(dragged);
+                if (dragged < drags.size())
+                {
+                    pending.insert(pending.end(), drags[dragged].begin(), drags[dragged].end());
+                }
+            }
+        }
+    }
+
+    for (auto& group : compiler._exclusions)
+    {
+        for (const mixin_type_info* info : group)
+        {
+            if (info->id >= b->exclusions.size()) b->exclusions.resize(info->id + 1);
+            auto& excluded = b->exclusions[info->id];
+            for (const mixin_type_info* other : group)
+            {
+                if (other != info) excluded.add(other->id);
+            }
+        }
+    }
+
+    auto& substitutes = b->substitutes;
+    for (auto& s : compiler._substitutes)
+    {
+        if (s.first >= substitutes.size()) substitutes.resize(s.first + 1, INVALID_MIXIN_ID);
+        substitutes[s.first] = s.second;
+    }
+    // resolve chains of substitutes, so that each is a single lookup
+    // the number of steps is limited in case of cycles
+    for (auto& target : substitutes)
+    {
+        for (size_t i = 0; i < substitutes.size(); ++i)
+        {
+            if (target >= substitutes.size() || substitutes[target] == INVALID_MIXIN_ID) break;
+            target = substitutes[target];
+        }
+    }
+
+    for (mixin_id id : compiler._deprecated)
+    {
+        b->deprecated.add(id);
+    }
+
+    b->mandatory = compiler._mandatory;
+
+    return b;
+}
+
+void compiled_mutation_rules::apply_to(object_type_mutation& mutation, const mixin_collection& source) const
+{
+    for (auto& s : _stages)
+    {
+        if (s.compiled)
+        {
+            apply_block(*s.compiled, mutation, source);
+        }
+
+        if (s.custom)
+        {
+            s.custom->apply_to(mutation, source);
+        }
+    }
+}
+
+namespace
+{
+// the sets used while applying a block
+// they are kept per thread and only cleared, so that applying the rules doesn't allocate
+// (except the first time a thread meets a bigger mixin id)
+struct apply_scratch
+{
+    id_bitset dragged_in;
+    id_bitset dragged_out;
+    id_bitset excluded;
+};
+}
+
+void compiled_mutation_rules::apply_block(const block& b, object_type_mutation& mutation, const mixin_collection& source)
+{
+    static thread_local apply_scratch scratch;
+
+    mixin_collection& adding = mutation._adding;
+    mixin_collection& removing = mutation._removing;
+
+    if (!b.substitutes.empty())
+    {
+        // the mutation changes, so find the substituted mixins first
+        mixin_set substituted;
+        for (mixin_id id : adding._mixins)
+        {
+            if (id < b.substitutes.size() && b.substitutes[id] != INVALID_MIXIN_ID)
+            {
+                substituted.add(id);
+            }
+        }
+
+        for (mixin_id id : substituted)
+        {
+            adding.remove(id);
+            adding.add(b.substitutes[id]);
+        }
+    }
+
+    if (!b.drags.empty())
+    {
+        id_bitset& dragged_in = scratch.dragged_in;
+        dragged_in.clear();
+        for (mixin_id id : adding._mixins)
+        {
+            if (id < b.drags.size()) dragged_in.add(b.drags[id]);
+        }
+
+        id_bitset& dragged_out = scratch.dragged_out;
+        dragged_out.clear();
+        for (mixin_id id : removing._mixins)
+        {
+            if (id < b.drags.size()) dragged_out.add(b.drags[id]);
+        }
+
+        // adding takes precedence over removing
+        dragged_out.remove(dragged_in);
+
+        dragged_in.for_each([&adding](size_t id) { adding.add(mixin_id(id)); });
+        dragged_out.for_each([&removing](size_t id) { removing.add(mixin_id(id)); });
+    }
+
+    if (!b.exclusions.empty())
+    {
+        id_bitset& excluded = scratch.excluded;
+        excluded.clear();
+        for (mixin_id id : adding._mixins)
+        {
+            if (id < b.exclusions.size()) excluded.add(b.exclusions[id]);
+        }
+
+        if (!excluded.empty())
+        {
+            for (mixin_id id : adding._mixins)
+            {
+                I_DYNAMIX_ASSERT_MSG(!excluded.has(id), "mutation breaking a mutually exclusive mixin rule");
+                (void)id;
+            }
+
+            for (mixin_id id : source._mixins)
+            {
+                if (excluded.has(id) && !adding.has(id))
+                {
+                    removing.add(id);
+                }
+            }
+        }
+    }
+
+    if (!b.deprecated.empty())
+    {
+        mixin_set deprecated;
+        for (mixin_id id : adding._mixins)
+        {
+            if (b.deprecated.has(id)) deprecated.add(id);
+        }
+
+        for (mixin_id id : deprecated)
+        {
+            adding.remove(id);
+        }
+
+        for (mixin_id id : source._mixins)
+        {
+            if (b.deprecated.has(id)) removing.add(id);
+        }
+    }
+
+    for (mixin_id id : b.mandatory)
+    {
+        removing.remove(id);
+
+        if (!source.has(id))
+        {
+            adding.add(id);
+        }
+    }
+}
+
+} // namespace internal
+} // namespace dynamix
@@ -0,0 +1,107 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#pragma once
+
+#include <dynamix/mixin_id.hpp>
+#include <dynamix/mixin_collection.hpp>
+#include <dynamix/internal/id_bitset.hpp>
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace dynamix
+{
+
+class mutation_rule;
+class object_type_mutation;
+
+namespace internal
+{
+
+// the built-in mutation rules describe themselves to a compiler (see mutation_rule::compile_to)
+// which collects them so they can be applied together
+class mutation_rule_compiler
+{
+public:
+    // adding one of the mixins adds all and removing one removes all
+    void add_bundle(const mixin_type_info_vector& mixins);
+
+    // adding the master adds the dependents and removing it removes them
+    void add_dependency(mixin_id master, const mixin_type_info_vector& dependents);
+
+    // adding one of the mixins removes the others
+    void add_exclusion(const mixin_type_info_vector& mixins);
+
+    void add_mandatory(mixin_id id);
+    void add_deprecated(mixin_id id);
+    void add_substitute(mixin_id source, mixin_id target);
+
+    bool empty() const;
+
+private:
+    friend class compiled_mutation_rules;
+
+    void add_drag(mixin_id from, mixin_id to);
+
+    // the edges of a graph in which adding or removing a mixin also adds or removes its neighbors
+    std::vector<std::vector<mixin_id>> _drags;
+
+    std::vector<mixin_type_info_vector> _exclusions;
+    std::vector<mixin_id> _mandatory;
+    std::vector<mixin_id> _deprecated;
+    std::vector<std::pair<mixin_id, mixin_id>> _substitutes;
+};
+
+// an immutable form of the mutation rules of a domain
+//
+// consecutive built-in rules are compiled into a block, which is applied with a few bitset
+// operations instead of visiting each rule: the mixins which a mixin drags along when added
+// or removed (through bundles and dependencies) are precomputed as a transitive closure,
+// and so are the mixins which it excludes
+//
+// the rules in a block are applied in the following order, regardless of the order in which
+// they were added: substitutes, bundles and dependencies, exclusions, deprecated mixins
+// and finally mandatory mixins
+//
+// custom rules are applied with a virtual call in their position among the blocks
+class compiled_mutation_rules
+{
+public:
+    explicit compiled_mutation_rules(const std::vector<std::shared_ptr<mutation_rule>>& rules);
+    ~compiled_mutation_rules();
+
+    compiled_mutation_rules(const compiled_mutation_rules&) = delete;
+    compiled_mutation_rules& operator=(const compiled_mutation_rules&) = delete;
+
+    // custom rules may not be thread safe, so calls to them must be serialized
+    bool has_custom_rules() const { return _has_custom_rules; }
+
+    void apply_to(object_type_mutation& mutation, const mixin_collection& source) const;
+
+private:
+    struct block;
+
+    struct stage
+    {
+        // compiled built-in rules which are applied first (may be null)
+        std::unique_ptr<block> compiled;
+
+        // a custom rule applied after them (may be null)
+        std::shared_ptr<mutation_rule> custom;
+    };
+
+    std::vector<stage> _stages;
+    bool _has_custom_rules = false;
+
+    static std::unique_ptr<block> compile(const mutation_rule_compiler& compiler);
+    static void apply_block(const block& b, object_type_mutation& mutation, const mixin_collection& source);
+};
+
+} // namespace internal
+} // namespace dynamix
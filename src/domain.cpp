@@ -7,15 +7,19 @@
 //
 #include "internal.hpp"
 #include "dynamix/domain.hpp"
-#include "zero_memory.hpp"
 #include "dynamix/object_type_info.hpp"
 #include "dynamix/mutation_rule.hpp"
 #include "dynamix/allocators.hpp"
 #include "dynamix/internal/mixin_traits.hpp"
 #include "dynamix/features.hpp"
 #include "dynamix/type_class.hpp"
+#include "dynamix/mixin_name_handle.hpp"
+#include "dynamix/type_indexed_table.hpp"
+#include "compiled_mutation_rules.hpp"
 
 #include <algorithm>
+#include <functional>
+#include <cstring>
 
 namespace dynamix
 {
@@ -27,9 +31,121 @@ namespace internal
 
 DYNAMIX_API default_allocator the_default_allocator;
 
+struct domain::gc_state
+{
+    ~gc_state()
+    {
+        destroy(retired);
+        destroy(retiring);
+    }
+
+    type_info_gc_policy policy;
+    type_info_gc_stats stats;
+
+    // memory footprint of the type infos in the map
+    size_t type_infos_size = 0;
+
+    size_t num_created_since_collection = 0;
+
+    // type infos and transitions which have been removed by collections and are to be destroyed
+    struct batch
+    {
+        std::vector<const object_type_info*> type_infos;
+        std::vector<const object_type_info::transition*> transitions;
+
+        bool empty() const { return type_infos.empty() && transitions.empty(); }
+    };
+
+    static void destroy(batch& b)
+    {
+        for (auto info : b.type_infos)
+        {
+            delete info;
+        }
+        b.type_infos.clear();
+
+        for (auto t : b.transitions)
+        {
+            object_type_info::delete_transitions(t);
+        }
+        b.transitions.clear();
+    }
+
+    // lookups register in a reader count for the current epoch (the parity of the epoch)
+    // a collection advances the epoch after it removes type infos from the map and whatever
+    // they removed is destroyed when the readers of the previous epoch are gone
+    // the epoch is advanced again only after that, so a count is only reused when it has drained
+    std::atomic<size_t> epoch = {0};
+    std::atomic<size_t> num_readers[2];
+
+    // removed before the last advance of the epoch
+    // waits for the readers of retired_epoch
+    batch retired;
+    size_t retired_epoch = 0;
+
+    // removed since the last advance of the epoch
+    batch retiring;
+
+    gc_state()
+    {
+        num_readers[0].store(0, std::memory_order_relaxed);
+        num_readers[1].store(0, std::memory_order_relaxed);
+    }
+
+    void destroy_retired_if_unused()
+    {
+        if (retired.empty()) return;
+        if (num_readers[retired_epoch & 1].load() != 0) return;
+
+        stats.num_pending -= retired.type_infos.size();
+        destroy(retired);
+    }
+
+    void advance_epoch()
+    {
+        if (!retired.empty() || retiring.empty()) return;
+
+        std::swap(retired, retiring);
+        retired_epoch = epoch.fetch_add(1);
+    }
+
+    bool over_limits(size_t num_type_infos) const
+    {
+        return (policy.max_type_infos && num_type_infos > policy.max_type_infos)
+            || (policy.max_type_infos_size && type_infos_size > policy.max_type_infos_size);
+    }
+};
+
+domain::type_info_read_guard::type_info_read_guard(const domain& dom)
+    : _domain(dom)
+{
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    auto& gc = *dom._gc;
+    for (;;)
+    {
+        _epoch = gc.epoch.load();
+        gc.num_readers[_epoch & 1].fetch_add(1);
+
+        // the epoch could have been advanced before we registered
+        // in this case the count we registered in could be the one being drained
+        if (gc.epoch.load() == _epoch) break;
+        gc.num_readers[_epoch & 1].fetch_sub(1);
+    }
+#else
+    _epoch = 0;
+#endif
+}
+
+domain::type_info_read_guard::~type_info_read_guard()
+{
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    _domain._gc->num_readers[_epoch & 1].fetch_sub(1);
+#endif
+}
+
 domain& domain::safe_instance()
 {
-    static domain the_domain;
+    static domain the_domain((default_domain_tag()));
     return the_domain;
 }
 
@@ -40,16 +156,50 @@ const domain& domain::instance()
     return _instance;
 }
 
+domain::domain(default_domain_tag)
+    : _allocator(&the_default_allocator)
+    , _type_info_generation(0)
+    , _mutation_rules_generation(0)
+    , _type_use_clock(0)
+    , _gc(new gc_state)
+    , _is_default(true)
+{
+    // the registries grow when needed
+    // reserving them means that they won't be reallocated unless the limits are exceeded
+    _mixin_type_infos.reserve(DYNAMIX_MAX_MIXINS);
+    _messages.reserve(DYNAMIX_MAX_MESSAGES);
+}
+
 domain::domain()
-    : _num_registered_mixins(0)
-    , _num_registered_messages(0)
-    , _allocator(&the_default_allocator)
+    : _allocator(safe_instance().allocator())
+    , _type_info_generation(0)
+    , _mutation_rules_generation(0)
+    , _type_use_clock(0)
+    , _gc(new gc_state)
+    , _is_default(false)
 {
-    zero_memory(_mixin_type_infos, sizeof(_mixin_type_infos));
-    zero_memory(_messages, sizeof(_messages));
+    auto& def = safe_instance();
+
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    std::lock_guard<std::mutex> lock(def._additional_domains_mutex);
+#endif
+
+    def._additional_domains.push_back(this);
 }
 
-domain::~domain() = default;
+domain::~domain()
+{
+    if (_is_default) return;
+
+    auto& def = safe_instance();
+
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    std::lock_guard<std::mutex> lock(def._additional_domains_mutex);
+#endif
+
+    auto& domains = def._additional_domains;
+    domains.erase(std::find(domains.begin(), domains.end(), this));
+}
 
 mutation_rule_id domain::add_mutation_rule(mutation_rule* rule)
 {
@@ -63,19 +213,26 @@ mutation_rule_id domain::add_mutation_rule(std::shared_ptr<mutation_rule> rule)
     std::lock_guard<std::mutex> lock(_mutation_rules_mutex);
 #endif
 
+    ++safe_instance()._mutation_rules_generation;
+
     // find free slot
-    for (mutation_rule_id i = 0; i < _mutation_rules.size(); ++i)
+    mutation_rule_id id = 0;
+    for (; id < _mutation_rules.size(); ++id)
     {
-        auto& r = _mutation_rules[i];
-        if (!r)
-        {
-            r = rule;
-            return i;
-        }
+        if (!_mutation_rules[id]) break;
     }
 
-    _mutation_rules.emplace_back(std::move(rule));
-    return _mutation_rules.size() - 1;
+    if (id == _mutation_rules.size())
+    {
+        _mutation_rules.emplace_back(std::move(rule));
+    }
+    else
+    {
+        _mutation_rules[id] = std::move(rule);
+    }
+
+    compile_mutation_rules();
+    return id;
 }
 
 std::shared_ptr<mutation_rule> domain::remove_mutation_rule(mutation_rule_id id)
@@ -86,82 +243,194 @@ std::shared_ptr<mutation_rule> domain::remove_mutation_rule(mutation_rule_id id)
 
     if (id >= _mutation_rules.size()) return std::shared_ptr<mutation_rule>();
 
+    ++safe_instance()._mutation_rules_generation;
+
     auto ret = _mutation_rules[id];
     _mutation_rules[id].reset();
+    compile_mutation_rules();
     return ret;
 }
 
+void domain::compile_mutation_rules()
+{
+    std::shared_ptr<const compiled_mutation_rules> compiled(new compiled_mutation_rules(_mutation_rules));
+
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    std::atomic_store(&_compiled_mutation_rules, compiled);
+#else
+    _compiled_mutation_rules = std::move(compiled);
+#endif
+}
+
 void domain::apply_mutation_rules(object_type_mutation& mutation, const mixin_collection& source_mixins)
 {
 #if DYNAMIX_THREAD_SAFE_MUTATIONS
-    std::lock_guard<std::mutex> lock(_mutation_rules_mutex);
+    // hold the snapshot in case the rules are changed while it's being applied
+    auto rules = std::atomic_load(&_compiled_mutation_rules);
+#else
+    auto& rules = _compiled_mutation_rules;
 #endif
 
-    for (auto& rule : _mutation_rules)
+    if (!rules) return;
+
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    // the built-in rules are immutable, but the custom ones might not be thread safe
+    std::unique_lock<std::mutex> lock(_mutation_rules_mutex, std::defer_lock);
+    if (rules->has_custom_rules())
     {
-        if (rule)
-        {
-            rule->apply_to(mutation, source_mixins);
-        }
+        lock.lock();
     }
+#endif
+
+    rules->apply_to(mutation, source_mixins);
 }
 
-const object_type_info* domain::get_object_type_info(mixin_collection mixins)
+const object_type_info* domain::get_object_type_info(mixin_collection mixins, const object_type_info* source)
 {
     // the mixin type infos need to be sorted
     // so as to guarantee that two object type infos of the same mixins
     // will have the exact same content
     I_DYNAMIX_ASSERT(std::is_sorted(mixins._compact_mixins.begin(), mixins._compact_mixins.end()));
 
+    // the type infos found in the map or used as a source may be collected concurrently
+    type_info_read_guard guard(*this);
+
+    // fast path: lock-free lookup
+    // it may miss a type info which is being published concurrently, which is confirmed below
+    if (auto existing = _object_type_infos.find(mixins._mixins))
+    {
+        I_DYNAMIX_ASSERT(mixins._compact_mixins == existing->_compact_mixins);
+        if (existing->try_pin())
+        {
+            return existing;
+        }
+
+        // it's being collected
+        // a new one will be created, after the collection has removed it from the map
+    }
+
+    if (!source || source->as_mixin_collection()->empty())
+    {
+        source = find_derivation_source(mixins);
+    }
+
+    // create object type info
+    // this is done outside of the lock, so threads which create different types don't wait for each other
+    auto new_type = build_object_type_info(std::move(mixins), source);
+
 #if DYNAMIX_THREAD_SAFE_MUTATIONS
-    // TODO C++17: do this with a shared mutex instead
     std::lock_guard<std::mutex> lock(_object_type_infos_mutex);
 #endif
 
-    object_type_info_map::iterator it = _object_type_infos.find(mixins._mixins);
-
-    if(it != _object_type_infos.end())
+    if (auto existing = _object_type_infos.find(new_type->_mixins))
     {
-        // get existing
-        I_DYNAMIX_ASSERT(mixins._compact_mixins == it->second->_compact_mixins);
-        return it->second.get();
+        // another thread has published the same type in the meantime
+        // ours is discarded
+        // collections hold the lock, so the type infos in the map can always be pinned here
+        const bool pinned = existing->try_pin();
+        I_DYNAMIX_ASSERT(pinned);
+        (void)pinned;
+        return existing;
     }
-    else
-    {
-        // create object type info
-        // use unique_ptr since fill_call_table might throw
-        std::unique_ptr<object_type_info> new_type(new object_type_info);
-        new_type->_mixins = mixins._mixins;
 
-        uint32_t index = 0;
-        for(auto info : mixins._compact_mixins)
+    // add matching type classes
+    // this is done under the lock, since registering type classes locks all domains
+    auto& type_classes = safe_instance()._type_classes;
+    if (!type_classes.empty())
+    {
+        // for the masks of declarative type classes
+        id_bitset mixin_ids;
+        for (mixin_id id : new_type->_mixins)
         {
-            I_DYNAMIX_ASSERT(info);
-            new_type->_mixin_indices[info->id] = index + object_type_info::MIXIN_INDEX_OFFSET;
-            ++index;
+            mixin_ids.add(id);
         }
 
-        new_type->_compact_mixins = std::move(mixins._compact_mixins);
-
-        new_type->fill_call_table();
-
-        // add matching type classes
-        for (auto tc : _type_classes)
+        for (auto tc : type_classes)
         {
-            if (tc && tc->matches(*new_type))
+            if (tc && tc->matches(*new_type, mixin_ids))
             {
-                new_type->_matching_type_classes.emplace_back(tc->id());
+                new_type->_matching_type_classes.add(tc->id());
             }
         }
+    }
+
+    ++_type_use_clock;
+    new_type->_domain = this;
+    new_type->_id = acquire_type_id();
+    new_type->_num_pins.store(1, std::memory_order_relaxed);
+    new_type->_last_use.store(_type_use_clock, std::memory_order_relaxed);
+    new_type->_footprint_in_domain = new_type->memory_footprint();
+    _gc->type_infos_size += new_type->_footprint_in_domain;
+
+    // publish
+    auto ret = new_type.get();
+    _object_type_infos.insert(std::move(new_type));
+
+    auto& gc = *_gc;
+    ++gc.num_created_since_collection;
+    if (gc.num_created_since_collection >= gc.policy.collection_interval && gc.over_limits(_object_type_infos.size()))
+    {
+        collect_type_infos_locked();
+    }
+
+    return ret;
+}
+
+std::unique_ptr<object_type_info> domain::build_object_type_info(mixin_collection mixins, const object_type_info* source) const
+{
+    // use unique_ptr since fill_call_table might throw
+    std::unique_ptr<object_type_info> new_type(new object_type_info);
+    new_type->_mixins = std::move(mixins._mixins);
+
+    // the table only needs to be big enough for the ids of the type's mixins
+    // bigger ids are out of bounds and are treated as missing mixins
+    new_type->_mixin_indices.resize(new_type->_mixins.id_bound());
+
+    uint32_t index = 0;
+    for(auto info : mixins._compact_mixins)
+    {
+        I_DYNAMIX_ASSERT(info);
+        new_type->_mixin_indices.edit(info->id) = index + object_type_info::MIXIN_INDEX_OFFSET;
+        ++index;
+    }
+
+    new_type->_compact_mixins = std::move(mixins._compact_mixins);
+
+    new_type->compute_object_block_layout();
+    new_type->fill_call_table(source);
 
-        auto ret = new_type.get();
-        _object_type_infos.emplace(make_pair(std::move(mixins._mixins), std::move(new_type)));
-        return ret;
+    return new_type;
+}
+
+const object_type_info* domain::find_derivation_source(const mixin_collection& mixins) const
+{
+    if (mixins._compact_mixins.size() < 2)
+    {
+        // the only candidate is the null type, from which there's nothing to derive
+        return nullptr;
+    }
+
+    // most new types are created by adding a mixin to an existing type
+    // so try removing each mixin, starting from the last one
+    auto bits = mixins._mixins;
+    for (auto i = mixins._compact_mixins.rbegin(); i != mixins._compact_mixins.rend(); ++i)
+    {
+        const mixin_id id = (*i)->id;
+        bits.remove(id);
+        if (auto found = _object_type_infos.find(bits))
+        {
+            return found;
+        }
+        bits.add(id);
     }
+
+    return nullptr;
 }
 
 void domain::register_feature(message_t& m)
 {
+    I_DYNAMIX_ASSERT_MSG(_is_default, "messages must be registered in the default domain");
+
     // since messages get registered by registering mixins
     // registration can happen multiple times
     // it the message is registered, we have nothing more to do
@@ -183,59 +452,51 @@ void domain::register_feature(message_t& m)
     // registered within a single domain from different modules
     // crashes may ensue (as a message gets called, for objects that can't actually handle it)
 
-    feature_id free = INVALID_FEATURE_ID;
-
-    // check for message of the same name
-    for(size_t i=0; i<_num_registered_messages; ++i)
+    const size_t registered_id = _message_names.find(m.name);
+    if (registered_id != name_index::npos)
     {
-        if (!_messages[i])
-        {
-            free = i;
-            continue;
-        }
-
-        message_t& registered_message = *_messages[i];
+        I_DYNAMIX_ASSERT(_messages[registered_id]); // how could this happen?
 
-        I_DYNAMIX_ASSERT(registered_message.id != INVALID_FEATURE_ID); // how could this happen?
+        // we need check for private-ness when private is supported
+        // for now this is an error
 
-        if(strcmp(m.name, registered_message.name) == 0)
-        {
-            // we need check for private-ness when private is supported
-            // for now this is an error
-
-            // at least check if the mechanism is the same
-            I_DYNAMIX_ASSERT_MSG(false, "Attempting to register a message that has already been registered");
+        // at least check if the mechanism is the same
+        I_DYNAMIX_ASSERT_MSG(false, "Attempting to register a message that has already been registered");
 
-            // try to resque the situation in some way
-            m.id = registered_message.id;
+        // try to resque the situation in some way
+        m.id = registered_id;
 
-            return;
-        }
+        return;
     }
 
-    if (free == INVALID_FEATURE_ID)
+    if (_free_message_ids.empty())
     {
-        I_DYNAMIX_ASSERT_MSG(_num_registered_messages < DYNAMIX_MAX_MESSAGES,
-            "you have to increase the maximum number of messages");
-
-        m.id = _num_registered_messages;
-        ++_num_registered_messages;
+        m.id = _messages.size();
+        _messages.push_back(&m);
     }
     else
     {
-        m.id = free;
+        m.id = _free_message_ids.back();
+        _free_message_ids.pop_back();
+        _messages[m.id] = &m;
     }
 
-    _messages[m.id] = &m;
+    _message_names.insert(m.name, m.id);
+
+    compile_type_classes();
 }
 
 void domain::unregister_feature(const message_t& msg)
 {
-    I_DYNAMIX_ASSERT_MSG(msg.id < _num_registered_messages, "unregistering a message which isn't registered");
+    I_DYNAMIX_ASSERT_MSG(msg.id < _messages.size(), "unregistering a message which isn't registered");
     I_DYNAMIX_ASSERT_MSG(_messages[msg.id], "unregistering a message which isn't registered");
     I_DYNAMIX_ASSERT_MSG(_messages[msg.id] == &msg, "unregistering a message with know id but unknown data");
 
     _messages[msg.id] = nullptr;
+    _free_message_ids.push_back(msg.id);
+    _message_names.erase(msg.name);
+
+    compile_type_classes();
 
     // to be pedantic we should clear all type infos which have this message,
     // but this seems to be unnecessary
@@ -249,6 +510,8 @@ void domain::unregister_feature(const message_t& msg)
 
 void domain::register_mixin_type(mixin_type_info& info)
 {
+    I_DYNAMIX_ASSERT_MSG(_is_default, "mixins must be registered in the default domain");
+
     // mixin is already registered?
     I_DYNAMIX_ASSERT(info.id == INVALID_MIXIN_ID);
 
@@ -257,38 +520,22 @@ void domain::register_mixin_type(mixin_type_info& info)
     // or provide the name through a feature
     I_DYNAMIX_ASSERT_MSG(info.name, "Mixin name must be provided");
 
-    mixin_id free = INVALID_MIXIN_ID;
-
-    // TODO: optimize this check
-    for (size_t i = 0; i < _num_registered_mixins; ++i)
+    if (_free_mixin_ids.empty())
     {
-        mixin_type_info* registered = _mixin_type_infos[i];
-
-        if (registered)
-        {
-            I_DYNAMIX_ASSERT(registered->is_valid());
-            I_DYNAMIX_ASSERT_MSG(strcmp(info.name, registered->name) != 0, "registering the same mixin twice");
-        }
-        else
-        {
-            free = i;
-        }
-    }
-
-    if (free == INVALID_MIXIN_ID)
-    {
-        // no free slot has been found dugin the iteration, so add a new one
-        I_DYNAMIX_ASSERT_MSG(_num_registered_mixins < DYNAMIX_MAX_MIXINS,
-            "you have to increase the maximum number of mixins");
-
-        info.id = _num_registered_mixins;
-        ++_num_registered_mixins;
+        // no free slots, so add a new one
+        info.id = _mixin_type_infos.size();
+        _mixin_type_infos.push_back(nullptr);
     }
     else
     {
-        info.id = free;
+        info.id = _free_mixin_ids.back();
+        _free_mixin_ids.pop_back();
     }
 
+    const bool unique_name = _mixin_names.insert(info.name, info.id);
+    I_DYNAMIX_ASSERT_MSG(unique_name, "registering the same mixin twice");
+    (void)unique_name; // avoid unused variable warning when asserts are disabled
+
     // also set allocator
     if (!info.allocator)
     {
@@ -296,14 +543,22 @@ void domain::register_mixin_type(mixin_type_info& info)
     }
 
     _mixin_type_infos[info.id] = &info;
+
+    compile_type_classes();
 }
 
 void domain::unregister_mixin_type(const mixin_type_info& info)
 {
-    I_DYNAMIX_ASSERT_MSG(info.id < _num_registered_mixins, "unregistering a mixin which isn't registered");
+    I_DYNAMIX_ASSERT_MSG(info.id < _mixin_type_infos.size(), "unregistering a mixin which isn't registered");
     I_DYNAMIX_ASSERT_MSG(_mixin_type_infos[info.id], "unregistering a mixin which isn't registered");
     I_DYNAMIX_ASSERT_MSG(_mixin_type_infos[info.id] == &info, "unregistering a mixin with known id but unknown data");
 
+    // if a mixin with the same name was registered twice, the name belongs to the other one
+    if (_mixin_names.find(info.name) == info.id)
+    {
+        _mixin_names.erase(info.name);
+    }
+
 #if DYNAMIX_USE_TYPEID && defined(__GNUC__)
     // if the name wasn't overriden by a feature, it has been obtained through
     // cxa_demangle and we must free it
@@ -312,37 +567,54 @@ void domain::unregister_mixin_type(const mixin_type_info& info)
 #endif
 
     _mixin_type_infos[info.id] = nullptr;
+    _free_mixin_ids.push_back(info.id);
+
+    compile_type_classes();
 
     // since this mixin is no longer valid
-    // clean up all object type infos which reference it
+    // clean up all object type infos which reference it in all domains
+    erase_type_infos_with(info);
 
 #if DYNAMIX_THREAD_SAFE_MUTATIONS
-    // TODO C++17: do this with a shared mutex instead
-    std::lock_guard<std::mutex> lock(_object_type_infos_mutex);
+    std::lock_guard<std::mutex> domains_lock(_additional_domains_mutex);
 #endif
 
-    for (auto i = _object_type_infos.begin(); i != _object_type_infos.end(); )
+    for (auto dom : _additional_domains)
     {
-        if (i->first[info.id])
-        {
-            // uh-oh there are still objects alive with this mixin? this is not supported
-            // I wish I could keep this assertion but it keeps firing on abnormal app termination
-            // we do support unregister with living objects if we're terminating
-            // I_DYNAMIX_ASSERT(i->second->num_objects == 0);
-            i = _object_type_infos.erase(i);
-        }
-        else
-        {
-            ++i;
-        }
+        dom->erase_type_infos_with(info);
     }
 }
 
+void domain::erase_type_infos_with(const mixin_type_info& info)
+{
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    std::lock_guard<std::mutex> lock(_object_type_infos_mutex);
+#endif
+
+    ++safe_instance()._type_info_generation;
+
+    auto& gc = *_gc;
+    _object_type_infos.erase_if([&info, &gc](const object_type_info& type)
+    {
+        // uh-oh there are still objects alive with this mixin? this is not supported
+        // I wish I could keep this assertion but it keeps firing on abnormal app termination
+        // we do support unregister with living objects if we're terminating
+        // I_DYNAMIX_ASSERT(type.num_objects == 0);
+        if (!type._mixins.has(info.id)) return false;
+        gc.type_infos_size -= type._footprint_in_domain;
+        return true;
+    });
+
+    clear_type_transitions();
+}
+
 void domain::set_allocator(domain_allocator* allocator)
 {
-    I_DYNAMIX_ASSERT(!_allocator || !_allocator->has_allocated());
+    // the allocator of an additional domain starts as the one of the default domain
+    // which may have already allocated for other objects
+    I_DYNAMIX_ASSERT(!_is_default || !_allocator || !_allocator->has_allocated());
 
-    for(size_t i=0; i<_num_registered_mixins; ++i)
+    for(size_t i=0; i<_mixin_type_infos.size(); ++i)
     {
         mixin_type_info* registered = _mixin_type_infos[i];
 
@@ -361,44 +633,285 @@ void domain::set_allocator(domain_allocator* allocator)
 
 mixin_id domain::get_mixin_id_by_name(const char* mixin_name) const
 {
-    for(size_t i=0; i<_num_registered_mixins; ++i)
+    const size_t id = _mixin_names.find(mixin_name);
+
+    // no mixin of this name found
+    if (id == name_index::npos) return INVALID_MIXIN_ID;
+
+    return mixin_id(id);
+}
+
+const name_index::entry& domain::intern_mixin_name(const char* mixin_name)
+{
+    // names of registered mixins are already interned and don't modify the index
+    if (auto entry = _mixin_names.find_entry(mixin_name)) return *entry;
+    return _mixin_names.intern(mixin_name);
+}
+
+uint32_t domain::acquire_type_id()
+{
+    auto& def = safe_instance();
+
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    std::lock_guard<std::mutex> lock(def._type_ids_mutex);
+#endif
+
+    uint32_t id;
+    if (def._free_type_ids.empty())
     {
-        const mixin_type_info* registered = _mixin_type_infos[i];
+        id = def._num_type_ids++;
+    }
+    else
+    {
+        // reuse the smallest free id, so that the ids stay small
+        auto& free_ids = def._free_type_ids;
+        std::pop_heap(free_ids.begin(), free_ids.end(), std::greater<uint32_t>());
+        id = free_ids.back();
+        free_ids.pop_back();
+    }
 
-        if (!registered) continue;
+    for (auto table : def._type_indexed_tables)
+    {
+        table->reset_slot(id);
+    }
 
-        if(strcmp(mixin_name, registered->name) == 0)
-        {
-            return registered->id;
-        }
+    return id;
+}
+
+void domain::release_type_id(uint32_t id)
+{
+    I_DYNAMIX_ASSERT(id);
+
+    auto& def = safe_instance();
+
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    std::lock_guard<std::mutex> lock(def._type_ids_mutex);
+#endif
+
+    for (auto table : def._type_indexed_tables)
+    {
+        table->reset_slot(id);
     }
 
-    // no mixin of this name found
-    return INVALID_MIXIN_ID;
+    auto& free_ids = def._free_type_ids;
+    free_ids.push_back(id);
+    std::push_heap(free_ids.begin(), free_ids.end(), std::greater<uint32_t>());
+}
+
+type_indexed_table_base::~type_indexed_table_base() = default;
+
+void type_indexed_table_base::attach()
+{
+    auto& def = domain::safe_instance();
+
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    std::lock_guard<std::mutex> lock(def._type_ids_mutex);
+#endif
+
+    reserve_slots(def._num_type_ids);
+    def._type_indexed_tables.push_back(this);
+}
+
+void type_indexed_table_base::detach()
+{
+    auto& def = domain::safe_instance();
+
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    std::lock_guard<std::mutex> lock(def._type_ids_mutex);
+#endif
+
+    auto& tables = def._type_indexed_tables;
+    tables.erase(std::find(tables.begin(), tables.end(), this));
+}
+
+void domain::get_object_type_infos(std::vector<const object_type_info*>& out_type_infos)
+{
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    std::lock_guard<std::mutex> lock(_object_type_infos_mutex);
+#endif
+
+    _object_type_infos.for_each([&out_type_infos](const object_type_info& type)
+    {
+        out_type_infos.push_back(&type);
+    });
 }
 
 void domain::garbage_collect_type_infos()
 {
-    for (auto i = _object_type_infos.begin(); i != _object_type_infos.end(); )
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    std::lock_guard<std::mutex> lock(_object_type_infos_mutex);
+#endif
+
+    ++safe_instance()._type_info_generation;
+
+    auto& gc = *_gc;
+    ++gc.stats.num_collections;
+    _object_type_infos.erase_if([&gc](const object_type_info& type)
+    {
+        // type infos of living mutators and templates are kept
+        if (type.num_objects != 0 || type._num_pins.load(std::memory_order_relaxed) != 0) return false;
+        gc.type_infos_size -= type._footprint_in_domain;
+        ++gc.stats.num_collected;
+        gc.stats.collected_size += type._footprint_in_domain;
+        return true;
+    });
+
+    // nothing runs concurrently, so the pending ones can be destroyed too
+    gc.stats.num_pending = 0;
+    gc_state::destroy(gc.retired);
+    gc_state::destroy(gc.retiring);
+
+    clear_type_transitions();
+}
+
+void domain::collect_type_infos()
+{
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    std::lock_guard<std::mutex> lock(_object_type_infos_mutex);
+#endif
+
+    collect_type_infos_locked();
+}
+
+void domain::collect_type_infos_locked()
+{
+    auto& gc = *_gc;
+    ++gc.stats.num_collections;
+    gc.num_created_since_collection = 0;
+
+    gc.destroy_retired_if_unused();
+
+    // the candidates are checked again when they are marked as collected
+    std::vector<const object_type_info*> candidates;
+    _object_type_infos.for_each([&candidates](const object_type_info& type)
     {
-        if (i->second->num_objects == 0)
+        if (type.num_objects == 0 && type._num_pins.load(std::memory_order_relaxed) == 0)
         {
-            i = _object_type_infos.erase(i);
+            candidates.push_back(&type);
         }
-        else
+    });
+
+    const size_t num_retained = gc.policy.num_retained_unused;
+    size_t num_collected = 0;
+    if (candidates.size() > num_retained)
+    {
+        // least recently used first
+        std::sort(candidates.begin(), candidates.end(), [](const object_type_info* a, const object_type_info* b)
         {
-            ++i;
+            return a->_last_use.load(std::memory_order_relaxed) < b->_last_use.load(std::memory_order_relaxed);
+        });
+        candidates.resize(std::min(candidates.size() - num_retained, gc.policy.max_collected_per_pass));
+
+        for (auto type : candidates)
+        {
+            if (!type->try_mark_collected()) continue;
+
+            // concurrent lookups may still be reading it
+            _object_type_infos.unlink(type);
+            gc.retiring.type_infos.push_back(type);
+
+            gc.type_infos_size -= type->_footprint_in_domain;
+            ++gc.stats.num_collected;
+            ++gc.stats.num_pending;
+            gc.stats.collected_size += type->_footprint_in_domain;
+            ++num_collected;
         }
     }
+
+    if (num_collected)
+    {
+        ++safe_instance()._type_info_generation;
+
+        // the remaining type infos may have transitions to the collected ones
+        // mutations may be reading them, so they're destroyed along with the type infos
+        auto detach = [&gc](const object_type_info& type)
+        {
+            if (auto t = type.detach_transitions())
+            {
+                gc.retiring.transitions.push_back(t);
+            }
+        };
+        _object_type_infos.for_each(detach);
+
+        // the null type is shared, but only the default domain memoizes its transitions
+        if (_is_default) detach(object_type_info::null());
+    }
+
+    gc.advance_epoch();
+
+    // nothing may be reading them if there are no concurrent mutations
+    gc.destroy_retired_if_unused();
 }
 
-void domain::register_type_class(type_class& t)
+void domain::set_gc_policy(const type_info_gc_policy& policy)
 {
 #if DYNAMIX_THREAD_SAFE_MUTATIONS
-    // lock since registering new types reads the _type_classes array
     std::lock_guard<std::mutex> lock(_object_type_infos_mutex);
 #endif
 
+    _gc->policy = policy;
+}
+
+type_info_gc_stats domain::gc_stats()
+{
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    std::lock_guard<std::mutex> lock(_object_type_infos_mutex);
+#endif
+
+    auto stats = _gc->stats;
+    stats.num_type_infos = _object_type_infos.size();
+    stats.type_infos_size = _gc->type_infos_size;
+    return stats;
+}
+
+void domain::clear_type_transitions()
+{
+    // the remaining type infos may have transitions to the destroyed ones
+    _object_type_infos.for_each([](const object_type_info& type)
+    {
+        type.clear_transitions();
+    });
+
+    // the null type is shared, but only the default domain memoizes its transitions
+    if (_is_default) object_type_info::null().clear_transitions();
+}
+
+// registering type classes locks the type infos of all domains
+// since they're matched with the type classes when created
+class domain::all_type_infos_lock
+{
+public:
+    explicit all_type_infos_lock(domain& def)
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+        : _domains_lock(def._additional_domains_mutex)
+        , _default_lock(def._object_type_infos_mutex)
+#endif
+    {
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+        _locks.reserve(def._additional_domains.size());
+        for (auto dom : def._additional_domains)
+        {
+            _locks.emplace_back(dom->_object_type_infos_mutex);
+        }
+#else
+        (void)def;
+#endif
+    }
+
+private:
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    std::lock_guard<std::mutex> _domains_lock;
+    std::lock_guard<std::mutex> _default_lock;
+    std::vector<std::unique_lock<std::mutex>> _locks;
+#endif
+};
+
+void domain::register_type_class(type_class& t)
+{
+    I_DYNAMIX_ASSERT_MSG(_is_default, "type classes must be registered in the default domain");
+
+    all_type_infos_lock lock(*this);
+
     type_class_id free = 0;
     for (auto r : _type_classes)
     {
@@ -413,24 +926,34 @@ void domain::register_type_class(type_class& t)
 
     t._id = free;
     _type_classes[free] = &t;
+    t.compile();
 
 #if DYNAMIX_DEBUG
     // make a check
     // we don't support registering a type class which matches existing type infos
-    for (const auto& ti : _object_type_infos)
+    auto check = [&t](const object_type_info& info)
+    {
+        I_DYNAMIX_ASSERT_MSG(!t.matches(info), "registering a type class which matches existing type infos");
+    };
+    _object_type_infos.for_each(check);
+    for (auto dom : _additional_domains)
     {
-        auto& info = ti.second;
-        I_DYNAMIX_ASSERT_MSG(!t.matches(*info), "registering a type class which matches existing type infos");
+        dom->_object_type_infos.for_each(check);
     }
 #endif
 }
 
+void domain::compile_type_classes()
+{
+    for (auto tc : _type_classes)
+    {
+        if (tc) tc->compile();
+    }
+}
+
 void domain::unregister_type_class(const type_class& t)
 {
-#if DYNAMIX_THREAD_SAFE_MUTATIONS
-    // lock since registering new types reads the _type_classes array
-    std::lock_guard<std::mutex> lock(_object_type_infos_mutex);
-#endif
+    all_type_infos_lock lock(*this);
 
     I_DYNAMIX_ASSERT_MSG(t.id() < _type_classes.size(), "unregistering a type class which isn't registered");
     I_DYNAMIX_ASSERT_MSG(_type_classes[t.id()], "unregistering a type class which isn't registered");
@@ -445,7 +968,6 @@ void domain::unregister_type_class(const type_class& t)
     // for now to nothing and hope for the best
 }
 
-
 } // namespace internal
 
 mutation_rule_id add_new_mutation_rule(mutation_rule* rule)
@@ -474,4 +996,23 @@ void set_global_allocator(domain_allocator* allocator)
     internal::domain::safe_instance().set_allocator(allocator);
 }
 
+void set_type_info_gc_policy(const type_info_gc_policy& policy)
+{
+    internal::domain::safe_instance().set_gc_policy(policy);
+}
+
+type_info_gc_stats get_type_info_gc_stats()
+{
+    return internal::domain::safe_instance().gc_stats();
+}
+
+void collect_type_infos()
+{
+    internal::domain::safe_instance().collect_type_infos();
+}
+
+mixin_name_handle::mixin_name_handle(const char* name)
+    : _entry(&internal::domain::safe_instance().intern_mixin_name(name))
+{}
+
 } // namespace dynamix
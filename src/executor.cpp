@@ -0,0 +1,239 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "internal.hpp"
+#include "dynamix/executor.hpp"
+#include "dynamix/internal/assert.hpp"
+
+namespace dynamix
+{
+
+namespace
+{
+uint64_t pack_range(uint64_t begin, uint64_t end)
+{
+    return begin | (end << 32);
+}
+
+uint64_t range_begin(uint64_t range)
+{
+    return range & 0xFFFFFFFF;
+}
+
+uint64_t range_end(uint64_t range)
+{
+    return range >> 32;
+}
+}
+
+work_stealing_executor::work_stealing_executor(size_t num_threads)
+{
+    if (!num_threads)
+    {
+        num_threads = std::thread::hardware_concurrency();
+    }
+
+    if (!num_threads)
+    {
+        // hardware concurrency is unknown
+        num_threads = 1;
+    }
+
+    _num_queues = num_threads;
+    _queues.reset(new task_queue[_num_queues]);
+    for (size_t i = 0; i < _num_queues; ++i)
+    {
+        _queues[i].range = 0;
+    }
+
+    // queue 0 is for the thread which calls run
+    _threads.reserve(_num_queues - 1);
+    for (size_t i = 1; i < _num_queues; ++i)
+    {
+        _threads.emplace_back(&work_stealing_executor::thread_func, this, i);
+    }
+}
+
+work_stealing_executor::~work_stealing_executor()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _work_cv.notify_all();
+
+    for (auto& t : _threads)
+    {
+        t.join();
+    }
+}
+
+size_t work_stealing_executor::concurrency() const
+{
+    return _num_queues;
+}
+
+void work_stealing_executor::run(size_t num_tasks, const std::function<void(size_t)>& task)
+{
+    if (!num_tasks) return;
+
+    I_DYNAMIX_ASSERT_MSG(num_tasks < 0xFFFFFFFF, "too many tasks in a batch");
+
+    std::lock_guard<std::mutex> run_lock(_run_mutex);
+
+    // split the tasks evenly between the queues
+    for (size_t i = 0; i < _num_queues; ++i)
+    {
+        const uint64_t begin = uint64_t(num_tasks) * i / _num_queues;
+        const uint64_t end = uint64_t(num_tasks) * (i + 1) / _num_queues;
+        _queues[i].range = pack_range(begin, end);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _task = &task;
+        _num_working = _threads.size();
+        ++_batch;
+    }
+    _work_cv.notify_all();
+
+    work(0);
+
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done_cv.wait(lock, [this]() { return _num_working == 0; });
+        _task = nullptr;
+    }
+
+#if DYNAMIX_USE_EXCEPTIONS
+    if (_error)
+    {
+        std::exception_ptr error;
+        std::swap(error, _error);
+        std::rethrow_exception(error);
+    }
+#endif
+}
+
+bool work_stealing_executor::pop_task(size_t queue, size_t& out_task)
+{
+    auto& range = _queues[queue].range;
+    uint64_t r = range.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        const uint64_t begin = range_begin(r);
+        const uint64_t end = range_end(r);
+        if (begin >= end) return false;
+
+        if (range.compare_exchange_weak(r, pack_range(begin + 1, end), std::memory_order_relaxed))
+        {
+            out_task = size_t(begin);
+            return true;
+        }
+    }
+}
+
+bool work_stealing_executor::steal_task(size_t queue, size_t& out_task)
+{
+    // look for work in the other queues starting with the next one,
+    // so that the thieves don't all go for the same queue
+    for (size_t i = 1; i < _num_queues; ++i)
+    {
+        auto& range = _queues[(queue + i) % _num_queues].range;
+        uint64_t r = range.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            const uint64_t begin = range_begin(r);
+            const uint64_t end = range_end(r);
+            if (begin >= end) break;
+
+            // steal the back half (rounded up)
+            const uint64_t stolen_begin = end - (end - begin + 1) / 2;
+            if (range.compare_exchange_weak(r, pack_range(begin, stolen_begin), std::memory_order_relaxed))
+            {
+                // take the first stolen task and put the rest in our queue
+                // our queue is empty, so no one else is changing it
+                // (thieves will see the new tasks with their next load)
+                out_task = size_t(stolen_begin);
+                _queues[queue].range.store(pack_range(stolen_begin + 1, end), std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void work_stealing_executor::run_task(size_t task)
+{
+#if DYNAMIX_USE_EXCEPTIONS
+    try
+    {
+        (*_task)(task);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_error)
+        {
+            _error = std::current_exception();
+        }
+    }
+#else
+    (*_task)(task);
+#endif
+}
+
+void work_stealing_executor::work(size_t queue)
+{
+    size_t task;
+    for (;;)
+    {
+        while (pop_task(queue, task))
+        {
+            run_task(task);
+        }
+
+        if (!steal_task(queue, task))
+        {
+            // all queues are empty
+            // tasks which are being run by other threads are their concern
+            return;
+        }
+
+        run_task(task);
+    }
+}
+
+void work_stealing_executor::thread_func(size_t queue)
+{
+    uint64_t batch = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _work_cv.wait(lock, [&]() { return _stop || _batch != batch; });
+            if (_stop) return;
+            batch = _batch;
+        }
+
+        work(queue);
+
+        bool done;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            done = --_num_working == 0;
+        }
+
+        if (done)
+        {
+            _done_cv.notify_one();
+        }
+    }
+}
+
+} // namespace dynamix
@@ -22,13 +22,13 @@ mixin_collection::~mixin_collection() = default;
 
 namespace
 {
-available_mixins_bitset build_available_mixins_from(const mixin_type_info_vector& mixins)
+mixin_set build_available_mixins_from(const mixin_type_info_vector& mixins)
 {
-    available_mixins_bitset result;
+    mixin_set result;
 
     for (const mixin_type_info* mixin_info : mixins)
     {
-        result[mixin_info->id] = true;
+        result.add(mixin_info->id);
     }
 
     return result;
@@ -43,8 +43,7 @@ mixin_collection::mixin_collection(const mixin_type_info_vector& mixins)
 
 void mixin_collection::add(const mixin_type_info& info)
 {
-    if (has(info)) return; // we already have this
-    _mixins[info.id] = true;
+    if (!_mixins.add(info.id)) return; // we already have this
     _compact_mixins.push_back(&info);
 }
 
@@ -56,7 +55,7 @@ void mixin_collection::add(mixin_id id)
 
 bool mixin_collection::remove(const mixin_type_info& info)
 {
-    if (!has(info)) return false;
+    if (!_mixins.remove(info.id)) return false;
     auto i = std::find(_compact_mixins.begin(), _compact_mixins.end(), &info);
     I_DYNAMIX_ASSERT(i != _compact_mixins.end());
     _compact_mixins.erase(i);
@@ -71,17 +70,18 @@ bool mixin_collection::remove(mixin_id id)
 
 void mixin_collection::rebuild_from_compact_mixins()
 {
-    _mixins.reset();
+    // reuse the memory of the set
+    _mixins.clear();
     for (const mixin_type_info* info : _compact_mixins)
     {
-        _mixins[info->id] = true;
+        _mixins.add(info->id);
     }
 }
 
 void mixin_collection::clear()
 {
     _compact_mixins.clear();
-    _mixins.reset();
+    _mixins.clear();
 }
 
 } // namespace dynamix
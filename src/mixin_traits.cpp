@@ -11,6 +11,7 @@
 #if DYNAMIX_USE_TYPEID && defined(__GNUC__)
 #   include <cstdlib>
 #   include <cxxabi.h>
+#   include <cstring>
 static int cxa_demangle_status;
 #endif
 
@@ -19,10 +20,27 @@ namespace dynamix
 namespace internal
 {
 #if DYNAMIX_USE_TYPEID // using typeid: tested for msvc, gcc and clang
-const char* get_mixin_name_from_typeid(const char* typeid_name)
+const char* get_mixin_name_from_typeid(const char* typeid_name, bool& out_owns_name)
 {
+    out_owns_name = false;
 #if defined(__GNUC__) // __GNUC__ is defined with clang
+    // the mangled name of a class in the global namespace which is not a template
+    // is its length followed by its name, so it can be read without demangling
+    // this is the case for most mixins and avoids the demangler and its allocation at startup
+    if (*typeid_name >= '1' && *typeid_name <= '9')
+    {
+        const char* name = typeid_name;
+        size_t length = 0;
+        while (*name >= '0' && *name <= '9')
+        {
+            length = length * 10 + size_t(*name - '0');
+            ++name;
+        }
+        if (strlen(name) == length) return name;
+    }
+
     // use cxxabi to unmangle the gcc typeid name
+    out_owns_name = true;
     return abi::__cxa_demangle(typeid_name, nullptr, nullptr, &cxa_demangle_status);
 #elif defined(_MSC_VER)
     // msvc typeid names are "class x" or "struct x" instead of "x",
@@ -0,0 +1,91 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "internal.hpp"
+#include "dynamix/internal/name_index.hpp"
+#include "dynamix/internal/assert.hpp"
+
+#include <cstring>
+#include <cstdint>
+
+namespace dynamix
+{
+namespace internal
+{
+
+constexpr size_t name_index::npos;
+
+size_t name_index::name_hash::operator()(const char* name) const
+{
+    // fnv-1a
+    uint64_t h = 14695981039346656037ULL;
+    for (; *name; ++name)
+    {
+        h ^= uint64_t(uint8_t(*name));
+        h *= 1099511628211ULL;
+    }
+    return size_t(h);
+}
+
+bool name_index::name_equal::operator()(const char* a, const char* b) const
+{
+    return strcmp(a, b) == 0;
+}
+
+name_index::name_index() = default;
+name_index::~name_index() = default;
+
+size_t name_index::find(const char* name) const
+{
+    auto it = _ids.find(name);
+    if (it == _ids.end()) return npos;
+    return it->second;
+}
+
+bool name_index::insert(const char* name, size_t id)
+{
+    I_DYNAMIX_ASSERT(id != npos);
+    auto it = intern_entry(name);
+    if (it->second != npos) return false;
+    it->second = id;
+    return true;
+}
+
+void name_index::erase(const char* name)
+{
+    auto it = _ids.find(name);
+    if (it == _ids.end()) return;
+    it->second = npos;
+}
+
+const name_index::entry& name_index::intern(const char* name)
+{
+    return *intern_entry(name);
+}
+
+const name_index::entry* name_index::find_entry(const char* name) const
+{
+    auto it = _ids.find(name);
+    if (it == _ids.end()) return nullptr;
+    return &*it;
+}
+
+name_index::map::iterator name_index::intern_entry(const char* name)
+{
+    auto it = _ids.find(name);
+    if (it != _ids.end()) return it;
+
+    const size_t length = strlen(name);
+    std::unique_ptr<char[]> copy(new char[length + 1]);
+    memcpy(copy.get(), name, length + 1);
+    _interned_names.emplace_back(std::move(copy));
+
+    return _ids.emplace(_interned_names.back().get(), npos).first;
+}
+
+} // namespace internal
+} // namespace dynamix
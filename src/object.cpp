@@ -48,9 +48,16 @@ object::object(object_allocator* allocator)
 object::object(const object_type_template& type, object_allocator* allocator /*= nullptr*/)
     : object(allocator)
 {
+    _domain = type.bound_domain().is_default() ? nullptr : &type.bound_domain();
     type.apply_to(*this);
 }
 
+object::object(domain& dom, object_allocator* allocator /*= nullptr*/)
+    : object(allocator)
+{
+    _domain = dom.is_default() ? nullptr : &dom;
+}
+
 object::~object()
 {
     clear();
@@ -123,8 +130,9 @@ void object::clear() noexcept
 
     if (_mixin_data != &null_mixin_data)
     {
-        _type_info->dealloc_mixin_data(_mixin_data, this);
+        free_mixin_data(_type_info, _mixin_data, _block_size, uses_inline_buffer());
         _mixin_data = &null_mixin_data;
+        _block_size = 0;
 
         I_DYNAMIX_ASSERT(_type_info->num_objects > 0);
         --_type_info->num_objects;
@@ -138,38 +146,151 @@ bool object::empty() const noexcept
     return _type_info == &object_type_info::null();
 }
 
+domain& object::bound_domain() const
+{
+    return _domain ? *_domain : domain::safe_instance();
+}
+
+mixin_allocator* object::mixin_allocator_for(const mixin_type_info& mixin_info) const
+{
+    if (_allocator) return _allocator;
+
+    // the mixins which don't have an allocator of their own have the one of the default domain
+    // in other domains it's replaced with theirs
+    if (_domain && mixin_info.allocator == domain::instance().allocator()) return _domain->allocator();
+
+    return mixin_info.allocator;
+}
+
 void object::change_type(const object_type_info* new_type)
 {
     change_type_from(new_type, nullptr);
 }
 
+// checks whether a buffer is within an object block
+static bool in_block(const char* buffer, const mixin_data_in_object* block, size_t block_size)
+{
+    const char* begin = reinterpret_cast<const char*>(block);
+    return buffer >= begin && buffer < begin + block_size;
+}
+
+bool object::in_object_block(const char* buffer) const
+{
+    return in_block(buffer, _mixin_data, _block_size);
+}
+
+bool object::uses_inline_buffer() const
+{
+#if DYNAMIX_OBJECT_INLINE_BUFFER_SIZE > 0
+    return reinterpret_cast<const char*>(_mixin_data) == _inline_buffer;
+#else
+    return false;
+#endif
+}
+
+#if DYNAMIX_OBJECT_INLINE_BUFFER_SIZE > 0
+void object::move_inline_buffer(char* dest)
+{
+    I_DYNAMIX_ASSERT(uses_inline_buffer());
+
+    const size_t num_mixin_datas = _type_info->_compact_mixins.size() + object_type_info::MIXIN_INDEX_OFFSET;
+    mixin_data_in_object* dest_data = new (dest) mixin_data_in_object[num_mixin_datas];
+    for (size_t i = 0; i < num_mixin_datas; ++i)
+    {
+        dest_data[i] = _mixin_data[i];
+    }
+
+    for (const mixin_type_info* mixin_info : _type_info->_compact_mixins)
+    {
+        auto& data = dest_data[_type_info->mixin_index(mixin_info->id)];
+        if (!in_object_block(data.buffer())) continue;
+
+        // the mixin has the same place in the destination
+        void* source_mixin = data.mixin();
+        const size_t mixin_offset = data.mixin_offset();
+        data.set_buffer(dest + (data.buffer() - _inline_buffer), mixin_offset);
+        data.set_object(this);
+
+        I_DYNAMIX_ASSERT(mixin_info->move_constructor); // only movable mixins are placed in the buffer
+        mixin_info->move_constructor(data.mixin(), source_mixin);
+        mixin_allocator_for(*mixin_info)->destroy_mixin(*mixin_info, source_mixin);
+    }
+
+    _mixin_data = dest_data;
+}
+#endif
+
+void object::free_mixin_data(const object_type_info* type, mixin_data_in_object* data, size_t block_size, bool in_inline_buffer)
+{
+    if (data == &null_mixin_data || in_inline_buffer) return;
+
+    if (block_size)
+    {
+        type->dealloc_object_block(data, this);
+    }
+    else
+    {
+        type->dealloc_mixin_data(data, this);
+    }
+}
+
 object::change_type_from_result object::change_type_from(const object_type_info* new_type, const internal::mixin_data_in_object* source)
 {
     auto res = change_type_from_result::success;
     const object_type_info* old_type = _type_info;
+    const bool old_inline = uses_inline_buffer();
+
+    mixin_data_in_object* new_mixin_data = nullptr;
+    size_t new_block_size = 0;
+
+#if DYNAMIX_OBJECT_INLINE_BUFFER_SIZE > 0
+    // the inline buffer is preferred if the mixin data and all mixins which can be placed in a block fit in it
+    // otherwise an allocated block is preferred, if the allocator provides one
+    // and if it doesn't, the mixin data and the mixins which fit are placed in the buffer
+    const size_t inline_size = DYNAMIX_OBJECT_INLINE_BUFFER_SIZE;
+    const size_t mixin_data_size = (new_type->_compact_mixins.size() + object_type_info::MIXIN_INDEX_OFFSET) * sizeof(mixin_data_in_object);
+    const bool inline_data = !_allocator && mixin_data_size <= inline_size;
+    const bool inline_all = inline_data && new_type->object_block_size() <= inline_size;
+
+    // the contents of the inline buffer are moved here if the new type needs it
+    alignas(std::max_align_t) char evacuated[inline_size];
+#else
+    const bool inline_all = false;
+#endif
+
+    if (!inline_all)
+    {
+        new_mixin_data = new_type->alloc_object_block(this);
+        if (new_mixin_data) new_block_size = new_type->object_block_size();
+    }
+
+#if DYNAMIX_OBJECT_INLINE_BUFFER_SIZE > 0
+    if (!new_mixin_data && inline_data)
+    {
+        if (old_inline)
+        {
+            move_inline_buffer(evacuated);
+        }
+
+        new_mixin_data = new (_inline_buffer) mixin_data_in_object[mixin_data_size / sizeof(mixin_data_in_object)];
+        new_block_size = inline_size;
+    }
+#endif
+
+    if (!new_mixin_data)
+    {
+        new_mixin_data = new_type->alloc_mixin_data(this);
+    }
+
     mixin_data_in_object* old_mixin_data = _mixin_data;
-    mixin_data_in_object* new_mixin_data = new_type->alloc_mixin_data(this);
+    const size_t old_block_size = _block_size;
 
     for (const mixin_type_info* mixin_info : old_type->_compact_mixins)
     {
         mixin_id id = mixin_info->id;
         if (new_type->has(id))
         {
-            auto new_index = new_type->mixin_index(id);
-            auto& data = new_mixin_data[new_index];
-            data = old_mixin_data[old_type->mixin_index(id)];
-
-            if (source)
-            {
-                if (!mixin_info->copy_assignment)
-                {
-                    res = change_type_from_result::bad_assign;
-                }
-                else
-                {
-                    mixin_info->copy_assignment(data.mixin(), source[new_index].mixin());
-                }
-            }
+            new_mixin_data[new_type->mixin_index(id)] = old_mixin_data[old_type->mixin_index(id)];
         }
         else
         {
@@ -177,11 +298,50 @@ object::change_type_from_result object::change_type_from(const object_type_info*
         }
     }
 
-    if (old_mixin_data != &null_mixin_data)
+    _type_info = new_type;
+    _mixin_data = new_mixin_data;
+    _block_size = new_block_size;
+
+    if (old_block_size)
     {
-        old_type->dealloc_mixin_data(old_mixin_data, this);
+        // the remaining mixins which are in the old block are moved to their new place
+        for (const mixin_type_info* mixin_info : new_type->_compact_mixins)
+        {
+            auto& data = new_mixin_data[new_type->mixin_index(mixin_info->id)];
+            if (!data.buffer() || !in_block(data.buffer(), old_mixin_data, old_block_size)) continue;
+
+            auto old_data = data;
+            data.clear();
+            mixin_allocator* alloc = alloc_mixin_buffer(*mixin_info, data);
+
+            I_DYNAMIX_ASSERT(mixin_info->move_constructor); // only movable mixins are placed in blocks
+            mixin_info->move_constructor(data.mixin(), old_data.mixin());
+            alloc->destroy_mixin(*mixin_info, old_data.mixin());
+        }
+    }
+
+    if (source)
+    {
+        // the kept mixins are assigned in their new place, since moving them
+        // might use a copy constructor which doesn't preserve the assigned values
+        for (const mixin_type_info* mixin_info : old_type->_compact_mixins)
+        {
+            if (!new_type->has(mixin_info->id)) continue;
+
+            auto new_index = new_type->mixin_index(mixin_info->id);
+            if (!mixin_info->copy_assignment)
+            {
+                res = change_type_from_result::bad_assign;
+            }
+            else
+            {
+                mixin_info->copy_assignment(new_mixin_data[new_index].mixin(), source[new_index].mixin());
+            }
+        }
     }
 
+    free_mixin_data(old_type, old_mixin_data, old_block_size, old_inline);
+
     if (old_type != &object_type_info::null())
     {
         I_DYNAMIX_ASSERT(old_type->num_objects > 0);
@@ -192,9 +352,6 @@ object::change_type_from_result object::change_type_from(const object_type_info*
         ++new_type->num_objects;
     }
 
-    _type_info = new_type;
-    _mixin_data = new_mixin_data;
-
     for (const mixin_type_info* mixin_info : new_type->_compact_mixins)
     {
         size_t index = new_type->mixin_index(mixin_info->id);
@@ -225,16 +382,7 @@ bool object::make_mixin(const mixin_type_info& mixin_info, const void* source)
     mixin_data_in_object& data = _mixin_data[_type_info->mixin_index(mixin_info.id)];
     I_DYNAMIX_ASSERT(!data.buffer());
 
-    mixin_allocator* alloc = _allocator ? _allocator : mixin_info.allocator;
-    char* buffer;
-    size_t mixin_offset;
-    std::tie(buffer, mixin_offset) = alloc->alloc_mixin(mixin_info, this);
-
-    I_DYNAMIX_ASSERT(buffer);
-    I_DYNAMIX_ASSERT(mixin_offset >= sizeof(object*)); // we should have room for an object pointer
-
-    data.set_buffer(buffer, mixin_offset);
-    data.set_object(this);
+    mixin_allocator* alloc = alloc_mixin_buffer(mixin_info, data);
 
     ++mixin_info.num_mixins;
 
@@ -266,12 +414,16 @@ void object::delete_mixin(const mixin_type_info& mixin_info)
     I_DYNAMIX_ASSERT(_type_info->has(mixin_info.id));
     mixin_data_in_object& data = _mixin_data[_type_info->mixin_index(mixin_info.id)];
 
-    mixin_allocator* alloc = _allocator ? _allocator : mixin_info.allocator;
+    mixin_allocator* alloc = mixin_allocator_for(mixin_info);
 
     alloc->destroy_mixin(mixin_info, data.mixin());
 
     // dealocate mixin
-    alloc->dealloc_mixin(data.buffer(), data.mixin_offset(), mixin_info, this);
+    // the mixins in the object block are deallocated with it
+    if (!in_object_block(data.buffer()))
+    {
+        alloc->dealloc_mixin(data.buffer(), data.mixin_offset(), mixin_info, this);
+    }
 
     I_DYNAMIX_ASSERT(mixin_info.num_mixins > 0);
     --mixin_info.num_mixins;
@@ -279,6 +431,43 @@ void object::delete_mixin(const mixin_type_info& mixin_info)
     data.clear();
 }
 
+mixin_allocator* object::alloc_mixin_buffer(const mixin_type_info& mixin_info, mixin_data_in_object& data)
+{
+    mixin_allocator* alloc = mixin_allocator_for(mixin_info);
+
+    // the mixins which are allocated with the allocator of the block are placed in it
+    // if they have a place within its size (the others are allocated separately)
+    uint32_t block_pos = 0;
+    if (_block_size)
+    {
+        const mixin_allocator* block_alloc = _allocator ? static_cast<const mixin_allocator*>(_allocator) : bound_domain().allocator();
+        if (alloc == block_alloc)
+        {
+            block_pos = _type_info->object_block_mixin_position(_type_info->mixin_index(mixin_info.id));
+            if (block_pos + mixin_info.size > _block_size) block_pos = 0;
+        }
+    }
+
+    if (block_pos)
+    {
+        data.set_buffer(reinterpret_cast<char*>(_mixin_data) + block_pos - sizeof(object*), sizeof(object*));
+    }
+    else
+    {
+        char* buffer;
+        size_t mixin_offset;
+        std::tie(buffer, mixin_offset) = alloc->alloc_mixin(mixin_info, this);
+
+        I_DYNAMIX_ASSERT(buffer);
+        I_DYNAMIX_ASSERT(mixin_offset >= sizeof(object*)); // we should have room for an object pointer
+
+        data.set_buffer(buffer, mixin_offset);
+    }
+
+    data.set_object(this);
+    return alloc;
+}
+
 bool object::internal_implements(feature_id id, const internal::message_feature_tag&) const
 {
     return _type_info->implements_message(id);
@@ -286,7 +475,6 @@ bool object::internal_implements(feature_id id, const internal::message_feature_
 
 bool object::has(mixin_id id) const noexcept
 {
-    if (id >= DYNAMIX_MAX_MIXINS) return false;
     return internal_has_mixin(id);
 }
 
@@ -298,13 +486,11 @@ bool object::has(const char* mixin_name) const noexcept
 
 void* object::get(mixin_id id) noexcept
 {
-    if (id >= DYNAMIX_MAX_MIXINS) return nullptr;
     return internal_get_mixin(id);
 }
 
 const void* object::get(mixin_id id) const noexcept
 {
-    if (id >= DYNAMIX_MAX_MIXINS) return nullptr;
     return internal_get_mixin(id);
 }
 
@@ -338,8 +524,19 @@ void object::usurp(object&& o) noexcept
         o._allocator = nullptr;
     }
 
+    // the type info belongs to the domain of the other object
+    _domain = o._domain;
+#if DYNAMIX_OBJECT_INLINE_BUFFER_SIZE > 0
+    if (o.uses_inline_buffer())
+    {
+        // the mixins in the inline buffer are moved with the object
+        o.move_inline_buffer(_inline_buffer);
+    }
+#endif
+
     _type_info = o._type_info;
     _mixin_data = o._mixin_data;
+    _block_size = o._block_size;
 
     for (size_t i = object_type_info::MIXIN_INDEX_OFFSET;
          i < _type_info->_compact_mixins.size() + object_type_info::MIXIN_INDEX_OFFSET; ++i)
@@ -357,6 +554,7 @@ void object::usurp(object&& o) noexcept
     // clear other object
     o._type_info = &object_type_info::null();
     o._mixin_data = &null_mixin_data;
+    o._block_size = 0;
 }
 
 void object::copy_from(const object& o)
@@ -389,6 +587,13 @@ void object::copy_from(const object& o)
         return;
     }
 
+    // we get the type of the other object, which belongs to its domain
+    if (o._domain != _domain)
+    {
+        clear();
+        _domain = o._domain;
+    }
+
     if (o._type_info == _type_info)
     {
         copy_matching_from(o);
@@ -447,8 +652,6 @@ void object::move_matching_from(object& o)
 
 std::pair<char*, size_t> object::move_mixin(mixin_id id, char* buffer, size_t mixin_offset)
 {
-    if (id >= DYNAMIX_MAX_MIXINS) return std::pair<char*, size_t>(nullptr, 0);
-
     auto& data = _mixin_data[_type_info->mixin_index(id)];
     if (!data.mixin()) return std::pair<char*, size_t>(nullptr, 0);
 
@@ -468,7 +671,6 @@ std::pair<char*, size_t> object::move_mixin(mixin_id id, char* buffer, size_t mi
 
 std::pair<char*, size_t> object::hard_replace_mixin(mixin_id id, char* buffer, size_t mixin_offset) noexcept
 {
-    I_DYNAMIX_ASSERT(id < DYNAMIX_MAX_MIXINS);
     auto& data = _mixin_data[_type_info->mixin_index(id)];
     I_DYNAMIX_ASSERT(data.mixin());
 
@@ -492,7 +694,7 @@ void object::reallocate_mixins()
         auto old_data = data;
         I_DYNAMIX_ASSERT(data.buffer());
 
-        mixin_allocator* alloc = _allocator ? _allocator : mixin_info->allocator;
+        mixin_allocator* alloc = mixin_allocator_for(*mixin_info);
 
         auto new_buf = alloc->alloc_mixin(*mixin_info, this);
 
@@ -501,7 +703,10 @@ void object::reallocate_mixins()
 
         mixin_info->move_constructor(data.mixin(), old_data.mixin());
 
-        alloc->dealloc_mixin(old_data.buffer(), old_data.mixin_offset(), *mixin_info, this);
+        if (!in_object_block(old_data.buffer()))
+        {
+            alloc->dealloc_mixin(old_data.buffer(), old_data.mixin_offset(), *mixin_info, this);
+        }
     }
 }
 
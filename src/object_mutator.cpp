@@ -25,10 +25,34 @@ object_mutator::object_mutator(const mixin_collection* source_mixins)
     : _source_mixins(source_mixins)
 {}
 
+object_mutator::~object_mutator()
+{
+    release_target_type_info();
+}
+
+domain& object_mutator::bound_domain() const
+{
+    return _domain ? *_domain : domain::safe_instance();
+}
+
+void object_mutator::set_domain(domain& dom)
+{
+    _domain = dom.is_default() ? nullptr : &dom;
+}
+
+void object_mutator::release_target_type_info()
+{
+    if (_target_type_info && _target_type_info != &object_type_info::null())
+    {
+        _target_type_info->unpin();
+    }
+    _target_type_info = nullptr;
+}
+
 void object_mutator::cancel()
 {
     _mutation.clear();
-    _target_type_info = nullptr;
+    release_target_type_info();
     _is_created = false;
 }
 
@@ -44,7 +68,54 @@ void object_mutator::create()
 
     _mutation.normalize();
 
-    auto& dom = domain::safe_instance();
+    // the null type is shared by all domains, but only the default one memoizes its transitions
+    if (_domain && _transition_source == &object_type_info::null())
+    {
+        _transition_source = nullptr;
+    }
+
+    if (!_transition_source)
+    {
+        create_target_type_info();
+        return;
+    }
+
+    I_DYNAMIX_ASSERT(_transition_source->as_mixin_collection() == _source_mixins);
+
+    // the transitions and their targets may be collected concurrently
+    domain::type_info_read_guard guard(bound_domain());
+
+    const size_t rules_generation = domain::mutation_rules_generation();
+    if (auto target = _transition_source->find_transition(_mutation._adding._mixins, _mutation._removing._mixins, rules_generation))
+    {
+        if (target == _transition_source)
+        {
+            // a transition of the source type stands for no change
+            return;
+        }
+
+        if (target == &object_type_info::null() || target->try_pin())
+        {
+            _target_type_info = target;
+            return;
+        }
+
+        // the target is being collected, so find it anew
+    }
+
+    // the mutation rules change the mutation, so keep its initial state for the key
+    const internal::mixin_set adding = _mutation._adding._mixins;
+    const internal::mixin_set removing = _mutation._removing._mixins;
+
+    create_target_type_info();
+
+    _transition_source->add_transition(adding, removing, rules_generation,
+        _target_type_info ? _target_type_info : _transition_source);
+}
+
+void object_mutator::create_target_type_info()
+{
+    auto& dom = bound_domain();
     dom.apply_mutation_rules(_mutation, *_source_mixins);
 
     // in case the rules broke it somehow
@@ -84,13 +155,14 @@ void object_mutator::create()
 
     sort(new_type_mixins._compact_mixins.begin(), new_type_mixins._compact_mixins.end());
 
-    _target_type_info = dom.get_object_type_info(std::move(new_type_mixins));
+    // the source type (if known) is a hint from which the call table of a new type can be derived
+    _target_type_info = dom.get_object_type_info(std::move(new_type_mixins), _transition_source);
 
     if(_target_type_info->as_mixin_collection() == _source_mixins)
     {
         // since we allow adding of existing mixins, it could be that this new type is
         // actually the mutatee's type
-        _target_type_info = nullptr;
+        release_target_type_info();
         return;
     }
 }
@@ -106,6 +178,9 @@ void object_mutator::apply_to(object& obj) const
     // we need to mutate only objects of the same type
     DYNAMIX_THROW_UNLESS(obj._type_info->as_mixin_collection() == _source_mixins, bad_mutation_source);
 
+    // and of the same domain
+    DYNAMIX_THROW_UNLESS(obj._domain == _domain, bad_mutation_source);
+
     if(!_target_type_info)
     {
         // this is an empty mutation
@@ -153,6 +228,34 @@ bool object_mutator::remove(const char* mixin_type_name)
     return true;
 }
 
+bool object_mutator::add(const mixin_name_handle& mixin_name)
+{
+    const mixin_id id = mixin_name.id();
+
+    if(id == INVALID_MIXIN_ID)
+    {
+        return false;
+    }
+
+    _mutation.start_adding(id);
+
+    return true;
+}
+
+bool object_mutator::remove(const mixin_name_handle& mixin_name)
+{
+    const mixin_id id = mixin_name.id();
+
+    if(id == INVALID_MIXIN_ID)
+    {
+        return false;
+    }
+
+    _mutation.start_removing(id);
+
+    return true;
+}
+
 void object_mutator::add(mixin_id id)
 {
     DYNAMIX_THROW_UNLESS(id < domain::instance().num_registered_mixins(), bad_mutation);
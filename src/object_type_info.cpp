@@ -6,7 +6,6 @@
 // https://opensource.org/licenses/MIT
 //
 #include "internal.hpp"
-#include "zero_memory.hpp"
 #include "dynamix/mixin_type_info.hpp"
 #include "dynamix/object_type_info.hpp"
 #include "dynamix/domain.hpp"
@@ -15,18 +14,153 @@
 #include "dynamix/object.hpp"
 #include "dynamix/type_class.hpp"
 #include <algorithm>
+#include <cstring>
+#include <cstddef>
 
 namespace dynamix
 {
 
+constexpr size_t object_type_info::MAX_TRANSITIONS;
+constexpr size_t object_type_info::COLLECTED_PINS;
+
+struct object_type_info::transition
+{
+    internal::mixin_set adding;
+    internal::mixin_set removing;
+    size_t rules_generation;
+    const object_type_info* target;
+    const transition* next;
+};
+
 object_type_info::object_type_info()
+    : _num_pins(0)
+    , _last_use(0)
+    , _transitions(nullptr)
+    , _num_transitions(0)
 {
-    internal::zero_memory(_mixin_indices, sizeof(_mixin_indices));
-    internal::zero_memory(_call_table, sizeof(_call_table));
 }
 
 object_type_info::~object_type_info()
 {
+    clear_transitions();
+
+    if (_id)
+    {
+        internal::domain::safe_instance().release_type_id(_id);
+    }
+}
+
+const object_type_info* object_type_info::find_transition(const internal::mixin_set& adding, const internal::mixin_set& removing, size_t rules_generation) const
+{
+    for (auto t = _transitions.load(std::memory_order_acquire); t; t = t->next)
+    {
+        if (t->rules_generation == rules_generation
+            && t->adding == adding
+            && t->removing == removing)
+        {
+            return t->target;
+        }
+    }
+
+    return nullptr;
+}
+
+void object_type_info::add_transition(const internal::mixin_set& adding, const internal::mixin_set& removing, size_t rules_generation, const object_type_info* target) const
+{
+    I_DYNAMIX_ASSERT(target);
+
+    // reserve a place in the list
+    // if two threads add the same transition at the same time, it will be in the list twice
+    // this is harmless
+    if (_num_transitions.fetch_add(1, std::memory_order_relaxed) >= MAX_TRANSITIONS)
+    {
+        // the list is full
+        // it will be cleared by the next garbage collection of type infos
+        _num_transitions.fetch_sub(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto t = new transition;
+    t->adding = adding;
+    t->removing = removing;
+    t->rules_generation = rules_generation;
+    t->target = target;
+
+    const transition* head = _transitions.load(std::memory_order_relaxed);
+    do
+    {
+        t->next = head;
+    } while (!_transitions.compare_exchange_weak(head, t, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void object_type_info::clear_transitions() const
+{
+    delete_transitions(detach_transitions());
+}
+
+const object_type_info::transition* object_type_info::detach_transitions() const
+{
+    auto t = _transitions.exchange(nullptr, std::memory_order_acq_rel);
+    _num_transitions.store(0, std::memory_order_relaxed);
+    return t;
+}
+
+void object_type_info::delete_transitions(const transition* t)
+{
+    while (t)
+    {
+        auto next = t->next;
+        delete t;
+        t = next;
+    }
+}
+
+bool object_type_info::try_pin() const
+{
+    size_t pins = _num_pins.load(std::memory_order_relaxed);
+    do
+    {
+        if (pins == COLLECTED_PINS) return false;
+    } while (!_num_pins.compare_exchange_weak(pins, pins + 1, std::memory_order_acquire, std::memory_order_relaxed));
+
+    _last_use.store(_domain->type_use_clock(), std::memory_order_relaxed);
+    return true;
+}
+
+void object_type_info::unpin() const
+{
+    // release, so that the collector sees the objects which were created while the type was pinned
+    I_DYNAMIX_ASSERT(_num_pins.load(std::memory_order_relaxed) != 0);
+    I_DYNAMIX_ASSERT(_num_pins.load(std::memory_order_relaxed) != COLLECTED_PINS);
+    _num_pins.fetch_sub(1, std::memory_order_release);
+}
+
+bool object_type_info::try_mark_collected() const
+{
+    if (num_objects != 0) return false;
+
+    size_t pins = 0;
+    if (!_num_pins.compare_exchange_strong(pins, COLLECTED_PINS, std::memory_order_acq_rel))
+    {
+        return false;
+    }
+
+    // no new objects can get this type now, but there could have been some created
+    // while it was pinned before (they are visible, since unpin synchronizes with the exchange)
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    // acquire, to synchronize with the decrements of the object count, after which the type info is destroyed
+    const size_t objects = num_objects.value.load(std::memory_order_acquire);
+#else
+    const size_t objects = num_objects;
+#endif
+
+    if (objects != 0)
+    {
+        _num_pins.store(0, std::memory_order_release);
+        return false;
+    }
+
+    return true;
 }
 
 static const object_type_info null_type_info;
@@ -40,7 +174,7 @@ internal::mixin_data_in_object* object_type_info::alloc_mixin_data(const object*
 {
     const size_t num_to_allocate = _compact_mixins.size() + MIXIN_INDEX_OFFSET;
 
-    domain_allocator* alloc = obj->allocator() ? obj->allocator() : internal::domain::instance().allocator();
+    domain_allocator* alloc = obj->allocator() ? obj->allocator() : obj->bound_domain().allocator();
     char* memory = alloc->alloc_mixin_data(num_to_allocate, obj);
     internal::mixin_data_in_object* ret = new (memory) internal::mixin_data_in_object[num_to_allocate];
 
@@ -55,19 +189,69 @@ void object_type_info::dealloc_mixin_data(internal::mixin_data_in_object* data,
         data[i].~mixin_data_in_object();
     }
 
-    domain_allocator* alloc = obj->allocator() ? obj->allocator() : internal::domain::instance().allocator();
+    domain_allocator* alloc = obj->allocator() ? obj->allocator() : obj->bound_domain().allocator();
     alloc->dealloc_mixin_data(reinterpret_cast<char*>(data), num_mixins, obj);
 }
 
+internal::mixin_data_in_object* object_type_info::alloc_object_block(const object* obj) const
+{
+    if (!_object_block_size) return nullptr;
+
+    domain_allocator* alloc = obj->allocator() ? obj->allocator() : obj->bound_domain().allocator();
+    char* memory = alloc->alloc_object_block(_object_block_size, obj);
+    if (!memory) return nullptr;
+
+    I_DYNAMIX_ASSERT_MSG(uintptr_t(memory) % alignof(std::max_align_t) == 0, "object blocks must be aligned as memory returned by new");
+
+    const size_t num_mixin_datas = _compact_mixins.size() + MIXIN_INDEX_OFFSET;
+    return new (memory) internal::mixin_data_in_object[num_mixin_datas];
+}
+
+void object_type_info::dealloc_object_block(internal::mixin_data_in_object* data, const object* obj) const
+{
+    const size_t num_mixin_datas = _compact_mixins.size() + MIXIN_INDEX_OFFSET;
+    for (size_t i = 0; i < num_mixin_datas; ++i)
+    {
+        data[i].~mixin_data_in_object();
+    }
+
+    domain_allocator* alloc = obj->allocator() ? obj->allocator() : obj->bound_domain().allocator();
+    alloc->dealloc_object_block(reinterpret_cast<char*>(data), _object_block_size, obj);
+}
+
+void object_type_info::compute_object_block_layout()
+{
+    if (_compact_mixins.empty()) return; // the null type has no objects
+
+    _object_block_mixin_positions.resize(_compact_mixins.size(), 0);
+
+    size_t pos = (_compact_mixins.size() + MIXIN_INDEX_OFFSET) * sizeof(internal::mixin_data_in_object);
+    bool has_block_mixins = false;
+
+    for (size_t i = 0; i < _compact_mixins.size(); ++i)
+    {
+        const mixin_type_info& info = *_compact_mixins[i];
+        if (!info.move_constructor || info.alignment > alignof(std::max_align_t)) continue;
+
+        // as with mixin_allocator::mixin_offset there's room for the object in front of the mixin
+        // the object pointer must be aligned too, even if the previous mixin has an odd size
+        pos = internal::next_multiple(internal::next_multiple(pos, alignof(object*)) + sizeof(object*), info.alignment);
+        _object_block_mixin_positions[i] = uint32_t(pos);
+        pos += info.size;
+        has_block_mixins = true;
+    }
+
+    // there's no point in a block for the mixin data alone
+    if (!has_block_mixins) return;
+
+    _object_block_size = internal::next_multiple(pos, alignof(std::max_align_t));
+}
+
 bool object_type_info::is_a(const type_class& tc) const
 {
     if (tc.is_registered())
     {
-        for (auto id : _matching_type_classes)
-        {
-            if (id == tc.id()) return true;
-        }
-        return false;
+        return _matching_type_classes.has(tc.id());
     }
     else
     {
@@ -75,17 +259,24 @@ bool object_type_info::is_a(const type_class& tc) const
     }
 }
 
+static_assert(sizeof(object_type_info::call_table_message) <= 2 * sizeof(void*), "call table messages must be tightly packed");
+
 object_type_info::call_table_message object_type_info::make_call_table_message(mixin_id id, const internal::message_for_mixin& data) const
 {
     call_table_message ret;
     ret.mixin_index = _mixin_indices[id];
     ret.caller = data.caller;
-    ret.data = &data;
     return ret;
 }
 
-void object_type_info::fill_call_table()
+void object_type_info::fill_call_table(const object_type_info* source)
 {
+    const internal::domain& dom = internal::domain::instance();
+
+    // the table has room for all messages registered so far
+    // the ones registered later are out of its bounds and thus not implemented
+    _call_table.resize(dom._messages.size());
+
     // first pass
     // find top bid messages and prepare to calculate message buffer length length
 
@@ -94,11 +285,24 @@ void object_type_info::fill_call_table()
     // in this pass we make use of the fact that _call_table begin starts as nullptr
     // for a new type so we will use it as a counter
 
+    // ids of the messages implemented by the mixins, so that the following passes
+    // don't need to go through all messages in the domain
+    std::vector<feature_id> implemented_messages;
+
+    // message data of the top-bid messages while building the table
+    std::vector<const internal::message_for_mixin*> top_bid_datas(dom._messages.size());
+
     for (const mixin_type_info* info : _compact_mixins)
     {
         for (const internal::message_for_mixin& msg : info->message_infos)
         {
-            call_table_entry& table_entry = _call_table[msg.message->id];
+            call_table_entry& table_entry = _call_table.edit(msg.message->id);
+            const internal::message_for_mixin*& top_bid_data = top_bid_datas[msg.message->id];
+
+            if (!table_entry.top_bid_message)
+            {
+                implemented_messages.push_back(msg.message->id);
+            }
 
             if (msg.message->mechanism == internal::message_t::unicast)
             {
@@ -106,18 +310,20 @@ void object_type_info::fill_call_table()
                 {
                     // new message
                     table_entry.top_bid_message = make_call_table_message(info->id, msg);
+                    top_bid_data = &msg;
                 }
-                else if (table_entry.top_bid_message.data->priority < msg.priority)
+                else if (top_bid_data->priority < msg.priority)
                 {
                     // we found bigger priority
                     // make it looks like a new message
                     table_entry.top_bid_message = make_call_table_message(info->id, msg);
+                    top_bid_data = &msg;
 
                     // also remove the top-priority size we've accumulated
                     message_data_buffer_size -= reinterpret_cast<intptr_t>(table_entry.begin) / sizeof(*table_entry.begin);
                     table_entry.begin = nullptr;
                 }
-                else if (table_entry.top_bid_message.data->priority == msg.priority)
+                else if (top_bid_data->priority == msg.priority)
                 {
                     if (!table_entry.begin)
                     {
@@ -136,9 +342,10 @@ void object_type_info::fill_call_table()
                     ++table_entry.begin;
 
                     // we have multiple bidders for the same priority
-                    if (table_entry.top_bid_message.data->bid < msg.bid)
+                    if (top_bid_data->bid < msg.bid)
                     {
                         table_entry.top_bid_message = make_call_table_message(info->id, msg);
+                        top_bid_data = &msg;
                     }
                 }
             }
@@ -154,6 +361,7 @@ void object_type_info::fill_call_table()
                     // also set top bid message just so we mark it as implemented
                     // it won't actually be used for multicasts
                     table_entry.top_bid_message = make_call_table_message(info->id, msg);
+                    top_bid_data = &msg;
                 }
 
                 // again we use begin to set the size of the buffer this particular message needs
@@ -163,18 +371,84 @@ void object_type_info::fill_call_table()
         }
     }
 
-    const internal::domain& dom = internal::domain::instance();
-
     _message_data_buffer.reset(new call_table_message[message_data_buffer_size]);
+    _message_data_buffer_size = size_t(message_data_buffer_size);
+    _message_data_cold_buffer.reset(new const internal::message_for_mixin*[message_data_buffer_size]());
     auto message_data_buffer_ptr = _message_data_buffer.get();
 
+    // pass 1.1
+    // if we have a source type, find the messages whose entries can be copied from it
+    // those are the messages which aren't implemented by any of the mixins which are only in one of the types
+    // (thus they're implemented by the same mixins in both)
+    std::vector<char> changed_messages;
+
+    // the indices of the source type's mixins in this type
+    // (NULL_MIXIN_DATA_INDEX for the ones which aren't here)
+    std::vector<uint32_t> source_to_this_index;
+
+    if (!message_data_buffer_size)
+    {
+        // no message has a buffer, so there's nothing to copy
+        // the rest of the entries are built in the first pass anyway
+        source = nullptr;
+    }
+
+    if (source)
+    {
+        changed_messages.resize(dom._messages.size());
+        auto mark_changed = [&changed_messages](const mixin_type_info* info)
+        {
+            for (const internal::message_for_mixin& msg : info->message_infos)
+            {
+                changed_messages[msg.message->id] = 1;
+            }
+        };
+
+        // both are sorted, so the difference is found in a single walk
+        auto a = _compact_mixins.begin();
+        auto b = source->_compact_mixins.begin();
+        while (a != _compact_mixins.end() || b != source->_compact_mixins.end())
+        {
+            if (b == source->_compact_mixins.end() || (a != _compact_mixins.end() && *a < *b))
+            {
+                mark_changed(*a++);
+            }
+            else if (a == _compact_mixins.end() || *b < *a)
+            {
+                mark_changed(*b++);
+            }
+            else
+            {
+                ++a;
+                ++b;
+            }
+        }
+
+        source_to_this_index.resize(source->_compact_mixins.size() + MIXIN_INDEX_OFFSET, NULL_MIXIN_DATA_INDEX);
+        for (size_t i = 0; i < source->_compact_mixins.size(); ++i)
+        {
+            source_to_this_index[i + MIXIN_INDEX_OFFSET] = _mixin_indices[source->_compact_mixins[i]->id];
+        }
+    }
+
+    // whether the entry of a message (which this type implements) can be copied from the source type
+    // if the source has a buffer for the message, this type has an identical one
+    auto is_derived = [&](feature_id id) -> bool
+    {
+        return source
+            && !changed_messages[id]
+            && source->_call_table[id].begin
+            && source->_call_table[id].top_bid_message.mixin_index != DEFAULT_MSG_IMPL_INDEX;
+    };
+
     // second pass
     // update begin and end pointers of _call_table and add message datas to buffer
     for (const mixin_type_info* info : _compact_mixins)
     {
         for (const internal::message_for_mixin& msg : info->message_infos)
         {
-            call_table_entry& table_entry = _call_table[msg.message->id];
+            call_table_entry& table_entry = _call_table.edit(msg.message->id);
+            const internal::message_for_mixin*& top_bid_data = top_bid_datas[msg.message->id];
 
             if(table_entry.begin)
             {
@@ -195,77 +469,151 @@ void object_type_info::fill_call_table()
                     I_DYNAMIX_ASSERT(message_data_buffer_ptr - _message_data_buffer.get() <= message_data_buffer_size);
                     table_entry.begin = begin;
                     table_entry.end = begin;
+
+                    if (is_derived(msg.message->id))
+                    {
+                        // copy the buffer, which is already sorted, from the source
+                        // the order of the messages is the same, only the mixin indices change
+                        const call_table_entry& source_entry = source->_call_table[msg.message->id];
+                        auto source_buffer_end = source_entry.end;
+                        if (msg.message->mechanism == internal::message_t::multicast)
+                        {
+                            // include the lower bidders and the terminator
+                            while (*source_buffer_end) ++source_buffer_end;
+                            ++source_buffer_end;
+                        }
+
+                        const size_t size = size_t(source_buffer_end - source_entry.begin);
+                        I_DYNAMIX_ASSERT(begin + size == message_data_buffer_ptr);
+
+                        const size_t offset = size_t(begin - _message_data_buffer.get());
+                        const size_t source_offset = size_t(source_entry.begin - source->_message_data_buffer.get());
+                        for (size_t im = 0; im < size; ++im)
+                        {
+                            call_table_message m = source_entry.begin[im];
+                            if (m) m.mixin_index = source_to_this_index[m.mixin_index];
+                            begin[im] = m;
+                            _message_data_cold_buffer[offset + im] = source->_message_data_cold_buffer[source_offset + im];
+                        }
+
+                        table_entry.end = begin + (source_entry.end - source_entry.begin);
+                    }
                 }
 
-                if (msg.message->mechanism == internal::message_t::multicast || table_entry.top_bid_message.data->priority == msg.priority)
+                if (is_derived(msg.message->id))
+                {
+                    // already filled
+                    continue;
+                }
+
+                if (msg.message->mechanism == internal::message_t::multicast || top_bid_data->priority == msg.priority)
                 {
                     // add all messages for multicasts
                     // add same-priority messages for unicasts
+                    _message_data_cold_buffer[table_entry.end - _message_data_buffer.get()] = &msg;
                     *table_entry.end++ = make_call_table_message(info->id, msg);
                 }
             }
         }
     }
 
-    // third pass through all messages of the domain
-    // if we implement it AND it has a buffer, sort it
-    for(size_t i=0; i<dom._num_registered_messages; ++i)
+    // third pass through all implemented messages
+    // if it has a buffer, sort it
+    struct sortable_message
+    {
+        call_table_message msg;
+        const internal::message_for_mixin* data;
+    };
+    std::vector<sortable_message> sort_buffer;
+
+    // the rank of each mixin's name among the names of the mixins of this type
+    // multicasts with the same bid and priority are sorted by it
+    // this will guarantee that different compilations of the same mixins sets
+    // will always have the same order of multicast execution
+    // it's calculated when it's first needed, so that there are no string comparisons in the sort itself
+    std::vector<uint32_t> name_ranks;
+    auto calc_name_ranks = [this, &name_ranks]()
     {
-        if (!dom._messages[i])
+        if (!name_ranks.empty()) return;
+
+        std::vector<uint32_t> by_name(_compact_mixins.size());
+        for (uint32_t im = 0; im < by_name.size(); ++im) by_name[im] = im;
+        std::sort(by_name.begin(), by_name.end(), [this](uint32_t a, uint32_t b)
         {
-            // no such message
-            continue;
+            return strcmp(_compact_mixins[a]->name, _compact_mixins[b]->name) < 0;
+        });
+
+        name_ranks.resize(by_name.size());
+        for (uint32_t rank = 0; rank < by_name.size(); ++rank)
+        {
+            name_ranks[by_name[rank]] = rank;
         }
+    };
 
-        call_table_entry& table_entry = _call_table[i];
+    for (auto i : implemented_messages)
+    {
+        call_table_entry& table_entry = _call_table.edit(i);
 
         if (!table_entry.begin)
         {
-            // either we don't implement this message
-            // or it's a unicast with a single bid for the top priority
+            // it's a unicast with a single bid for the top priority
             // no buffer here, so we don't care about those
             continue;
         }
 
+        if (is_derived(i))
+        {
+            // already sorted
+            continue;
+        }
+
+        // the sorting depends on the cold message data, so gather the messages
+        // along with their data in a temporary buffer and sort them there
+        const size_t offset = size_t(table_entry.begin - _message_data_buffer.get());
+        const size_t size = size_t(table_entry.end - table_entry.begin);
+        sort_buffer.clear();
+        for (size_t im = 0; im < size; ++im)
+        {
+            sort_buffer.push_back({table_entry.begin[im], _message_data_cold_buffer[offset + im]});
+        }
+
         // sort by bid
-        std::sort(table_entry.begin, table_entry.end, [](const call_table_message& a, const call_table_message& b) -> bool
+        std::sort(sort_buffer.begin(), sort_buffer.end(), [](const sortable_message& a, const sortable_message& b) -> bool
         {
             // descending
             return b.data->bid < a.data->bid;
         });
 
-        if (dom._messages[i]->mechanism == internal::message_t::multicast)
+        const bool is_multicast = dom._messages[i]->mechanism == internal::message_t::multicast;
+
+        // for multicasts we will also redirect table_entry.end to point to the first set
+        // of messages (the top bidders) thus using it for multicast calls
+        // and gen_num_bidders
+        size_t first_end = size;
+
+        if (is_multicast)
         {
             // for multicasts we have extra work to do
             // we need to sort messages with the same bid by priority
+            first_end = 0;
 
-            // we will also redirect table_entry.end to point to the first set
-            // of messages (the top bidders) thus using it for multicast calls
-            // and gen_num_bidders
-            // we will set the actual end of the buffer to point to nullptr
-            // so we know when to stop when searching through it for DYNAMIX_CALL_NEXT_BIDDER
-            call_table_message* first_end = nullptr;
+            calc_name_ranks();
 
-            auto begin = table_entry.begin;
-            for (auto ptr = table_entry.begin; ptr < table_entry.end; ++ptr)
+            auto begin = sort_buffer.begin();
+            for (auto ptr = sort_buffer.begin(); ptr < sort_buffer.end(); ++ptr)
             {
                 auto next = ptr + 1;
 
-                if (next == table_entry.end || next->data->bid != ptr->data->bid)
+                if (next == sort_buffer.end() || next->data->bid != ptr->data->bid)
                 {
                     // bid change
                     // sort by priority
-                    std::sort(begin, next, [this](const call_table_message& a, const call_table_message& b) -> bool
+                    std::sort(begin, next, [&name_ranks](const sortable_message& a, const sortable_message& b) -> bool
                     {
                         if (b.data->priority == a.data->priority)
                         {
                             // on the same priority sort by name of mixin
-                            // this will guarantee that different compilations of the same mixins sets
-                            // will always have the same order of multicast execution
-                            const char* name_a = _compact_mixins[a.mixin_index - MIXIN_INDEX_OFFSET]->name;
-                            const char* name_b = _compact_mixins[b.mixin_index - MIXIN_INDEX_OFFSET]->name;
-
-                            return strcmp(name_a, name_b) < 0;
+                            return name_ranks[a.msg.mixin_index - MIXIN_INDEX_OFFSET] < name_ranks[b.msg.mixin_index - MIXIN_INDEX_OFFSET];
                         }
                         else
                         {
@@ -277,38 +625,49 @@ void object_type_info::fill_call_table()
 
                     if (!first_end)
                     {
-                        first_end = next;
+                        first_end = size_t(next - sort_buffer.begin());
                     }
                 }
             }
+        }
+
+        // split the sorted messages back into the hot and cold buffers
+        for (size_t im = 0; im < size; ++im)
+        {
+            table_entry.begin[im] = sort_buffer[im].msg;
+            _message_data_cold_buffer[offset + im] = sort_buffer[im].data;
+        }
 
+        if (is_multicast)
+        {
+            // we will set the actual end of the buffer to point to nullptr
+            // so we know when to stop when searching through it for DYNAMIX_CALL_NEXT_BIDDER
             table_entry.end->reset(); // set nullptr at the end of the buffer
-            table_entry.end = first_end;
+            table_entry.end = table_entry.begin + first_end;
         }
     }
 
     // pass 1.5
     // check for unicast clashes
     // no messages with the same bid at the top-priority may exist
-    for (size_t i = 0; i < dom._num_registered_messages; ++i)
+    for (auto i : implemented_messages)
     {
-        call_table_entry& table_entry = _call_table[i];
+        const call_table_entry& table_entry = _call_table[i];
 
         if (!table_entry.begin)
         {
-            // we don't implement this message
-            // or a single-bid unicast
+            // a single-bid unicast
             continue;
         }
 
-        const internal::message_t* msg_data = dom._messages[i];
-
-        if (!msg_data)
+        if (is_derived(i))
         {
-            // no such message
+            // checked in the source
             continue;
         }
 
+        const internal::message_t* msg_data = dom._messages[i];
+
         if (msg_data->mechanism != internal::message_t::unicast)
         {
             // not a unicast
@@ -321,24 +680,93 @@ void object_type_info::fill_call_table()
         for (auto ptr = table_entry.begin; ptr != table_entry.end - 1; ++ptr)
         {
             DYNAMIX_THROW_UNLESS(
-                ptr->data->bid > (ptr+1)->data->bid,
+                message_data(ptr)->bid > message_data(ptr + 1)->bid,
                 unicast_clash
             );
         }
     }
 
-    // final pass through all messages
-    // if we don't implement a message and it has a default implementation, set it
-    for (size_t i = 0; i<dom._num_registered_messages; ++i)
+    // pass 1.6
+    // precompute the next bidders for DYNAMIX_CALL_NEXT_BIDDER
+    // for each message with a buffer and each mixin in it find the range of messages with the next bid
+    size_t num_buffered_messages = 0;
+    for (auto i : implemented_messages)
     {
-        call_table_entry& table_entry = _call_table[i];
+        if (_call_table[i].begin) ++num_buffered_messages;
+    }
 
-        if (table_entry.top_bid_message)
+    const size_t num_mixins = _compact_mixins.size();
+    _next_bidder_buffer_size = num_buffered_messages * num_mixins;
+    _next_bidder_buffer.reset(new next_bidder_range[_next_bidder_buffer_size]());
+    auto next_bidder_buffer_ptr = _next_bidder_buffer.get();
+
+    for (auto i : implemented_messages)
+    {
+        call_table_entry& table_entry = _call_table.edit(i);
+
+        if (!table_entry.begin)
         {
-            // we already implement this message
+            // no buffer - no next bidders
+            continue;
+        }
+
+        next_bidder_range* next_bidders = next_bidder_buffer_ptr;
+        next_bidder_buffer_ptr += num_mixins;
+        table_entry.next_bidders = next_bidders;
+
+        if (is_derived(i))
+        {
+            // the ranges are the same, only the mixin indices change
+            const next_bidder_range* source_next_bidders = source->_call_table[i].next_bidders;
+            for (size_t im = 0; im < source->_compact_mixins.size(); ++im)
+            {
+                const uint32_t index = source_to_this_index[im + MIXIN_INDEX_OFFSET];
+                if (index != NULL_MIXIN_DATA_INDEX)
+                {
+                    next_bidders[index - MIXIN_INDEX_OFFSET] = source_next_bidders[im];
+                }
+            }
             continue;
         }
 
+        // for multicasts the buffer continues after end until the terminator
+        auto buffer_end = table_entry.end;
+        if (dom._messages[i]->mechanism == internal::message_t::multicast)
+        {
+            while (*buffer_end) ++buffer_end;
+        }
+
+        // go through the groups of messages with the same bid
+        // (for unicasts each group is a single message since we've checked for clashes)
+        // the next bidders of each message in a group is the group after it
+        auto group_begin = table_entry.begin;
+        while (group_begin != buffer_end)
+        {
+            auto group_end = group_begin + 1;
+            while (group_end != buffer_end && message_data(group_end)->bid == message_data(group_begin)->bid) ++group_end;
+
+            auto next_group_end = group_end;
+            while (next_group_end != buffer_end && message_data(next_group_end)->bid == message_data(group_end)->bid) ++next_group_end;
+
+            next_bidder_range range;
+            range.begin = uint32_t(group_end - table_entry.begin);
+            range.end = uint32_t(next_group_end - table_entry.begin);
+
+            for (auto ptr = group_begin; ptr != group_end; ++ptr)
+            {
+                next_bidders[ptr->mixin_index - MIXIN_INDEX_OFFSET] = range;
+            }
+
+            group_begin = group_end;
+        }
+    }
+
+    I_DYNAMIX_ASSERT(next_bidder_buffer_ptr == _next_bidder_buffer.get() + _next_bidder_buffer_size);
+
+    // final pass through all messages
+    // if we don't implement a message and it has a default implementation, set it
+    for (size_t i = 0; i<dom._messages.size(); ++i)
+    {
         const internal::message_t* msg_data = dom._messages[i];
 
         if (!msg_data)
@@ -353,9 +781,17 @@ void object_type_info::fill_call_table()
             continue;
         }
 
+        if (_call_table[i].top_bid_message)
+        {
+            // we already implement this message
+            continue;
+        }
+
+        // only edit the entries we fill so that the unused pages of the compact table stay unallocated
+        call_table_entry& table_entry = _call_table.edit(i);
+
         table_entry.top_bid_message.mixin_index = DEFAULT_MSG_IMPL_INDEX;
         table_entry.top_bid_message.caller = msg_data->default_impl_data->caller;
-        table_entry.top_bid_message.data = msg_data->default_impl_data;
 
         if (msg_data->mechanism == internal::message_t::multicast)
         {
@@ -377,9 +813,34 @@ bool object_type_info::implements_message_by_mixin(feature_id id) const
         return false;
     }
 
-    const auto& msg_data = internal::domain::instance().message_data(id);
+    return entry.top_bid_message.mixin_index != DEFAULT_MSG_IMPL_INDEX;
+}
 
-    return entry.top_bid_message.data != msg_data.default_impl_data;
+internal::func_ptr object_type_info::batch_caller(feature_id id, uint32_t mixin_index) const
+{
+    if (mixin_index < MIXIN_INDEX_OFFSET)
+    {
+        // default implementations don't have batch callers
+        return nullptr;
+    }
+
+    const mixin_type_info* info = _compact_mixins[mixin_index - MIXIN_INDEX_OFFSET];
+
+    if (!info->has_batch_messages)
+    {
+        // avoid searching through the messages of most mixins
+        return nullptr;
+    }
+
+    for (const internal::message_for_mixin& msg : info->message_infos)
+    {
+        if (msg.message->id == id)
+        {
+            return msg.batch_caller;
+        }
+    }
+
+    return nullptr;
 }
 
 size_t object_type_info::message_num_implementers(feature_id id) const
@@ -405,7 +866,7 @@ void object_type_info::get_message_names(std::vector<const char*>& out_message_n
 {
     const internal::domain& dom = internal::domain::instance();
 
-    for (size_t i = 0; i < DYNAMIX_MAX_MESSAGES; ++i)
+    for (size_t i = 0; i < _call_table.size(); ++i)
     {
         if (implements_message(i))
         {
@@ -414,6 +875,19 @@ void object_type_info::get_message_names(std::vector<const char*>& out_message_n
     }
 }
 
+size_t object_type_info::memory_footprint() const
+{
+    return sizeof(object_type_info)
+        + _call_table.allocated_size()
+        + _mixin_indices.allocated_size()
+        + _object_block_mixin_positions.capacity() * sizeof(uint32_t)
+        + _message_data_buffer_size * (sizeof(call_table_message) + sizeof(const internal::message_for_mixin*))
+        + _next_bidder_buffer_size * sizeof(next_bidder_range)
+        + _compact_mixins.capacity() * sizeof(const mixin_type_info*)
+        + _matching_type_classes.allocated_size()
+        + _num_transitions.load(std::memory_order_relaxed) * sizeof(transition);
+}
+
 void object_type_info::get_mixin_names(std::vector<const char*>& out_mixin_names) const
 {
     for (const mixin_type_info* mixin_info : _compact_mixins)
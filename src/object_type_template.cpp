@@ -22,6 +22,12 @@ object_type_template::object_type_template()
 {
 }
 
+object_type_template::object_type_template(domain& dom)
+    : object_mutator(object_type_info::null().as_mixin_collection())
+{
+    set_domain(dom);
+}
+
 void object_type_template::apply_to(object& o) const
 {
     o.clear();
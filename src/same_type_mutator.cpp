@@ -24,6 +24,11 @@ same_type_mutator::same_type_mutator()
 same_type_mutator::same_type_mutator(const object_type_info* info)
     : object_mutator(info->as_mixin_collection())
 {
+    // the null type info belongs to no domain
+    if (info->_domain)
+    {
+        set_domain(*info->_domain);
+    }
 }
 
 
@@ -32,6 +37,7 @@ void same_type_mutator::apply_to(object& o)
     if(!_is_created)
     {
         _source_mixins = o._type_info->as_mixin_collection();
+        _domain = o._domain;
         create();
     }
 
@@ -44,10 +44,13 @@ single_object_mutator::~single_object_mutator()
 void single_object_mutator::apply()
 {
     _source_mixins = _object._type_info->as_mixin_collection();
+    _transition_source = _object._type_info;
+    _domain = _object._domain;
     create();
     apply_to(_object);
     cancel(); // to go back to empty state
     _source_mixins = nullptr; // really empty
+    _transition_source = nullptr;
     _is_manually_applied = true;
 }
 
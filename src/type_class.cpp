@@ -8,6 +8,7 @@
 #include "internal.hpp"
 #include "dynamix/type_class.hpp"
 #include "dynamix/domain.hpp"
+#include "dynamix/object_type_info.hpp"
 
 namespace dynamix
 {
@@ -21,6 +22,17 @@ type_class::type_class(type_class::match_func func, bool register_globally /*= f
     }
 }
 
+type_class::type_class(type_class_filter filter, bool register_globally /*= false*/)
+    : _filter(std::move(filter))
+{
+    // the masks are compiled when it's registered
+    // a local type class resolves its filter when it's matched
+    if (register_globally)
+    {
+        internal::domain::safe_instance().register_type_class(*this);
+    }
+}
+
 type_class::~type_class()
 {
     if (is_registered())
@@ -29,4 +41,116 @@ type_class::~type_class()
     }
 }
 
+bool type_class::matches(const object_type_info& ti) const
+{
+    if (_match_func) return _match_func(ti);
+
+    if (!is_registered())
+    {
+        // the domain doesn't recompile local type classes when mixins or messages are
+        // registered or unregistered, so the filter is resolved with their current ids
+        auto& dom = internal::domain::safe_instance();
+
+        for (auto info : _filter._all_of)
+        {
+            auto id = dom.registered_id(*info);
+            if (id == INVALID_MIXIN_ID || !ti.has(id)) return false;
+        }
+
+        if (!_filter._any_of.empty())
+        {
+            bool any = false;
+            for (auto info : _filter._any_of)
+            {
+                auto id = dom.registered_id(*info);
+                if (id != INVALID_MIXIN_ID && ti.has(id))
+                {
+                    any = true;
+                    break;
+                }
+            }
+            if (!any) return false;
+        }
+
+        for (auto info : _filter._none_of)
+        {
+            auto id = dom.registered_id(*info);
+            if (id != INVALID_MIXIN_ID && ti.has(id)) return false;
+        }
+
+        for (auto f : _filter._implements)
+        {
+            auto id = dom.registered_id(*f);
+            if (id == INVALID_FEATURE_ID || !ti.implements_message(id)) return false;
+        }
+
+        return true;
+    }
+
+    internal::id_bitset mixins;
+    for (mixin_id id : ti._mixins)
+    {
+        mixins.add(id);
+    }
+    return matches(ti, mixins);
+}
+
+bool type_class::matches(const object_type_info& ti, const internal::id_bitset& mixins) const
+{
+    if (_match_func) return _match_func(ti);
+    if (_never_matches) return false;
+
+    if (!mixins.has_all(_all_of)) return false;
+    if (!_filter._any_of.empty() && !mixins.intersects(_any_of)) return false;
+    if (mixins.intersects(_none_of)) return false;
+
+    for (auto id : _implements)
+    {
+        if (!ti.implements_message(id)) return false;
+    }
+
+    return true;
+}
+
+void type_class::compile()
+{
+    if (_match_func) return;
+
+    _all_of.clear();
+    _any_of.clear();
+    _none_of.clear();
+    _implements.clear();
+    _never_matches = false;
+
+    auto& dom = internal::domain::safe_instance();
+
+    for (auto info : _filter._all_of)
+    {
+        auto id = dom.registered_id(*info);
+        if (id == INVALID_MIXIN_ID) _never_matches = true;
+        else _all_of.add(id);
+    }
+
+    // the mixins which aren't registered can't be in a type
+    for (auto info : _filter._any_of)
+    {
+        auto id = dom.registered_id(*info);
+        if (id != INVALID_MIXIN_ID) _any_of.add(id);
+    }
+    if (!_filter._any_of.empty() && _any_of.empty()) _never_matches = true;
+
+    for (auto info : _filter._none_of)
+    {
+        auto id = dom.registered_id(*info);
+        if (id != INVALID_MIXIN_ID) _none_of.add(id);
+    }
+
+    for (auto f : _filter._implements)
+    {
+        auto id = dom.registered_id(*f);
+        if (id == INVALID_FEATURE_ID) _never_matches = true;
+        else _implements.push_back(id);
+    }
+}
+
 }
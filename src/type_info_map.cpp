@@ -0,0 +1,150 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "internal.hpp"
+#include "dynamix/internal/type_info_map.hpp"
+#include "dynamix/object_type_info.hpp"
+
+namespace dynamix
+{
+namespace internal
+{
+
+namespace
+{
+// the table is grown when it's half full, so the probe sequences stay short
+const size_t initial_capacity = 64;
+
+size_t slot_of(const mixin_set& mixins, size_t mask)
+{
+    return mixins.hash() & mask;
+}
+}
+
+object_type_info_map::table::table(size_t capacity)
+    : mask(capacity - 1)
+    , slots(new std::atomic<const object_type_info*>[capacity])
+{
+    I_DYNAMIX_ASSERT((capacity & mask) == 0); // power of two
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+object_type_info_map::object_type_info_map()
+    : _current_table(new table(initial_capacity))
+{
+    _table.store(_current_table.get(), std::memory_order_relaxed);
+}
+
+object_type_info_map::~object_type_info_map()
+{
+    for_each([](const object_type_info& info)
+    {
+        delete &info;
+    });
+}
+
+const object_type_info* object_type_info_map::find(const mixin_set& mixins) const
+{
+    const table* t = _table.load(std::memory_order_acquire);
+
+    size_t i = slot_of(mixins, t->mask);
+    for (size_t probe = 0; probe <= t->mask; ++probe)
+    {
+        const object_type_info* info = t->slots[i].load(std::memory_order_acquire);
+        if (!info) return nullptr;
+        if (info->_mixins == mixins) return info;
+        i = (i + 1) & t->mask;
+    }
+
+    return nullptr;
+}
+
+void object_type_info_map::add(table& t, const object_type_info* info)
+{
+    size_t i = slot_of(info->_mixins, t.mask);
+    while (t.slots[i].load(std::memory_order_relaxed))
+    {
+        i = (i + 1) & t.mask;
+    }
+
+    // publish the fully built type info
+    t.slots[i].store(info, std::memory_order_release);
+}
+
+void object_type_info_map::insert(std::unique_ptr<object_type_info> info)
+{
+    I_DYNAMIX_ASSERT(!find(info->_mixins));
+
+    const size_t capacity = _current_table->mask + 1;
+    if ((_size + 1) * 2 > capacity)
+    {
+        // grow
+        // fill the new table before publishing it
+        std::unique_ptr<table> new_table(new table(capacity * 2));
+        for_each([&new_table](const object_type_info& existing)
+        {
+            add(*new_table, &existing);
+        });
+
+        _table.store(new_table.get(), std::memory_order_release);
+
+        // lookups may still be reading the old table
+        _retired_tables.emplace_back(std::move(_current_table));
+        _current_table = std::move(new_table);
+    }
+
+    add(*_current_table, info.release());
+    ++_size;
+}
+
+void object_type_info_map::erase(const object_type_info* info)
+{
+    unlink(info);
+    delete info;
+}
+
+void object_type_info_map::unlink(const object_type_info* info)
+{
+    table& t = *_current_table;
+
+    size_t i = slot_of(info->_mixins, t.mask);
+    while (t.slots[i].load(std::memory_order_relaxed) != info)
+    {
+        I_DYNAMIX_ASSERT(t.slots[i].load(std::memory_order_relaxed)); // erasing a type info which isn't in the map
+        i = (i + 1) & t.mask;
+    }
+
+    // backward shift deletion
+    // move the following elements of the probe sequence into the hole, so that no tombstones are needed
+    size_t j = i;
+    for (;;)
+    {
+        j = (j + 1) & t.mask;
+        const object_type_info* next = t.slots[j].load(std::memory_order_relaxed);
+        if (!next) break;
+
+        // the slot where the probe sequence of next starts
+        const size_t k = slot_of(next->_mixins, t.mask);
+
+        // next can be moved to the hole if k is not cyclically within (i, j]
+        const bool stays = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+        if (!stays)
+        {
+            t.slots[i].store(next, std::memory_order_release);
+            i = j;
+        }
+    }
+
+    t.slots[i].store(nullptr, std::memory_order_release);
+    --_size;
+}
+
+} // namespace internal
+} // namespace dynamix
@@ -0,0 +1,278 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include "internal.hpp"
+#include "dynamix/type_manifest.hpp"
+#include "dynamix/domain.hpp"
+#include "dynamix/object_type_info.hpp"
+#include "dynamix/executor.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <unordered_map>
+
+namespace dynamix
+{
+
+using namespace internal;
+
+// the format of a manifest:
+// * the magic and the format version
+// * the number of mixin names and the names, each of which is its length and its characters
+// * the number of types and the types, each of which is its number of mixins and the indices
+//   of their names
+// all numbers are unsigned LEB128, so most of them are a single byte
+
+namespace
+{
+
+const char manifest_magic[4] = {'D', 'M', 'X', 'T'};
+const uint32_t manifest_version = 1;
+
+// guards against allocating huge buffers when reading corrupted data
+const uint32_t max_name_length = 4096;
+
+void write_uint(std::ostream& out, uint32_t n)
+{
+    do
+    {
+        char byte = char(n & 0x7F);
+        n >>= 7;
+        if (n) byte |= char(0x80);
+        out.put(byte);
+    } while (n);
+}
+
+bool read_uint(std::istream& in, uint32_t& out_n)
+{
+    out_n = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        const int byte = in.get();
+        if (byte == std::char_traits<char>::eof()) return false;
+        out_n |= uint32_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false; // too long to be a 32-bit number
+}
+
+struct manifest
+{
+    std::vector<std::string> names;
+    std::vector<std::vector<uint32_t>> types; // indices in names
+};
+
+bool read_manifest(std::istream& in, manifest& out)
+{
+    char magic[sizeof(manifest_magic)];
+    if (!in.read(magic, sizeof(magic))) return false;
+    if (memcmp(magic, manifest_magic, sizeof(magic)) != 0) return false;
+
+    uint32_t version;
+    if (!read_uint(in, version) || version != manifest_version) return false;
+
+    uint32_t num_names;
+    if (!read_uint(in, num_names)) return false;
+    for (uint32_t i = 0; i < num_names; ++i)
+    {
+        uint32_t length;
+        if (!read_uint(in, length) || length == 0 || length > max_name_length) return false;
+        std::string name(length, '\0');
+        if (!in.read(&name[0], length)) return false;
+        out.names.emplace_back(std::move(name));
+    }
+
+    uint32_t num_types;
+    if (!read_uint(in, num_types)) return false;
+    for (uint32_t i = 0; i < num_types; ++i)
+    {
+        uint32_t num_mixins;
+        if (!read_uint(in, num_mixins) || num_mixins == 0 || num_mixins > num_names) return false;
+        std::vector<uint32_t> type(num_mixins);
+        for (auto& index : type)
+        {
+            if (!read_uint(in, index) || index >= num_names) return false;
+        }
+        out.types.emplace_back(std::move(type));
+    }
+
+    return true;
+}
+
+} // namespace
+
+bool save_type_manifest(std::ostream& out)
+{
+    // the type infos without objects may be collected while we write them
+    domain::type_info_read_guard guard;
+
+    std::vector<const object_type_info*> types;
+    domain::safe_instance().get_object_type_infos(types);
+
+    // the null type is never created by get_object_type_info
+    types.erase(std::remove_if(types.begin(), types.end(), [](const object_type_info* type)
+    {
+        return type->_compact_mixins.empty();
+    }), types.end());
+
+    // each name is written once and the types refer to it by index
+    std::vector<const char*> names;
+    std::unordered_map<mixin_id, uint32_t> name_indices;
+    for (auto type : types)
+    {
+        for (const mixin_type_info* info : type->_compact_mixins)
+        {
+            if (name_indices.emplace(info->id, uint32_t(names.size())).second)
+            {
+                names.push_back(info->name);
+            }
+        }
+    }
+
+    out.write(manifest_magic, sizeof(manifest_magic));
+    write_uint(out, manifest_version);
+
+    write_uint(out, uint32_t(names.size()));
+    for (auto name : names)
+    {
+        const auto length = strlen(name);
+        write_uint(out, uint32_t(length));
+        out.write(name, std::streamsize(length));
+    }
+
+    write_uint(out, uint32_t(types.size()));
+    for (auto type : types)
+    {
+        write_uint(out, uint32_t(type->_compact_mixins.size()));
+        for (const mixin_type_info* info : type->_compact_mixins)
+        {
+            write_uint(out, name_indices[info->id]);
+        }
+    }
+
+    return bool(out);
+}
+
+bool save_type_manifest(const char* path)
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    return save_type_manifest(out);
+}
+
+type_manifest_load_result load_type_manifest(std::istream& in, executor* exec)
+{
+    type_manifest_load_result result;
+
+    manifest m;
+    if (!read_manifest(in, m)) return result;
+
+    result.valid = true;
+    result.num_types = m.types.size();
+
+    domain& dom = domain::safe_instance();
+
+    // resolve the names once for all types
+    std::vector<mixin_id> ids;
+    ids.reserve(m.names.size());
+    for (auto& name : m.names)
+    {
+        const mixin_id id = dom.get_mixin_id_by_name(name.c_str());
+        if (id == INVALID_MIXIN_ID)
+        {
+            result.unresolved_mixin_names.push_back(name);
+        }
+        ids.push_back(id);
+    }
+
+    // the types with fewer mixins come first, so that get_object_type_info can find
+    // existing types from which to derive the call tables of the bigger ones
+    std::stable_sort(m.types.begin(), m.types.end(), [](const std::vector<uint32_t>& a, const std::vector<uint32_t>& b)
+    {
+        return a.size() < b.size();
+    });
+
+    std::vector<mixin_collection> collections;
+    collections.reserve(m.types.size());
+    for (auto& type : m.types)
+    {
+        bool resolved = true;
+        for (auto index : type)
+        {
+            if (ids[index] == INVALID_MIXIN_ID)
+            {
+                resolved = false;
+                break;
+            }
+        }
+
+        if (!resolved)
+        {
+            ++result.num_skipped_types;
+            continue;
+        }
+
+        collections.emplace_back();
+        auto& mixins = collections.back();
+        for (auto index : type)
+        {
+            mixins.add(ids[index]);
+        }
+
+        // same as in object_mutator
+        std::sort(mixins._compact_mixins.begin(), mixins._compact_mixins.end());
+    }
+
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+    if (exec)
+    {
+        // the types of each size are a batch
+        // they can't be derived from each other, so nothing is lost by creating them in parallel
+        size_t batch_begin = 0;
+        while (batch_begin != collections.size())
+        {
+            const size_t size = collections[batch_begin]._compact_mixins.size();
+            size_t batch_end = batch_begin + 1;
+            while (batch_end != collections.size() && collections[batch_end]._compact_mixins.size() == size)
+            {
+                ++batch_end;
+            }
+
+            exec->run(batch_end - batch_begin, [&](size_t i)
+            {
+                dom.get_object_type_info(std::move(collections[batch_begin + i]))->unpin();
+            });
+
+            batch_begin = batch_end;
+        }
+
+        return result;
+    }
+#else
+    (void)exec;
+#endif
+
+    for (auto& mixins : collections)
+    {
+        dom.get_object_type_info(std::move(mixins))->unpin();
+    }
+
+    return result;
+}
+
+type_manifest_load_result load_type_manifest(const char* path, executor* exec)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return type_manifest_load_result();
+    return load_type_manifest(in, exec);
+}
+
+} // namespace dynamix
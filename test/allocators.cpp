@@ -44,6 +44,14 @@ size_t alloc_counter<T>::mixin_deallocations;
 
 const object* the_object = nullptr;
 
+// checks whether a buffer is in the object (its inline buffer) and thus not allocated
+bool in_object(const object& o, const void* buf)
+{
+    const char* begin = reinterpret_cast<const char*>(&o);
+    const char* p = static_cast<const char*>(buf);
+    return p >= begin && p < begin + sizeof(object);
+}
+
 template <typename T>
 struct custom_allocator : public domain_allocator, public alloc_counter<T>
 {
@@ -136,6 +144,11 @@ TEST_CASE("allocators")
     CHECK(alloc_counter<custom_alloc_2>::mixin_allocations == 0);
     CHECK(alloc_counter<custom_alloc_var>::mixin_allocations == 0);
 
+    // with DYNAMIX_OBJECT_INLINE_BUFFER_SIZE the mixin data and the global mixins
+    // may be in the object and not allocated
+    size_t global_data_allocations = 0;
+    size_t global_mixin_allocations = 0;
+
     {
         object o;
         the_object = &o;
@@ -147,15 +160,18 @@ TEST_CASE("allocators")
             .add<custom_2_b>()
             .add<custom_own_var>();
 
-        CHECK(alloc_counter<global_alloc>::data_allocations == 1);
-        CHECK(alloc_counter<global_alloc>::mixin_allocations == 2); // two global mixins
+        global_data_allocations = in_object(o, o._mixin_data) ? 0 : 1;
+        global_mixin_allocations = size_t(!in_object(o, o.get<normal_a>())) + size_t(!in_object(o, o.get<normal_b>()));
+
+        CHECK(alloc_counter<global_alloc>::data_allocations == global_data_allocations);
+        CHECK(alloc_counter<global_alloc>::mixin_allocations == global_mixin_allocations); // two global mixins
         CHECK(alloc_counter<custom_alloc_1>::mixin_allocations == 1); // one of these
         CHECK(alloc_counter<custom_alloc_2>::mixin_allocations == 2); // two of these
         CHECK(alloc_counter<custom_alloc_var>::mixin_allocations == 1); // one of these
     }
 
-    CHECK(alloc_counter<global_alloc>::data_deallocations == 1);
-    CHECK(alloc_counter<global_alloc>::mixin_deallocations == 2); // two global mixins
+    CHECK(alloc_counter<global_alloc>::data_deallocations == global_data_allocations);
+    CHECK(alloc_counter<global_alloc>::mixin_deallocations == global_mixin_allocations); // two global mixins
     CHECK(alloc_counter<custom_alloc_1>::mixin_deallocations == 1); // one of these
     CHECK(alloc_counter<custom_alloc_2>::mixin_deallocations == 2); // two of these
     CHECK(alloc_counter<custom_alloc_var>::mixin_deallocations == 1); // one of these
@@ -167,6 +183,8 @@ TEST_CASE("allocators")
             .add<normal_a>()
             .add<custom_1>()
             .add<custom_2_a>();
+        const size_t o1_data = in_object(o1, o1._mixin_data) ? 0 : 1;
+        const size_t o1_mixins = size_t(!in_object(o1, o1.get<normal_a>()));
 
         object o2;
         the_object = &o2;
@@ -174,12 +192,16 @@ TEST_CASE("allocators")
             .add<normal_a>()
             .add<custom_1>()
             .add<custom_2_a>();
+        const size_t o2_data = in_object(o2, o2._mixin_data) ? 0 : 1;
+        const size_t o2_mixins = size_t(!in_object(o2, o2.get<normal_a>()));
 
         object o3;
         the_object = &o3;
         mutate(o3)
             .add<normal_b>()
             .add<custom_2_b>();
+        const size_t o3_data = in_object(o3, o3._mixin_data) ? 0 : 1;
+        const size_t o3_mixins = size_t(!in_object(o3, o3.get<normal_b>()));
 
         the_object = &o1;
         mutate(o1)
@@ -187,11 +209,21 @@ TEST_CASE("allocators")
             .add<normal_b>()
             .remove<custom_2_a>()
             .add<custom_2_b>();
+        const size_t o1_new_data = in_object(o1, o1._mixin_data) ? 0 : 1;
+        const size_t o1_new_mixins = size_t(!in_object(o1, o1.get<normal_b>()));
+
+        // the first object and the old type of the changed object
+        const size_t global_data_deallocations = global_data_allocations + o1_data;
+        const size_t global_mixin_deallocations = global_mixin_allocations + o1_mixins;
+
+        global_data_allocations += o1_data + o2_data + o3_data + o1_new_data;
+        global_mixin_allocations += o1_mixins + o2_mixins + o3_mixins + o1_new_mixins;
 
-        CHECK(alloc_counter<global_alloc>::data_allocations == 5); // 1 + 4 new objects
-        CHECK(alloc_counter<global_alloc>::data_deallocations == 2); // 1 + 1 changed object
+        CHECK(alloc_counter<global_alloc>::data_allocations == global_data_allocations); // 1 + 4 new objects
+        CHECK(alloc_counter<global_alloc>::data_deallocations == global_data_deallocations); // 1 + 1 changed object
+        CHECK(alloc_counter<global_alloc>::mixin_deallocations == global_mixin_deallocations); // 2 + 1 removed mixin
 
-        CHECK(alloc_counter<global_alloc>::mixin_allocations == 6); // 2 + 4
+        CHECK(alloc_counter<global_alloc>::mixin_allocations == global_mixin_allocations); // 2 + 4
         CHECK(alloc_counter<custom_alloc_1>::mixin_allocations == 3); // 1 + 3
         CHECK(alloc_counter<custom_alloc_2>::mixin_allocations == 6); // 2 + 4
         CHECK(alloc_counter<custom_alloc_var>::mixin_allocations == 1); // 1 + 0
@@ -199,9 +231,10 @@ TEST_CASE("allocators")
         the_object = nullptr;
     }
 
-    CHECK(alloc_counter<global_alloc>::data_deallocations == 5);
+    CHECK(alloc_counter<global_alloc>::data_deallocations == global_data_allocations);
+    CHECK(alloc_counter<global_alloc>::mixin_deallocations == global_mixin_allocations);
 
-    CHECK(alloc_counter<global_alloc>::mixin_allocations == 6); // 2 + 4
+    CHECK(alloc_counter<global_alloc>::mixin_allocations == global_mixin_allocations); // 2 + 4
     CHECK(alloc_counter<custom_alloc_1>::mixin_allocations == 3); // 1 + 3
     CHECK(alloc_counter<custom_alloc_2>::mixin_allocations == 6); // 2 + 4
     CHECK(alloc_counter<custom_alloc_var>::mixin_allocations == 1); // 1 + 0
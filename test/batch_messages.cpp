@@ -0,0 +1,162 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include <dynamix/core.hpp>
+#include <dynamix/bulk_call.hpp>
+
+#include <vector>
+
+#include "doctest/doctest.h"
+
+TEST_SUITE_BEGIN("batch messages");
+
+using namespace dynamix;
+
+DYNAMIX_DECLARE_MIXIN(batched);
+DYNAMIX_DECLARE_MIXIN(single);
+DYNAMIX_DECLARE_MIXIN(batched_tracer);
+DYNAMIX_DECLARE_MIXIN(single_tracer);
+
+DYNAMIX_MESSAGE_1(void, add, int, n);
+DYNAMIX_CONST_MESSAGE_0(int, get);
+DYNAMIX_CONST_MULTICAST_MESSAGE_1(void, trace, std::vector<int>&, log);
+
+// sizes of the batches with which the batch functions were called
+static std::vector<size_t> batches;
+
+TEST_CASE("unicast")
+{
+    std::vector<object> objects(200);
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        if (i < 100 || i >= 150)
+            mutate(objects[i]).add<batched>();
+        else
+            mutate(objects[i]).add<single>();
+    }
+
+    batches.clear();
+    call_all(add_msg, objects, 2);
+
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        CHECK(get(objects[i]) == 2);
+    }
+
+    // runs are split in chunks of bulk_call_batch_size
+    std::vector<size_t> expected = { 64, 36, 50 };
+    CHECK(batches == expected);
+
+    // single calls use the method
+    batches.clear();
+    add(objects[0], 1);
+    CHECK(get(objects[0]) == 3);
+    CHECK(batches.empty());
+
+    std::vector<object*> pointers;
+    for (auto& o : objects)
+    {
+        pointers.push_back(&o);
+    }
+
+    call_all(add_msg, pointers.begin() + 95, pointers.begin() + 155, 1);
+    expected = { 5, 5 };
+    CHECK(batches == expected);
+    CHECK(get(objects[94]) == 2);
+    CHECK(get(objects[95]) == 3);
+    CHECK(get(objects[120]) == 3);
+    CHECK(get(objects[154]) == 3);
+    CHECK(get(objects[155]) == 2);
+}
+
+TEST_CASE("multicast")
+{
+    std::vector<object> objects(3);
+    for (auto& o : objects)
+    {
+        mutate(o).add<batched_tracer>().add<single_tracer>();
+    }
+
+    object other;
+    mutate(other).add<single_tracer>();
+
+    batches.clear();
+    std::vector<int> log;
+    call_all(trace_msg, objects, log);
+
+    // the messages of the chain are called for the whole run, one after the other
+    std::vector<int> expected = { 1, 1, 1, 2, 2, 2 };
+    CHECK(log == expected);
+    CHECK(batches.size() == 1);
+
+    // the order of the chain for a single object is the same
+    log.clear();
+    trace(objects[0], log);
+    expected = { 1, 2 };
+    CHECK(log == expected);
+
+    // objects without batch implementations are called one by one
+    log.clear();
+    std::vector<object*> pointers = { &other, &objects[0], &objects[1], &other };
+    call_all(trace_msg, pointers, log);
+    expected = { 2, 1, 1, 2, 2, 2 };
+    CHECK(log == expected);
+}
+
+class batched
+{
+public:
+    void add(int n) { _value += n; }
+    int get() const { return _value; }
+
+    static void add_batch(void* const* mixins, size_t num, int n)
+    {
+        batches.push_back(num);
+        for (size_t i = 0; i < num; ++i)
+        {
+            static_cast<batched*>(mixins[i])->_value += n;
+        }
+    }
+private:
+    int _value = 0;
+};
+
+class single
+{
+public:
+    void add(int n) { _value += n; }
+    int get() const { return _value; }
+private:
+    int _value = 0;
+};
+
+class batched_tracer
+{
+public:
+    void trace(std::vector<int>& log) const { log.push_back(1); }
+
+    static void trace_batch(void* const*, size_t num, std::vector<int>& log)
+    {
+        batches.push_back(num);
+        log.insert(log.end(), num, 1);
+    }
+};
+
+class single_tracer
+{
+public:
+    void trace(std::vector<int>& log) const { log.push_back(2); }
+};
+
+DYNAMIX_DEFINE_MIXIN(batched, batch(add_msg, batched::add_batch) & get_msg);
+DYNAMIX_DEFINE_MIXIN(single, add_msg & get_msg);
+DYNAMIX_DEFINE_MIXIN(batched_tracer, priority(1, batch(trace_msg, batched_tracer::trace_batch)));
+DYNAMIX_DEFINE_MIXIN(single_tracer, trace_msg);
+
+DYNAMIX_DEFINE_MESSAGE(add);
+DYNAMIX_DEFINE_MESSAGE(get);
+DYNAMIX_DEFINE_MESSAGE(trace);
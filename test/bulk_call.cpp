@@ -0,0 +1,208 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include <dynamix/core.hpp>
+#include <dynamix/bulk_call.hpp>
+#include <dynamix/combinators.hpp>
+
+#include "doctest/doctest.h"
+
+TEST_SUITE_BEGIN("bulk call");
+
+using namespace dynamix;
+
+DYNAMIX_DECLARE_MIXIN(counter);
+DYNAMIX_DECLARE_MIXIN(doubler);
+DYNAMIX_DECLARE_MIXIN(logger);
+
+DYNAMIX_MESSAGE_1(void, add, int, n);
+DYNAMIX_CONST_MESSAGE_0(int, get);
+DYNAMIX_CONST_MULTICAST_MESSAGE_1(void, trace, int&, num_calls);
+DYNAMIX_CONST_MULTICAST_MESSAGE_0(int, value);
+
+TEST_CASE("unicast")
+{
+    std::vector<object> objects(10);
+
+    // mix the types so that we have runs of different lengths
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        if (i < 4 || i == 7)
+            mutate(objects[i]).add<counter>();
+        else
+            mutate(objects[i]).add<doubler>();
+    }
+
+    call_all(add_msg, objects, 3);
+
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        if (i < 4 || i == 7)
+            CHECK(get(objects[i]) == 3);
+        else
+            CHECK(get(objects[i]) == 6);
+    }
+
+    std::vector<object*> pointers;
+    for (auto& o : objects)
+    {
+        pointers.push_back(&o);
+    }
+
+    call_all(add_msg, pointers.begin() + 2, pointers.begin() + 5, 1);
+
+    CHECK(get(objects[1]) == 3);
+    CHECK(get(objects[2]) == 4);
+    CHECK(get(objects[3]) == 4);
+    CHECK(get(objects[4]) == 8);
+    CHECK(get(objects[5]) == 6);
+
+    // empty range
+    call_all(add_msg, pointers.begin(), pointers.begin(), 1);
+    CHECK(get(objects[0]) == 3);
+}
+
+TEST_CASE("multicast")
+{
+    std::vector<object> objects(5);
+
+    mutate(objects[0]).add<counter>().add<logger>();
+    mutate(objects[1]).add<counter>().add<logger>();
+    mutate(objects[2]).add<logger>();
+    mutate(objects[3]).add<counter>().add<logger>();
+    mutate(objects[4]).add<doubler>();
+
+    int num_calls = 0;
+    call_all(trace_msg, objects.begin(), objects.begin() + 4, num_calls);
+    CHECK(num_calls == 7);
+
+    std::vector<const object*> pointers = { &objects[3], &objects[2], &objects[3] };
+    num_calls = 0;
+    call_all(trace_msg, pointers, num_calls);
+    CHECK(num_calls == 5);
+}
+
+TEST_CASE("combine")
+{
+    std::vector<object> objects(6);
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        mutate(objects[i]).add<counter>();
+        if (i >= 2) mutate(objects[i]).add<logger>();
+    }
+
+    call_all(add_msg, objects, 2);
+
+    // counter values are 2, logger values are 10
+    combinators::sum<int> total;
+    combine_all(value_msg, objects, total);
+    CHECK(total.result() == 6 * 2 + 4 * 10);
+
+    combinators::mean<int> avg;
+    combine_all(value_msg, objects.begin(), objects.begin() + 3, avg);
+    CHECK(avg.result() == (3 * 2 + 10) / 4);
+
+    // the same as calling it for each object
+    combinators::mean<int> avg_loop;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        value(objects[i], avg_loop);
+    }
+    CHECK(avg_loop.result() == avg.result());
+
+    combinators::boolean_and<int> all;
+    combine_all(value_msg, objects, all);
+    CHECK(all.result());
+}
+
+TEST_CASE("merge combinators")
+{
+    combinators::sum<int> sums[7];
+    for (int i = 0; i < 7; ++i)
+    {
+        sums[i].add_result(i + 1);
+    }
+
+    combinators::sum<int> total;
+    total.add_result(100);
+    total.merge(sums[0]);
+    CHECK(total.result() == 101);
+    internal::merge_combinators(total, sums + 1, 6);
+    CHECK(total.result() == 128);
+
+    combinators::mean<double> means[5];
+    for (int i = 0; i < 5; ++i)
+    {
+        means[i].set_num_results(2);
+        means[i].add_result(i);
+        means[i].add_result(i + 1);
+    }
+
+    combinators::mean<double> avg;
+    internal::merge_combinators(avg, means, 5);
+    CHECK(avg.result() == doctest::Approx(2.5));
+
+    combinators::boolean_or<int> ors[3];
+    ors[1].add_result(1);
+    combinators::boolean_or<int> any;
+    internal::merge_combinators(any, ors, 1);
+    CHECK(!any.result());
+    internal::merge_combinators(any, ors + 1, 2);
+    CHECK(any.result());
+}
+
+#if DYNAMIX_USE_EXCEPTIONS
+TEST_CASE("bad call")
+{
+    std::vector<object> objects(3);
+    mutate(objects[0]).add<counter>();
+    mutate(objects[1]).add<logger>();
+    mutate(objects[2]).add<counter>();
+
+    CHECK_THROWS_AS(call_all(add_msg, objects, 1), bad_message_call);
+
+    // the objects before the bad one have been processed
+    CHECK(get(objects[0]) == 1);
+    CHECK(get(objects[2]) == 0);
+}
+#endif
+
+class counter
+{
+public:
+    void add(int n) { _value += n; }
+    int get() const { return _value; }
+    void trace(int& num_calls) const { ++num_calls; }
+    int value() const { return _value; }
+private:
+    int _value = 0;
+};
+
+class doubler
+{
+public:
+    void add(int n) { _value += 2 * n; }
+    int get() const { return _value; }
+private:
+    int _value = 0;
+};
+
+class logger
+{
+public:
+    void trace(int& num_calls) const { ++num_calls; }
+    int value() const { return 10; }
+};
+
+DYNAMIX_DEFINE_MIXIN(counter, add_msg & get_msg & trace_msg & value_msg);
+DYNAMIX_DEFINE_MIXIN(doubler, add_msg & get_msg);
+DYNAMIX_DEFINE_MIXIN(logger, trace_msg & value_msg);
+
+DYNAMIX_DEFINE_MESSAGE(add);
+DYNAMIX_DEFINE_MESSAGE(get);
+DYNAMIX_DEFINE_MESSAGE(trace);
+DYNAMIX_DEFINE_MESSAGE(value);
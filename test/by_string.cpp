@@ -8,6 +8,8 @@
 #include <dynamix/core.hpp>
 #include <dynamix/object_type_template.hpp>
 #include <algorithm>
+#include <cstring>
+#include <string>
 #include "doctest/doctest.h"
 
 using namespace dynamix;
@@ -125,4 +127,67 @@ TEST_CASE("mixin_names")
     CHECK(!o.has("other_mixin"));
     CHECK(!o.has("3rd"));
     CHECK(!o.has("unused"));
-}
\ No newline at end of file
+}
+TEST_CASE("mixin_name_handles")
+{
+    const mixin_name_handle a("mixin_a");
+    const mixin_name_handle o3("3rd");
+    const mixin_name_handle u("unused");
+    const mixin_name_handle unknown("not_a_mixin");
+
+    CHECK(a.is_registered());
+    CHECK(a.id() == internal::domain::instance().get_mixin_id_by_name("mixin_a"));
+    CHECK(strcmp(a.name(), "mixin_a") == 0);
+    CHECK(!unknown.is_registered());
+    CHECK(unknown.id() == INVALID_MIXIN_ID);
+    CHECK(!mixin_name_handle().is_registered());
+
+    // the names are interned
+    CHECK(mixin_name_handle("mixin_a") == a);
+    CHECK(mixin_name_handle("mixin_a").name() == a.name());
+    CHECK(mixin_name_handle("not_a_mixin") == unknown);
+    CHECK(a != o3);
+
+    object_type_template tmpl;
+    CHECK(tmpl.add(a));
+    CHECK(tmpl.add(o3));
+    CHECK(!tmpl.add(unknown));
+    tmpl.create();
+
+    object o(tmpl);
+    CHECK(o.has(a));
+    CHECK(o.has(o3));
+    CHECK(!o.has(u));
+    CHECK(!o.has(unknown));
+    CHECK(o.get(a) == o.get<mixin_a>());
+    CHECK(o.get(u) == nullptr);
+
+    single_object_mutator mutator(o);
+    CHECK(mutator.remove(o3));
+    CHECK(!mutator.remove(unknown));
+    mutator.apply();
+    CHECK(!o.has(o3));
+
+    // a handle made before the mixin is registered gets its id
+    std::string name = "late_mixin";
+    const mixin_name_handle late(name.c_str());
+    CHECK(!late.is_registered());
+
+    mixin_type_info info;
+    info.name = name.c_str();
+    info.size = 1;
+    info.alignment = 1;
+    info.constructor = [](void*) {};
+    info.destructor = [](void*) {};
+    auto& dom = internal::domain::safe_instance();
+    dom.register_mixin_type(info);
+    CHECK(late.id() == info.id);
+
+    single_object_mutator(o).add(late);
+    CHECK(o.has(late));
+    o.clear();
+    dom.garbage_collect_type_infos();
+
+    dom.unregister_mixin_type(info);
+    CHECK(!late.is_registered());
+}
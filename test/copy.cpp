@@ -13,6 +13,17 @@ TEST_SUITE_BEGIN("obj copying");
 
 using namespace dynamix;
 
+namespace
+{
+// checks whether a mixin is in the object (its inline buffer)
+bool in_object(const object& o, const void* mixin)
+{
+    const char* begin = reinterpret_cast<const char*>(&o);
+    const char* p = static_cast<const char*>(mixin);
+    return p >= begin && p < begin + sizeof(object);
+}
+}
+
 class trivial_copy
 {
 public:
@@ -107,18 +118,24 @@ TEST_CASE("obj_copy")
     CHECK(c2.get<special_copy>()->cc == 0);
     CHECK(c2.get<special_copy>()->a == 1);
 
+    // the kept mixins are moved when the object changes type if they are in its inline buffer
+    // special_copy has no move constructor and is moved with its copy constructor
+    // which resets the assignment count
+    bool moved = in_object(c1, c1.get<special_copy>());
     c1.copy_from(osrc2);
     CHECK(c1._type_info == osrc2._type_info);
     CHECK(c1.get<special_copy>()->i == 5);
     CHECK(c1.get<special_copy>()->cc == 1);
-    CHECK(c1.get<special_copy>()->a == 2);
+    CHECK(c1.get<special_copy>()->a == (moved ? 1 : 2));
 
+    moved = in_object(c1, c1.get<special_copy>());
+    const int a = c1.get<special_copy>()->a;
     c1.copy_from(osrc1);
     CHECK(c1._type_info == osrc1._type_info);
     CHECK(c1.get<trivial_copy>()->i == 2);
     CHECK(c1.get<special_copy>()->i == 7);
     CHECK(c1.get<special_copy>()->cc == 1);
-    CHECK(c1.get<special_copy>()->a == 3);
+    CHECK(c1.get<special_copy>()->a == (moved ? 1 : a + 1));
 }
 
 TEST_CASE("obj_copy_fail")
@@ -202,17 +219,23 @@ TEST_CASE("obj_copy_ctor")
     CHECK(c1.get<special_copy>()->cc == 1);
     CHECK(c1.get<special_copy>()->a == 1);
 
+    // the kept mixins are moved when the object changes type if they are in its inline buffer
+    // special_copy has no move constructor and is moved with its copy constructor
+    // which resets the assignment count
+    bool moved = in_object(c1, c1.get<special_copy>());
     c1 = osrc2;
     CHECK(c1._type_info == osrc2._type_info);
     CHECK(c1.get<special_copy>()->i == 5);
     CHECK(c1.get<special_copy>()->cc == 1);
-    CHECK(c1.get<special_copy>()->a == 2);
+    CHECK(c1.get<special_copy>()->a == (moved ? 1 : 2));
 
+    moved = in_object(c1, c1.get<special_copy>());
+    const int a = c1.get<special_copy>()->a;
     c1 = osrc1;
     CHECK(c1._type_info == osrc1._type_info);
     CHECK(c1.get<trivial_copy>()->i == 2);
     CHECK(c1.get<special_copy>()->i == 7);
     CHECK(c1.get<special_copy>()->cc == 1);
-    CHECK(c1.get<special_copy>()->a == 3);
+    CHECK(c1.get<special_copy>()->a == (moved ? 1 : a + 1));
 }
 #endif
@@ -0,0 +1,260 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include <dynamix/core.hpp>
+#include <dynamix/object_type_template.hpp>
+#include <dynamix/same_type_mutator.hpp>
+#include <dynamix/common_mutation_rules.hpp>
+#include <dynamix/allocators.hpp>
+#include <dynamix/exception.hpp>
+
+#include "doctest/doctest.h"
+
+#include "test_mixins.hpp"
+
+#include <memory>
+#include <thread>
+#include <vector>
+#include <new>
+
+TEST_SUITE_BEGIN("domains");
+
+using namespace dynamix;
+using internal::domain;
+
+namespace
+{
+struct counting_allocator : public internal::default_allocator
+{
+    virtual char* alloc_mixin_data(size_t count, const object* obj) override
+    {
+        ++data_allocations;
+        return default_allocator::alloc_mixin_data(count, obj);
+    }
+
+    virtual std::pair<char*, size_t> alloc_mixin(const mixin_type_info& info, const object* obj) override
+    {
+        ++mixin_allocations;
+        return default_allocator::alloc_mixin(info, obj);
+    }
+
+    size_t data_allocations = 0;
+    size_t mixin_allocations = 0;
+};
+
+size_t num_type_infos(domain& dom)
+{
+    return dom.gc_stats().num_type_infos;
+}
+
+// checks whether a buffer is in the object (its inline buffer) and thus not allocated
+bool in_object(const object& o, const void* buf)
+{
+    const char* begin = reinterpret_cast<const char*>(&o);
+    const char* p = static_cast<const char*>(buf);
+    return p >= begin && p < begin + sizeof(object);
+}
+}
+
+TEST_CASE("separate types")
+{
+    auto& def = domain::safe_instance();
+    CHECK(def.is_default());
+
+    domain shard;
+    CHECK(!shard.is_default());
+
+    object o1;
+    mutate(o1).add<a>().add<b>();
+    CHECK(&o1.bound_domain() == &def);
+
+    object o2(shard);
+    CHECK(&o2.bound_domain() == &shard);
+    mutate(o2).add<a>().add<b>();
+    CHECK(o2.has<a>());
+    CHECK(o2.has<b>());
+
+    // the same mixins, but a type of each domain
+    CHECK(&o1.type_info() != &o2.type_info());
+    CHECK(o1.type_info()._domain == &def);
+    CHECK(o2.type_info()._domain == &shard);
+    CHECK(num_type_infos(shard) == 1);
+
+    // objects of a domain share its types
+    object o3(shard);
+    mutate(o3).add<b>().add<a>();
+    CHECK(&o3.type_info() == &o2.type_info());
+    CHECK(num_type_infos(shard) == 1);
+
+    // moves and copies bind to the domain of the source
+    object o4(std::move(o3));
+    CHECK(&o4.bound_domain() == &shard);
+    CHECK(&o4.type_info() == &o2.type_info());
+
+    object o5;
+    o5 = o4.copy();
+    CHECK(&o5.bound_domain() == &shard);
+
+    o1.clear();
+    o2.clear();
+    o4.clear();
+    o5.clear();
+    shard.garbage_collect_type_infos();
+    CHECK(num_type_infos(shard) == 0);
+
+    def.garbage_collect_type_infos();
+}
+
+TEST_CASE("templates and mutators")
+{
+    domain shard;
+
+    object_type_template tmpl(shard);
+    tmpl.add<a>().add<c>();
+    tmpl.create();
+    CHECK(&tmpl.bound_domain() == &shard);
+
+    object o(tmpl);
+    CHECK(&o.bound_domain() == &shard);
+    CHECK(o.has<a>());
+    CHECK(o.has<c>());
+    CHECK(o.type_info()._domain == &shard);
+
+#if DYNAMIX_USE_EXCEPTIONS
+    // objects of other domains can't get the types of the template
+    object other;
+    CHECK_THROWS_AS(tmpl.apply_to(other), bad_mutation_source);
+#endif
+
+    object o2(shard);
+    tmpl.apply_to(o2);
+
+    same_type_mutator mutator(&o.type_info());
+    mutator.remove<c>();
+    mutator.apply_to(o);
+    mutator.apply_to(o2);
+    CHECK(!o.has<c>());
+    CHECK(&o.type_info() == &o2.type_info());
+    CHECK(o.type_info()._domain == &shard);
+}
+
+TEST_CASE("mutation rules")
+{
+    domain shard;
+    shard.add_mutation_rule(std::make_shared<mandatory_mixin<c>>());
+
+    object o1(shard);
+    mutate(o1).add<a>();
+    CHECK(o1.has<a>());
+    CHECK(o1.has<c>());
+
+    // the rules of a domain don't apply to the others
+    object o2;
+    mutate(o2).add<a>();
+    CHECK(o2.has<a>());
+    CHECK(!o2.has<c>());
+
+    o2.clear();
+    domain::safe_instance().garbage_collect_type_infos();
+}
+
+TEST_CASE("allocator")
+{
+    counting_allocator alloc;
+    domain shard;
+    shard.set_allocator(&alloc);
+
+    {
+        object o(shard);
+        mutate(o).add<a>().add<b>();
+        // with DYNAMIX_OBJECT_INLINE_BUFFER_SIZE the small objects aren't allocated
+        const size_t data_allocations = in_object(o, o._mixin_data) ? 0 : 1;
+        const size_t mixin_allocations = size_t(!in_object(o, o.get<a>())) + size_t(!in_object(o, o.get<b>()));
+        CHECK(alloc.data_allocations == data_allocations);
+        CHECK(alloc.mixin_allocations == mixin_allocations);
+
+        // the default domain is unaffected
+        object o2;
+        mutate(o2).add<a>();
+        CHECK(alloc.data_allocations == data_allocations);
+        CHECK(alloc.mixin_allocations == mixin_allocations);
+    }
+
+    domain::safe_instance().garbage_collect_type_infos();
+}
+
+TEST_CASE("unregistering mixins")
+{
+    auto& def = domain::safe_instance();
+    domain shard;
+
+    mixin_type_info info;
+    info.name = "domain_test_mixin";
+    info.size = sizeof(int);
+    info.alignment = alignof(int);
+    info.constructor = [](void* mem) { new (mem) int(0); };
+    info.destructor = [](void*) {};
+    def.register_mixin_type(info);
+
+    {
+        object o(shard);
+        single_object_mutator(o).add(info.id);
+        mutate(o).add<a>();
+        CHECK(o.has(info.id));
+    }
+    CHECK(num_type_infos(shard) == 2);
+
+    // the types with the mixin are removed from all domains
+    def.unregister_mixin_type(info);
+    CHECK(num_type_infos(shard) == 0);
+}
+
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+TEST_CASE("threads")
+{
+    const size_t num_threads = 4;
+    std::vector<std::unique_ptr<domain>> shards;
+    for (size_t i = 0; i < num_threads; ++i)
+    {
+        shards.emplace_back(new domain);
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<int> ok(num_threads, 0);
+    for (size_t t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([&shards, &ok, t]()
+        {
+            domain& shard = *shards[t];
+            object_type_template tmpl(shard);
+            tmpl.add<a>().add<b>();
+            tmpl.create();
+
+            std::vector<object> objects;
+            for (int i = 0; i < 100; ++i)
+            {
+                objects.emplace_back(tmpl);
+                mutate(objects.back()).add<c>();
+                mutate(objects.back()).remove<a>();
+            }
+
+            ok[t] = objects.back().has<b>() && objects.back().has<c>() && !objects.back().has<a>()
+                && objects.back().type_info()._domain == &shard;
+        });
+    }
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    for (size_t t = 0; t < num_threads; ++t)
+    {
+        CHECK(ok[t]);
+    }
+}
+#endif
@@ -0,0 +1,213 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include <dynamix/core.hpp>
+#include <dynamix/allocators.hpp>
+
+#include "doctest/doctest.h"
+
+#include <string>
+
+// the test needs a buffer which fits the mixin data and two small mixins
+#if DYNAMIX_OBJECT_INLINE_BUFFER_SIZE >= 128
+
+TEST_SUITE_BEGIN("inline buffer");
+
+using namespace dynamix;
+using internal::domain;
+
+namespace
+{
+struct counting_allocator : public single_block_allocator
+{
+    virtual char* alloc_mixin_data(size_t count, const object* obj) override
+    {
+        ++data_allocations;
+        return single_block_allocator::alloc_mixin_data(count, obj);
+    }
+
+    virtual std::pair<char*, size_t> alloc_mixin(const mixin_type_info& info, const object* obj) override
+    {
+        ++mixin_allocations;
+        return single_block_allocator::alloc_mixin(info, obj);
+    }
+
+    virtual char* alloc_object_block(size_t size, const object* obj) override
+    {
+        if (!blocks) return nullptr;
+        ++block_allocations;
+        return single_block_allocator::alloc_object_block(size, obj);
+    }
+
+    bool blocks = false;
+    size_t data_allocations = 0;
+    size_t mixin_allocations = 0;
+    size_t block_allocations = 0;
+};
+
+bool is_inline(const object& o, const void* mixin)
+{
+    const char* begin = reinterpret_cast<const char*>(&o);
+    const char* p = static_cast<const char*>(mixin);
+    return p >= begin && p < begin + sizeof(object);
+}
+}
+
+DYNAMIX_DECLARE_MIXIN(id);
+DYNAMIX_DECLARE_MIXIN(tag);
+DYNAMIX_DECLARE_MIXIN(big);
+DYNAMIX_DECLARE_MIXIN(fixed);
+
+DYNAMIX_MESSAGE_0(int, get_id);
+
+class id
+{
+public:
+    int get_id() { return value; }
+    int value = 0;
+};
+
+class tag {};
+
+class big
+{
+public:
+    char data[256];
+    std::string name = "big";
+};
+
+class fixed
+{
+public:
+    fixed() = default;
+    fixed(const fixed&) = delete;
+    fixed& operator=(const fixed&) = delete;
+};
+
+TEST_CASE("small objects")
+{
+    domain dom;
+    counting_allocator alloc;
+    dom.set_allocator(&alloc);
+
+    object o(dom);
+    mutate(o).add<id>().add<tag>();
+    CHECK(alloc.data_allocations == 0);
+    CHECK(alloc.mixin_allocations == 0);
+    CHECK(is_inline(o, o._mixin_data));
+    CHECK(is_inline(o, o.get<id>()));
+    CHECK(is_inline(o, o.get<tag>()));
+    CHECK(object_of(o.get<id>()) == &o);
+
+    o.get<id>()->value = 5;
+    CHECK(get_id(o) == 5);
+
+    // the mixins in the buffer are moved with the object
+    object o2 = std::move(o);
+    CHECK(o.empty());
+    CHECK(is_inline(o2, o2.get<id>()));
+    CHECK(object_of(o2.get<id>()) == &o2);
+    CHECK(get_id(o2) == 5);
+
+    object o3(dom);
+    o3.copy_from(o2);
+    CHECK(is_inline(o3, o3.get<id>()));
+    CHECK(get_id(o3) == 5);
+    CHECK(alloc.data_allocations == 0);
+    CHECK(alloc.mixin_allocations == 0);
+
+    // a mutation which still fits
+    mutate(o2).remove<tag>();
+    CHECK(is_inline(o2, o2.get<id>()));
+    CHECK(get_id(o2) == 5);
+    CHECK(alloc.mixin_allocations == 0);
+
+    // mixins which don't fit or can't be moved are allocated
+    mutate(o2).add<big>().add<fixed>();
+    CHECK(alloc.mixin_allocations >= 2);
+    CHECK_FALSE(is_inline(o2, o2.get<big>()));
+    CHECK_FALSE(is_inline(o2, o2.get<fixed>()));
+    CHECK(o2.get<big>()->name == "big");
+    CHECK(get_id(o2) == 5);
+
+    object o4 = std::move(o2);
+    CHECK(get_id(o4) == 5);
+    CHECK(o4.get<big>()->name == "big");
+    CHECK(object_of(o4.get<big>()) == &o4);
+
+    o4.clear();
+    o3.clear();
+    CHECK(_dynamix_get_mixin_type_info((id*)nullptr).num_mixins == 0);
+    CHECK(_dynamix_get_mixin_type_info((big*)nullptr).num_mixins == 0);
+}
+
+TEST_CASE("inline buffer and blocks")
+{
+    domain dom;
+    counting_allocator alloc;
+    alloc.blocks = true;
+    dom.set_allocator(&alloc);
+
+    // the buffer is preferred when the type fits in it
+    object o(dom);
+    mutate(o).add<id>();
+    CHECK(alloc.block_allocations == 0);
+    CHECK(is_inline(o, o.get<id>()));
+    o.get<id>()->value = 3;
+
+    // otherwise the mixins go in a block
+    mutate(o).add<big>();
+    CHECK(alloc.block_allocations == 1);
+    CHECK_FALSE(is_inline(o, o.get<id>()));
+    CHECK(get_id(o) == 3);
+
+    mutate(o).remove<big>();
+    CHECK(is_inline(o, o.get<id>()));
+    CHECK(get_id(o) == 3);
+}
+
+TEST_CASE("object allocators")
+{
+    struct obj_alloc : public object_allocator
+    {
+        virtual char* alloc_mixin_data(size_t count, const object*) override
+        {
+            ++data_allocations;
+            return new char[count * mixin_data_size];
+        }
+        virtual void dealloc_mixin_data(char* ptr, size_t, const object*) override
+        {
+            delete[] ptr;
+        }
+        virtual std::pair<char*, size_t> alloc_mixin(const mixin_type_info& info, const object* obj) override
+        {
+            return _alloc.alloc_mixin(info, obj);
+        }
+        virtual void dealloc_mixin(char* ptr, size_t offset, const mixin_type_info& info, const object* obj) override
+        {
+            _alloc.dealloc_mixin(ptr, offset, info, obj);
+        }
+
+        internal::default_allocator _alloc;
+        size_t data_allocations = 0;
+    } alloc;
+
+    // objects with allocators don't use the buffer
+    object o(&alloc);
+    mutate(o).add<id>();
+    CHECK(alloc.data_allocations == 1);
+    CHECK_FALSE(is_inline(o, o.get<id>()));
+}
+
+DYNAMIX_DEFINE_MIXIN(id, get_id_msg);
+DYNAMIX_DEFINE_MIXIN(tag, none);
+DYNAMIX_DEFINE_MIXIN(big, none);
+DYNAMIX_DEFINE_MIXIN(fixed, none);
+
+DYNAMIX_DEFINE_MESSAGE(get_id);
+
+#endif
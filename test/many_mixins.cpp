@@ -0,0 +1,168 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include <dynamix/core.hpp>
+
+#include "doctest/doctest.h"
+
+#include "test_mixins.hpp"
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <new>
+#include <cstring>
+
+TEST_SUITE_BEGIN("many mixins");
+
+using namespace dynamix;
+
+TEST_CASE("mixin set")
+{
+    internal::mixin_set s1, s2;
+    CHECK(s1 == s2);
+    CHECK(s1.id_bound() == 0);
+
+    CHECK(s1.add(5));
+    CHECK(s1.add(1));
+    CHECK(s1.add(3));
+    CHECK(!s1.add(3));
+
+    CHECK(s2.add(3));
+    CHECK(s2.add(5));
+    CHECK(s2.add(1));
+
+    // the order of additions doesn't matter
+    CHECK(s1 == s2);
+    CHECK(s1.hash() == s2.hash());
+    CHECK(s1.id_bound() == 6);
+    CHECK(std::vector<mixin_id>(s1.begin(), s1.end()) == std::vector<mixin_id>({1, 3, 5}));
+
+    CHECK(s2.remove(5));
+    CHECK(!s2.remove(5));
+    CHECK(!s2.has(5));
+    CHECK(s2.has(3));
+    CHECK(s1 != s2);
+    CHECK(s1.hash() != s2.hash());
+
+    s2.add(5);
+    CHECK(s1 == s2);
+    CHECK(s1.hash() == s2.hash());
+
+    internal::mixin_set s3 = std::move(s2);
+    CHECK(s3 == s1);
+    CHECK(s2.empty());
+    CHECK(s2 == internal::mixin_set());
+
+    s1.clear();
+    CHECK(s1 == s2);
+}
+
+TEST_CASE("more mixins than the initial capacity")
+{
+    auto& dom = internal::domain::safe_instance();
+
+    // mixins registered at run time
+    const size_t num_mixins = DYNAMIX_MAX_MIXINS + 100;
+    std::vector<std::string> names;
+    std::vector<std::unique_ptr<mixin_type_info>> infos;
+    names.reserve(num_mixins);
+    for (size_t i = 0; i < num_mixins; ++i)
+    {
+        names.push_back("runtime_mixin_" + std::to_string(i));
+
+        infos.emplace_back(new mixin_type_info);
+        auto& info = *infos.back();
+        info.name = names.back().c_str();
+        info.size = sizeof(int);
+        info.alignment = alignof(int);
+        info.constructor = [](void* mem) { new (mem) int(42); };
+        info.destructor = [](void*) {};
+        dom.register_mixin_type(info);
+    }
+
+    CHECK(dom.num_registered_mixins() > DYNAMIX_MAX_MIXINS);
+    const mixin_id last = infos.back()->id;
+    CHECK(last >= DYNAMIX_MAX_MIXINS);
+    CHECK(dom.get_mixin_id_by_name(names.back().c_str()) == last);
+
+    {
+        object o;
+        mutate(o).add<a>();
+        const object_type_info& a_type = o.type_info();
+
+        single_object_mutator(o).add(last);
+        CHECK(o.has(last));
+        CHECK(o.has<a>());
+        CHECK(*static_cast<int*>(o.get(last)) == 42);
+
+        // the old type's mixin indices don't reach the new id, but it can still be queried
+        CHECK(!a_type.has(last));
+        CHECK(!a_type.has(*infos.back()));
+
+        // the new type's table is sized for its biggest mixin id
+        CHECK(o.type_info()._mixin_indices.size() >= last + 1);
+
+        object o2;
+        single_object_mutator(o2).add(infos[0]->id);
+        single_object_mutator(o2).add(last);
+        mutate(o2).add<a>();
+        CHECK(&o2.type_info() != &o.type_info());
+        CHECK(o2.has(infos[0]->id));
+
+        single_object_mutator(o2).remove(infos[0]->id);
+        CHECK(&o2.type_info() == &o.type_info());
+
+        mutate(o).remove<a>();
+        CHECK(!o.has<a>());
+        CHECK(o.has(last));
+        CHECK(o.get<a>() == nullptr);
+
+        // ids which aren't registered
+        CHECK(!o.has(last + 1));
+        CHECK(o.get(last + 1) == nullptr);
+    }
+
+    dom.garbage_collect_type_infos();
+
+    for (auto& info : infos)
+    {
+        dom.unregister_mixin_type(*info);
+    }
+}
+
+TEST_CASE("names")
+{
+    auto& dom = internal::domain::safe_instance();
+
+    CHECK(dom.get_mixin_id_by_name("a") == _dynamix_get_mixin_type_info((a*)nullptr).id);
+    CHECK(strcmp(_dynamix_get_mixin_type_info((a*)nullptr).name, "a") == 0);
+    CHECK(dom.get_mixin_id_by_name("no_such_mixin") == INVALID_MIXIN_ID);
+
+    // the name must outlive the registration, but the index keeps its own copy
+    std::string name = "reloaded_mixin";
+    mixin_type_info info;
+    info.name = name.c_str();
+    info.size = sizeof(int);
+    info.alignment = alignof(int);
+    info.constructor = [](void* mem) { new (mem) int(0); };
+    info.destructor = [](void*) {};
+
+    dom.register_mixin_type(info);
+    const mixin_id id = info.id;
+    CHECK(dom.get_mixin_id_by_name("reloaded_mixin") == id);
+
+    dom.unregister_mixin_type(info);
+    CHECK(dom.get_mixin_id_by_name("reloaded_mixin") == INVALID_MIXIN_ID);
+
+    // as if a plugin was reloaded: the free id is reused
+    info.id = INVALID_MIXIN_ID;
+    dom.register_mixin_type(info);
+    CHECK(info.id == id);
+    CHECK(dom.get_mixin_id_by_name("reloaded_mixin") == id);
+    dom.unregister_mixin_type(info);
+}
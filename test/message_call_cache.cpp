@@ -0,0 +1,66 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+
+// run the core tests with call caches in the unicast messages
+
+#define DYNAMIX_MESSAGE_CALL_CACHE 1
+#define DYNAMIX_MESSAGE_CALL_CACHE_SIZE 2
+
+// the caches are only used by the new-style message macros
+// a custom config file might have chosen the legacy ones
+#include <dynamix/config.hpp>
+#undef DYNAMIX_USE_LEGACY_MESSAGE_MACROS
+
+#include "core.cpp"
+
+#include <thread>
+
+TEST_CASE("message call cache")
+{
+    // more types than the cache size
+    object objects[4];
+    mutate(objects[0]).add<type_checker>();
+    mutate(objects[1]).add<counter>().add<type_checker>();
+    mutate(objects[2]).add<type_checker>().add<no_messages>();
+    mutate(objects[3]).add<type_checker>().add<counter>().add<no_messages>();
+
+    for (int i = 0; i < 3; ++i)
+    {
+        for (auto& o : objects)
+        {
+            CHECK(get_self(o) == o.get<type_checker>());
+        }
+    }
+
+    // the collected types might have their addresses reused by the new ones
+    for (auto& o : objects)
+    {
+        o.clear();
+    }
+    internal::domain::safe_instance().garbage_collect_type_infos();
+
+    mutate(objects[0]).add<no_messages>().add<type_checker>();
+    mutate(objects[1]).add<counter>().add<no_messages>().add<type_checker>();
+    mutate(objects[2]).add<counter>();
+    for (int i = 0; i < 2; ++i)
+    {
+        CHECK(get_self(objects[0]) == objects[0].get<type_checker>());
+        CHECK(get_self(objects[1]) == objects[1].get<type_checker>());
+#if DYNAMIX_USE_EXCEPTIONS
+        CHECK_THROWS_AS(get_self(objects[2]), bad_message_call);
+#endif
+    }
+
+    // each thread has its own cache
+    const void* self = nullptr;
+    std::thread t([&objects, &self]() {
+        self = get_self(objects[1]);
+    });
+    t.join();
+    CHECK(self == objects[1].get<type_checker>());
+}
@@ -0,0 +1,130 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include <dynamix/core.hpp>
+#include <dynamix/message_handle.hpp>
+
+#include "doctest/doctest.h"
+
+TEST_SUITE_BEGIN("message handle");
+
+using namespace dynamix;
+
+DYNAMIX_DECLARE_MIXIN(counter);
+DYNAMIX_DECLARE_MIXIN(doubler);
+DYNAMIX_DECLARE_MIXIN(other);
+
+DYNAMIX_MESSAGE_1(int, add, int, n);
+DYNAMIX_CONST_MESSAGE_0(int, get);
+DYNAMIX_MESSAGE_1(void, take, std::unique_ptr<int>&&, ptr);
+
+TEST_CASE("hits and misses")
+{
+    object o1, o2, o3;
+    mutate(o1).add<counter>();
+    mutate(o2).add<counter>();
+    mutate(o3).add<doubler>();
+
+    message_handle<dynamix_msg_add> h(add_msg);
+    CHECK(h.num_hits() == 0);
+    CHECK(h.num_misses() == 0);
+
+    CHECK(h(o1, 1) == 1);
+    CHECK(h.num_misses() == 1);
+    CHECK(h(o2, 2) == 2);
+    CHECK(h(&o1, 3) == 4);
+    CHECK(h.num_hits() == 2);
+    CHECK(h.num_misses() == 1);
+
+    CHECK(h(o3, 1) == 2);
+    CHECK(h(o1, 1) == 5);
+    CHECK(h.num_hits() == 2);
+    CHECK(h.num_misses() == 3);
+
+    mutate(o1).add<other>();
+    CHECK(h(o1, 1) == 6);
+    CHECK(h.num_misses() == 4);
+
+    const object& co = o2;
+    message_handle<dynamix_msg_get> hget(get_msg);
+    CHECK(hget(co) == 2);
+
+    message_handle<dynamix_msg_take> htake;
+    std::unique_ptr<int> ptr(new int(10));
+    htake(o3, std::move(ptr));
+    CHECK(get(o3) == 12);
+
+    h.reset();
+    CHECK(h.num_hits() == 0);
+    CHECK(h.num_misses() == 0);
+}
+
+TEST_CASE("invalidation")
+{
+    message_handle<dynamix_msg_add> h(add_msg);
+
+    {
+        object o;
+        mutate(o).add<doubler>().add<other>();
+        h(o, 1);
+        h(o, 1);
+        CHECK(h.num_hits() == 1);
+        CHECK(h.num_misses() == 1);
+    }
+
+    internal::domain::safe_instance().garbage_collect_type_infos();
+
+    // a new type info may reuse the address of the collected one
+    object o;
+    mutate(o).add<counter>().add<other>();
+    CHECK(h(o, 3) == 3);
+    CHECK(h.num_hits() == 1);
+    CHECK(h.num_misses() == 2);
+}
+
+#if DYNAMIX_USE_EXCEPTIONS
+TEST_CASE("bad call")
+{
+    object o;
+    mutate(o).add<other>();
+
+    message_handle<dynamix_msg_add> h(add_msg);
+    CHECK_THROWS_AS(h(o, 1), bad_message_call);
+    CHECK(h.num_misses() == 0);
+}
+#endif
+
+class counter
+{
+public:
+    int add(int n) { return _value += n; }
+    int get() const { return _value; }
+private:
+    int _value = 0;
+};
+
+class doubler
+{
+public:
+    int add(int n) { return _value += 2 * n; }
+    int get() const { return _value; }
+    void take(std::unique_ptr<int>&& ptr) { _value += *ptr; }
+private:
+    int _value = 0;
+};
+
+class other
+{
+};
+
+DYNAMIX_DEFINE_MIXIN(counter, add_msg & get_msg);
+DYNAMIX_DEFINE_MIXIN(doubler, add_msg & get_msg & take_msg);
+DYNAMIX_DEFINE_MIXIN(other, none);
+
+DYNAMIX_DEFINE_MESSAGE(add);
+DYNAMIX_DEFINE_MESSAGE(get);
+DYNAMIX_DEFINE_MESSAGE(take);
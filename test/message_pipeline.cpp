@@ -0,0 +1,146 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include <dynamix/core.hpp>
+#include <dynamix/message_pipeline.hpp>
+
+#include <vector>
+
+#include "doctest/doctest.h"
+
+TEST_SUITE_BEGIN("message pipeline");
+
+using namespace dynamix;
+
+DYNAMIX_DECLARE_MIXIN(body);
+DYNAMIX_DECLARE_MIXIN(mind);
+DYNAMIX_DECLARE_MIXIN(other);
+
+DYNAMIX_MESSAGE_1(void, pre_update, std::vector<int>&, log);
+DYNAMIX_MULTICAST_MESSAGE_1(void, update, std::vector<int>&, log);
+DYNAMIX_CONST_MESSAGE_1(void, post_update, std::vector<int>&, log);
+DYNAMIX_MESSAGE_1(void, unused, std::vector<int>&, log);
+
+TEST_CASE("call")
+{
+    object o1, o2, o3;
+    mutate(o1).add<body>().add<mind>();
+    mutate(o2).add<body>();
+    mutate(o3).add<body>().add<mind>();
+
+    message_pipeline<std::vector<int>&> p(pre_update_msg, update_msg, post_update_msg);
+    CHECK(p.num_messages() == 3);
+    CHECK(p.num_compiled_types() == 0);
+
+    std::vector<int> log;
+    p(o1, log);
+    std::vector<int> expected = { 1, 12, 11, 13 };
+    CHECK(log == expected);
+
+    // same as calling them one by one
+    log.clear();
+    pre_update(o1, log);
+    update(o1, log);
+    post_update(o1, log);
+    CHECK(log == expected);
+
+    log.clear();
+    p(&o2, log);
+    expected = { 1, 11, 3 };
+    CHECK(log == expected);
+    CHECK(p.num_compiled_types() == 2);
+
+    log.clear();
+    p(o3, log);
+    expected = { 1, 12, 11, 13 };
+    CHECK(log == expected);
+    CHECK(p.num_compiled_types() == 2);
+
+    std::vector<object*> objects = { &o1, &o3, &o2 };
+    log.clear();
+    p.call_all(objects, log);
+    expected = { 1, 12, 11, 13, 1, 12, 11, 13, 1, 11, 3 };
+    CHECK(log == expected);
+    CHECK(p.num_compiled_types() == 2);
+
+    p.reset();
+    CHECK(p.num_compiled_types() == 0);
+}
+
+TEST_CASE("invalidation")
+{
+    message_pipeline<std::vector<int>&> p(update_msg);
+    std::vector<int> log;
+
+    {
+        object o;
+        mutate(o).add<body>().add<other>();
+        p(o, log);
+        CHECK(p.num_compiled_types() == 1);
+    }
+
+    internal::domain::safe_instance().garbage_collect_type_infos();
+
+    // a new type info may reuse the address of the collected one
+    object o;
+    mutate(o).add<mind>().add<other>();
+    log.clear();
+    p(o, log);
+    std::vector<int> expected = { 12 };
+    CHECK(log == expected);
+    CHECK(p.num_compiled_types() == 1);
+}
+
+#if DYNAMIX_USE_EXCEPTIONS
+TEST_CASE("bad call")
+{
+    object o;
+    mutate(o).add<mind>();
+
+    std::vector<int> log;
+
+    message_pipeline<std::vector<int>&> p(update_msg, pre_update_msg);
+    CHECK_THROWS_AS(p(o, log), bad_message_call);
+    CHECK(log.empty()); // nothing is called
+    CHECK(p.num_compiled_types() == 0);
+
+    message_pipeline<std::vector<int>&> punused(update_msg, unused_msg);
+    CHECK_THROWS_AS(punused(o, log), bad_message_call);
+
+    object empty;
+    message_pipeline<std::vector<int>&> pmulti(update_msg);
+    CHECK_THROWS_AS(pmulti(empty, log), bad_message_call);
+}
+#endif
+
+class body
+{
+public:
+    void pre_update(std::vector<int>& log) { log.push_back(1); }
+    void update(std::vector<int>& log) { log.push_back(11); }
+    void post_update(std::vector<int>& log) const { log.push_back(3); }
+};
+
+class mind
+{
+public:
+    void update(std::vector<int>& log) { log.push_back(12); }
+    void post_update(std::vector<int>& log) const { log.push_back(13); }
+};
+
+class other
+{
+};
+
+DYNAMIX_DEFINE_MIXIN(body, pre_update_msg & update_msg & post_update_msg);
+DYNAMIX_DEFINE_MIXIN(mind, priority(1, update_msg) & priority(1, post_update_msg));
+DYNAMIX_DEFINE_MIXIN(other, none);
+
+DYNAMIX_DEFINE_MESSAGE(pre_update);
+DYNAMIX_DEFINE_MESSAGE(update);
+DYNAMIX_DEFINE_MESSAGE(post_update);
+DYNAMIX_DEFINE_MESSAGE(unused);
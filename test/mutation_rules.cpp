@@ -9,6 +9,7 @@
 #include <dynamix/mutation_rule.hpp>
 #include <dynamix/common_mutation_rules.hpp>
 #include <iostream>
+#include <vector>
 
 #include "doctest/doctest.h"
 
@@ -256,6 +257,108 @@ TEST_CASE("mandatory")
     remove_mutation_rule(0);
 }
 
+TEST_CASE("transitive")
+{
+    // added in the reverse order of application
+    auto b_c = new dependent_mixins;
+    b_c->set_master<b>();
+    b_c->add<c>();
+    auto id_b_c = add_mutation_rule(b_c);
+
+    auto a_b = new dependent_mixins;
+    a_b->set_master<a>();
+    a_b->add<b>();
+    auto id_a_b = add_mutation_rule(a_b);
+
+    object o;
+
+    mutate(o)
+        .add<a>();
+
+    CHECK(o.has<a>());
+    CHECK(o.has<b>());
+    CHECK(o.has<c>());
+
+    mutate(o)
+        .remove<a>();
+
+    CHECK(o.empty());
+
+    remove_mutation_rule(id_a_b);
+    remove_mutation_rule(id_b_c);
+}
+
+TEST_CASE("custom and built-in")
+{
+    // the custom rule adds b and the built-in rule after it reacts to that
+    auto id_custom = add_mutation_rule(new custom_rule());
+
+    auto b_c = new dependent_mixins;
+    b_c->set_master<b>();
+    b_c->add<c>();
+    auto id_b_c = add_mutation_rule(b_c);
+
+    object o;
+
+    mutate(o)
+        .add<a>();
+
+    CHECK(o.has<a>());
+    CHECK(o.has<b>());
+    CHECK(o.has<c>());
+
+    remove_mutation_rule(id_b_c);
+    remove_mutation_rule(id_custom);
+}
+
+TEST_CASE("many rules")
+{
+    std::vector<mutation_rule_id> ids;
+    for (int i = 0; i < 100; ++i)
+    {
+        auto bundle = new bundled_mixins;
+        bundle->add<a>();
+        bundle->add<b>();
+        ids.push_back(add_mutation_rule(bundle));
+
+        auto excl = new mutually_exclusive_mixins;
+        excl->add<b>();
+        excl->add<c>();
+        ids.push_back(add_mutation_rule(excl));
+
+        ids.push_back(add_mutation_rule(new mandatory_mixin<a>()));
+    }
+
+    object o;
+
+    mutate(o)
+        .add<c>();
+
+    // the mandatory a doesn't bring b, since mandatory mixins are applied last
+    CHECK(o.has<a>());
+    CHECK(!o.has<b>());
+    CHECK(o.has<c>());
+
+    mutate(o)
+        .add<b>();
+
+    CHECK(o.has<a>());
+    CHECK(o.has<b>());
+    CHECK(!o.has<c>());
+
+    // a is mandatory, but the bundle has already removed b
+    mutate(o)
+        .remove<a>();
+
+    CHECK(o.has<a>());
+    CHECK(!o.has<b>());
+
+    for (auto id : ids)
+    {
+        remove_mutation_rule(id);
+    }
+}
+
 TEST_CASE("deprecated")
 {
     add_mutation_rule(new deprecated_mixin<a>());
@@ -0,0 +1,322 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include <dynamix/core.hpp>
+#include <dynamix/allocators.hpp>
+
+#include "doctest/doctest.h"
+
+#include <string>
+#include <cstdint>
+
+TEST_SUITE_BEGIN("object block");
+
+using namespace dynamix;
+using internal::domain;
+
+namespace
+{
+struct counting_block_allocator : public single_block_allocator
+{
+    virtual char* alloc_mixin_data(size_t count, const object* obj) override
+    {
+        ++data_allocations;
+        return single_block_allocator::alloc_mixin_data(count, obj);
+    }
+
+    virtual std::pair<char*, size_t> alloc_mixin(const mixin_type_info& info, const object* obj) override
+    {
+        ++mixin_allocations;
+        return single_block_allocator::alloc_mixin(info, obj);
+    }
+
+    virtual char* alloc_object_block(size_t size, const object* obj) override
+    {
+        ++block_allocations;
+        return single_block_allocator::alloc_object_block(size, obj);
+    }
+
+    virtual void dealloc_object_block(char* ptr, size_t size, const object* obj) override
+    {
+        ++block_deallocations;
+        single_block_allocator::dealloc_object_block(ptr, size, obj);
+    }
+
+    size_t data_allocations = 0;
+    size_t mixin_allocations = 0;
+    size_t block_allocations = 0;
+    size_t block_deallocations = 0;
+};
+
+// checks whether a mixin is in the block of its object
+bool in_block(const object& o, const void* mixin)
+{
+    const char* begin = reinterpret_cast<const char*>(o._mixin_data);
+    const char* p = static_cast<const char*>(mixin);
+    return p >= begin && p < begin + o.type_info().object_block_size();
+}
+
+// checks whether a buffer is in the object (its inline buffer) and thus not allocated
+bool in_object(const object& o, const void* buf)
+{
+    const char* begin = reinterpret_cast<const char*>(&o);
+    const char* p = static_cast<const char*>(buf);
+    return p >= begin && p < begin + sizeof(object);
+}
+
+// checks whether the owning object pointer in front of a mixin is aligned
+bool owner_aligned(const void* mixin)
+{
+    return (uintptr_t(mixin) - sizeof(object*)) % alignof(object*) == 0;
+}
+}
+
+DYNAMIX_DECLARE_MIXIN(name);
+DYNAMIX_DECLARE_MIXIN(counter);
+DYNAMIX_DECLARE_MIXIN(fixed);
+DYNAMIX_DECLARE_MIXIN(wide);
+DYNAMIX_DECLARE_MIXIN(letter);
+DYNAMIX_DECLARE_MIXIN(triple);
+DYNAMIX_DECLARE_MIXIN(assigned);
+
+DYNAMIX_MESSAGE_0(const std::string&, get_name);
+DYNAMIX_MESSAGE_0(int, count);
+
+class name
+{
+public:
+    const std::string& get_name() { return value; }
+    std::string value = "default name";
+};
+
+class counter
+{
+public:
+    int count() { return value; }
+    int value = 0;
+#if DYNAMIX_OBJECT_INLINE_BUFFER_SIZE > 0
+    // the types with counter don't fit in the inline buffer of the object, so they use blocks
+    char padding[DYNAMIX_OBJECT_INLINE_BUFFER_SIZE];
+#endif
+};
+
+// can't be moved, so it's never in a block
+class fixed
+{
+public:
+    fixed() = default;
+    fixed(const fixed&) = delete;
+    fixed& operator=(const fixed&) = delete;
+    int value = 0;
+};
+
+struct alignas(64) wide
+{
+    char data[64];
+};
+
+// only assignments copy the value, the copy constructor (also used to move it) doesn't
+struct assigned
+{
+    assigned() = default;
+    assigned(const assigned&) {}
+    assigned& operator=(const assigned& other)
+    {
+        value = other.value;
+        return *this;
+    }
+    int value = 0;
+};
+
+// odd sized mixins
+struct letter
+{
+    char value = 'a';
+};
+
+struct triple
+{
+    char data[3] = { 'x', 'y', 'z' };
+};
+
+TEST_CASE("single block")
+{
+    domain dom;
+    counting_block_allocator alloc;
+    dom.set_allocator(&alloc);
+
+    object o(dom);
+    mutate(o).add<name>().add<counter>();
+
+    // a single allocation for the object
+    CHECK(alloc.block_allocations == 1);
+    CHECK(alloc.data_allocations == 0);
+    CHECK(alloc.mixin_allocations == 0);
+
+    CHECK(in_block(o, o.get<name>()));
+    CHECK(in_block(o, o.get<counter>()));
+    CHECK(uintptr_t(o.get<name>()) % alignof(name) == 0);
+    CHECK(object_of(o.get<name>()) == &o);
+    CHECK(object_of(o.get<counter>()) == &o);
+
+    o.get<name>()->value = "hello";
+    o.get<counter>()->value = 5;
+    CHECK(get_name(o) == "hello");
+    CHECK(count(o) == 5);
+
+    // the remaining mixins are moved to the new block
+    mutate(o).add<fixed>();
+    CHECK(alloc.block_allocations == 2);
+    CHECK(alloc.block_deallocations == 1);
+    CHECK(alloc.mixin_allocations == 1); // fixed
+    CHECK(in_block(o, o.get<name>()));
+    CHECK(in_block(o, o.get<counter>()));
+    CHECK_FALSE(in_block(o, o.get<fixed>()));
+    CHECK(object_of(o.get<name>()) == &o);
+    CHECK(get_name(o) == "hello");
+    CHECK(count(o) == 5);
+
+    mutate(o).remove<name>();
+    CHECK(alloc.block_allocations == 3);
+    CHECK(alloc.block_deallocations == 2);
+    CHECK(count(o) == 5);
+    CHECK(o.get<fixed>());
+
+    // a block isn't worth it for a type with no movable mixins
+    mutate(o).remove<counter>();
+    CHECK(alloc.block_allocations == 3);
+    CHECK(alloc.block_deallocations == 3);
+    CHECK(alloc.data_allocations == (in_object(o, o._mixin_data) ? 0 : 1));
+    CHECK(o.get<fixed>());
+
+    mutate(o).add<counter>().add<wide>();
+    CHECK(alloc.block_allocations == 4);
+    CHECK(in_block(o, o.get<counter>()));
+    CHECK_FALSE(in_block(o, o.get<wide>()));
+    CHECK(uintptr_t(o.get<wide>()) % 64 == 0);
+
+    o.clear();
+    CHECK(alloc.block_deallocations == 4);
+
+    CHECK(_dynamix_get_mixin_type_info((name*)nullptr).num_mixins == 0);
+    CHECK(_dynamix_get_mixin_type_info((counter*)nullptr).num_mixins == 0);
+    CHECK(_dynamix_get_mixin_type_info((fixed*)nullptr).num_mixins == 0);
+}
+
+TEST_CASE("single block odd sizes")
+{
+    domain dom;
+    counting_block_allocator alloc;
+    dom.set_allocator(&alloc);
+
+    // whatever the order of the mixins in the type, some follow an odd sized one
+    object o(dom);
+    mutate(o).add<letter>().add<counter>().add<triple>().add<name>();
+    CHECK(alloc.block_allocations == 1);
+    CHECK(alloc.mixin_allocations == 0);
+
+    CHECK(in_block(o, o.get<letter>()));
+    CHECK(in_block(o, o.get<counter>()));
+    CHECK(in_block(o, o.get<triple>()));
+    CHECK(in_block(o, o.get<name>()));
+
+    CHECK(owner_aligned(o.get<letter>()));
+    CHECK(owner_aligned(o.get<counter>()));
+    CHECK(owner_aligned(o.get<triple>()));
+    CHECK(owner_aligned(o.get<name>()));
+    CHECK(uintptr_t(o.get<counter>()) % alignof(counter) == 0);
+    CHECK(uintptr_t(o.get<name>()) % alignof(name) == 0);
+
+    CHECK(object_of(o.get<letter>()) == &o);
+    CHECK(object_of(o.get<counter>()) == &o);
+    CHECK(object_of(o.get<triple>()) == &o);
+    CHECK(object_of(o.get<name>()) == &o);
+
+    CHECK(o.get<letter>()->value == 'a');
+    CHECK(o.get<triple>()->data[2] == 'z');
+    CHECK(get_name(o) == "default name");
+    CHECK(count(o) == 0);
+
+    o.clear();
+    CHECK(alloc.block_deallocations == 1);
+}
+
+TEST_CASE("single block move and copy")
+{
+    domain dom;
+    counting_block_allocator alloc;
+    dom.set_allocator(&alloc);
+
+    object o1(dom);
+    mutate(o1).add<name>().add<counter>();
+    o1.get<name>()->value = "o1";
+    o1.get<counter>()->value = 1;
+
+    // moving an object keeps its block
+    const name* n = o1.get<name>();
+    object o2 = std::move(o1);
+    CHECK(o1.empty());
+    CHECK(o2.get<name>() == n);
+    CHECK(object_of(o2.get<name>()) == &o2);
+    CHECK(alloc.block_allocations == 1);
+
+    object o3(dom);
+    o3.copy_from(o2);
+    CHECK(alloc.block_allocations == 2);
+    CHECK(in_block(o3, o3.get<name>()));
+    CHECK(get_name(o3) == "o1");
+    CHECK(count(o3) == 1);
+
+    // copying onto an object with some of the mixins
+    object o4(dom);
+    mutate(o4).add<counter>();
+    o4.get<counter>()->value = 4;
+    o4.copy_from(o2);
+    CHECK(get_name(o4) == "o1");
+    CHECK(count(o4) == 1);
+    CHECK(in_block(o4, o4.get<counter>()));
+
+    o2.clear();
+    o3.clear();
+    o4.clear();
+    CHECK(alloc.block_allocations == alloc.block_deallocations);
+}
+
+TEST_CASE("single block copy of kept mixins")
+{
+    domain dom;
+    counting_block_allocator alloc;
+    dom.set_allocator(&alloc);
+
+    object src(dom);
+    mutate(src).add<counter>().add<assigned>();
+    src.get<counter>()->value = 3;
+    src.get<assigned>()->value = 5;
+
+    // the kept mixins are moved to the block of the new type
+    // and must have the assigned values there
+    object o(dom);
+    mutate(o).add<name>().add<counter>().add<assigned>();
+    o.copy_from(src);
+    CHECK(alloc.block_allocations == 3);
+    CHECK(in_block(o, o.get<counter>()));
+    CHECK(in_block(o, o.get<assigned>()));
+    CHECK(count(o) == 3);
+    CHECK(o.get<assigned>()->value == 5);
+    CHECK(object_of(o.get<assigned>()) == &o);
+}
+
+DYNAMIX_DEFINE_MIXIN(name, get_name_msg);
+DYNAMIX_DEFINE_MIXIN(counter, count_msg);
+DYNAMIX_DEFINE_MIXIN(fixed, none);
+DYNAMIX_DEFINE_MIXIN(wide, none);
+DYNAMIX_DEFINE_MIXIN(letter, none);
+DYNAMIX_DEFINE_MIXIN(triple, none);
+DYNAMIX_DEFINE_MIXIN(assigned, none);
+
+DYNAMIX_DEFINE_MESSAGE(get_name);
+DYNAMIX_DEFINE_MESSAGE(count);
@@ -0,0 +1,242 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include <dynamix/core.hpp>
+#include <dynamix/parallel_call.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+TEST_SUITE_BEGIN("parallel call");
+
+using namespace dynamix;
+
+DYNAMIX_DECLARE_MIXIN(counter);
+DYNAMIX_DECLARE_MIXIN(doubler);
+DYNAMIX_DECLARE_MIXIN(tracer);
+
+DYNAMIX_MESSAGE_1(void, add, int, n);
+DYNAMIX_CONST_MESSAGE_0(int, get);
+DYNAMIX_CONST_MULTICAST_MESSAGE_1(void, trace, std::atomic<int>&, num_calls);
+DYNAMIX_CONST_MULTICAST_MESSAGE_0(int, value);
+
+TEST_CASE("executor")
+{
+    for (size_t num_threads : { 1, 2, 3, 8 })
+    {
+        work_stealing_executor ex(num_threads);
+        CHECK(ex.concurrency() == num_threads);
+
+        for (size_t num_tasks : { 0, 1, 5, 1000 })
+        {
+            std::vector<std::atomic<int>> runs(num_tasks);
+            for (auto& r : runs) r = 0;
+
+            ex.run(num_tasks, [&](size_t i) { ++runs[i]; });
+
+            for (auto& r : runs)
+            {
+                CHECK(r == 1);
+            }
+        }
+    }
+
+    work_stealing_executor def;
+    CHECK(def.concurrency() > 0);
+}
+
+TEST_CASE("executor stealing")
+{
+    // the first queue gets the slow tasks, so the other threads should steal from it
+    work_stealing_executor ex(4);
+    std::atomic<int> num_run = {0};
+    ex.run(40, [&](size_t i)
+    {
+        if (i < 10) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        ++num_run;
+    });
+    CHECK(num_run == 40);
+}
+
+TEST_CASE("split in type runs")
+{
+    std::vector<object> objects(2000);
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        if ((i / 300) % 2)
+            mutate(objects[i]).add<counter>();
+        else
+            mutate(objects[i]).add<doubler>();
+    }
+
+    std::vector<std::vector<object>::iterator> bounds;
+    internal::split_in_type_runs(objects.begin(), objects.end(), 2, bounds);
+
+    REQUIRE(bounds.size() > 2);
+    CHECK(bounds.front() == objects.begin());
+    CHECK(bounds.back() == objects.end());
+
+    for (size_t i = 1; i < bounds.size() - 1; ++i)
+    {
+        // all inner bounds are at type changes
+        CHECK((bounds[i] - objects.begin()) % 300 == 0);
+        CHECK(bounds[i] > bounds[i - 1]);
+    }
+
+    internal::split_in_type_runs(objects.begin(), objects.begin(), 2, bounds);
+    CHECK(bounds.size() == 1);
+}
+
+TEST_CASE("unicast")
+{
+    work_stealing_executor ex(4);
+
+    std::vector<object> objects(5000);
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        if (i % 3)
+            mutate(objects[i]).add<counter>();
+        else
+            mutate(objects[i]).add<doubler>();
+    }
+
+    parallel_call(ex, add_msg, objects, 2);
+
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        CHECK(get(objects[i]) == (i % 3 ? 2 : 4));
+    }
+
+    std::vector<object*> pointers;
+    for (auto& o : objects)
+    {
+        pointers.push_back(&o);
+    }
+
+    parallel_call(ex, add_msg, pointers.begin() + 1, pointers.end(), 1);
+    CHECK(get(objects[0]) == 4);
+    CHECK(get(objects[1]) == 3);
+    CHECK(get(objects[3]) == 6);
+}
+
+TEST_CASE("multicast")
+{
+    work_stealing_executor ex(3);
+
+    std::vector<object> objects(3000);
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        mutate(objects[i]).add<tracer>();
+        if (i % 2) mutate(objects[i]).add<counter>();
+    }
+
+    std::atomic<int> num_calls = {0};
+    parallel_call(ex, trace_msg, objects, num_calls);
+    CHECK(num_calls == 4500);
+}
+
+TEST_CASE("combine")
+{
+    work_stealing_executor ex(4);
+
+    std::vector<object> objects(10000);
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        mutate(objects[i]).add<tracer>();
+        if (i % 4 == 0) mutate(objects[i]).add<counter>();
+    }
+
+    for (size_t i = 0; i < 5000; i += 4)
+    {
+        add(objects[i], 3);
+    }
+
+    // counters have a value of 3 in the first half and 0 in the second half, tracers have 1
+    const int expected = 1250 * 3 + 10000;
+
+    combinators::sum<int> total;
+    parallel_combine(ex, value_msg, objects, total);
+    CHECK(total.result() == expected);
+
+    combinators::sum<int> sequential;
+    combine_all(value_msg, objects, sequential);
+    CHECK(sequential.result() == expected);
+
+    combinators::mean<double> avg;
+    parallel_combine(ex, value_msg, objects, avg);
+    CHECK(avg.result() == doctest::Approx(double(expected) / 12500));
+
+    combinators::boolean_and<int> all;
+    parallel_combine(ex, value_msg, objects, all);
+    CHECK(!all.result());
+
+    combinators::boolean_or<int> any;
+    parallel_combine(ex, value_msg, objects.begin(), objects.begin(), any);
+    CHECK(!any.result());
+}
+
+#if DYNAMIX_USE_EXCEPTIONS
+TEST_CASE("bad call")
+{
+    work_stealing_executor ex(2);
+
+    std::vector<object> objects(2000);
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        if (i == 1500)
+            mutate(objects[i]).add<tracer>();
+        else
+            mutate(objects[i]).add<counter>();
+    }
+
+    CHECK_THROWS_AS(parallel_call(ex, add_msg, objects, 1), bad_message_call);
+
+    // the executor is usable after an exception
+    std::atomic<int> num_run = {0};
+    ex.run(10, [&](size_t) { ++num_run; });
+    CHECK(num_run == 10);
+}
+#endif
+
+class counter
+{
+public:
+    void add(int n) { _value += n; }
+    int get() const { return _value; }
+    void trace(std::atomic<int>& num_calls) const { ++num_calls; }
+    int value() const { return _value; }
+private:
+    int _value = 0;
+};
+
+class doubler
+{
+public:
+    void add(int n) { _value += 2 * n; }
+    int get() const { return _value; }
+private:
+    int _value = 0;
+};
+
+class tracer
+{
+public:
+    void trace(std::atomic<int>& num_calls) const { ++num_calls; }
+    int value() const { return 1; }
+};
+
+DYNAMIX_DEFINE_MIXIN(counter, add_msg & get_msg & trace_msg & value_msg);
+DYNAMIX_DEFINE_MIXIN(doubler, add_msg & get_msg);
+DYNAMIX_DEFINE_MIXIN(tracer, trace_msg & value_msg);
+
+DYNAMIX_DEFINE_MESSAGE(add);
+DYNAMIX_DEFINE_MESSAGE(get);
+DYNAMIX_DEFINE_MESSAGE(trace);
+DYNAMIX_DEFINE_MESSAGE(value);
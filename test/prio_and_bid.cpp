@@ -9,6 +9,9 @@
 #include <dynamix/next_bidder.hpp>
 
 #include <sstream>
+#include <algorithm>
+#include <memory>
+#include <vector>
 
 #include "doctest/doctest.h"
 
@@ -21,6 +24,7 @@ DYNAMIX_DECLARE_MIXIN(a);
 DYNAMIX_DECLARE_MIXIN(b);
 DYNAMIX_DECLARE_MIXIN(c);
 DYNAMIX_DECLARE_MIXIN(d);
+DYNAMIX_DECLARE_MIXIN(e);
 
 DYNAMIX_MULTICAST_MESSAGE_1(void, trace, std::ostream&, out);
 DYNAMIX_MULTICAST_MESSAGE_1(void, priority_trace, std::ostream&, out);
@@ -29,6 +33,7 @@ DYNAMIX_MESSAGE_1(void, bids_uni, std::ostream&, out);
 DYNAMIX_CONST_MESSAGE_1(void, bids_bad_uni, std::ostream&, out);
 DYNAMIX_MULTICAST_MESSAGE_1(void, bids_multi, std::ostream&, out);
 DYNAMIX_CONST_MULTICAST_MESSAGE_1(void, bids_multi_override, std::ostream&, out);
+DYNAMIX_MESSAGE_0(void, other);
 
 TEST_CASE("different_priority")
 {
@@ -110,6 +115,97 @@ TEST_CASE("bids")
     CHECK(sout.str() == "ba");
 }
 
+namespace
+{
+// checks that two type infos of the same mixins have identical call tables
+bool same_call_tables(const object_type_info& x, const object_type_info& y)
+{
+    const size_t num_messages = std::max(x._call_table.size(), y._call_table.size());
+    for (size_t i = 0; i < num_messages; ++i)
+    {
+        auto& ex = x._call_table[i];
+        auto& ey = y._call_table[i];
+
+        if (ex.top_bid_message.caller != ey.top_bid_message.caller) return false;
+        if (ex.top_bid_message.mixin_index != ey.top_bid_message.mixin_index) return false;
+        if (!ex.begin != !ey.begin) return false;
+        if (!ex.begin) continue;
+        if (ex.end - ex.begin != ey.end - ey.begin) return false;
+        if (!ex.next_bidders != !ey.next_bidders) return false;
+        if (!ex.next_bidders) continue;
+
+        // for multicasts continue until the terminator
+        auto buffer_end = ex.end;
+        if (internal::domain::instance().message_data(feature_id(i)).mechanism == internal::message_t::multicast)
+        {
+            while (*buffer_end) ++buffer_end;
+            if (*(ey.begin + (buffer_end - ex.begin))) return false;
+        }
+
+        for (auto px = ex.begin, py = ey.begin; px != buffer_end; ++px, ++py)
+        {
+            if (px->caller != py->caller) return false;
+            if (px->mixin_index != py->mixin_index) return false;
+            if (x.message_data(px) != y.message_data(py)) return false;
+        }
+
+        for (size_t im = 0; im < x._compact_mixins.size(); ++im)
+        {
+            if (ex.next_bidders[im].begin != ey.next_bidders[im].begin) return false;
+            if (ex.next_bidders[im].end != ey.next_bidders[im].end) return false;
+        }
+    }
+    return true;
+}
+}
+
+TEST_CASE("derived call tables")
+{
+    auto& dom = internal::domain::safe_instance();
+
+    const mixin_type_info* infos[] =
+    {
+        &_dynamix_get_mixin_type_info((a*)nullptr),
+        &_dynamix_get_mixin_type_info((b*)nullptr),
+        &_dynamix_get_mixin_type_info((c*)nullptr),
+        &_dynamix_get_mixin_type_info((d*)nullptr),
+        &_dynamix_get_mixin_type_info((e*)nullptr),
+    };
+    const int num_mixins = 5;
+
+    auto subset = [&infos](int bits)
+    {
+        mixin_collection ret;
+        for (int i = 0; i < num_mixins; ++i)
+        {
+            if (bits & (1 << i)) ret.add(*infos[i]);
+        }
+        std::sort(ret._compact_mixins.begin(), ret._compact_mixins.end());
+        return ret;
+    };
+
+    // all existing types
+    std::vector<std::unique_ptr<object_type_info>> types;
+    const int num_types = 1 << num_mixins;
+    for (int i = 1; i < num_types; ++i)
+    {
+        types.emplace_back(dom.build_object_type_info(subset(i), nullptr));
+    }
+
+    // derive each type from each other one
+    // the result must be the same as building it from scratch
+    bool same = true;
+    for (int i = 1; i < num_types; ++i)
+    {
+        for (auto& source : types)
+        {
+            auto derived = dom.build_object_type_info(subset(i), source.get());
+            same = same && same_call_tables(*derived, *types[size_t(i - 1)]);
+        }
+    }
+    CHECK(same);
+}
+
 // test for issue #20
 class parent
 {
@@ -249,6 +345,13 @@ public:
     }
 };
 
+// a mixin which doesn't affect the other messages
+class e
+{
+public:
+    void other() {}
+};
+
 // this order should be important if the messages aren't sorted by mixin name
 DYNAMIX_DEFINE_MIXIN(b,
     trace_msg & priority(2, priority_trace_msg)
@@ -261,6 +364,7 @@ DYNAMIX_DEFINE_MIXIN(c,
     & priority(1, bids_uni_msg) & bid(1, bids_multi_override_msg) & bids_multi_msg);
 DYNAMIX_DEFINE_MIXIN(d,
     trace_msg & priority_trace_msg & bids_uni_msg & bid(1, bids_multi_override_msg) & bid(1, bids_multi_msg));
+DYNAMIX_DEFINE_MIXIN(e, other_msg);
 
 DYNAMIX_DEFINE_MESSAGE(trace);
 DYNAMIX_DEFINE_MESSAGE(priority_trace);
@@ -268,3 +372,4 @@ DYNAMIX_DEFINE_MESSAGE(bids_uni);
 DYNAMIX_DEFINE_MESSAGE(bids_bad_uni);
 DYNAMIX_DEFINE_MESSAGE(bids_multi);
 DYNAMIX_DEFINE_MESSAGE(bids_multi_override);
+DYNAMIX_DEFINE_MESSAGE(other);
@@ -0,0 +1,151 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include <dynamix/core.hpp>
+#include <dynamix/static_object.hpp>
+#include <dynamix/combinators.hpp>
+
+#include "doctest/doctest.h"
+
+TEST_SUITE_BEGIN("static object");
+
+using namespace dynamix;
+
+DYNAMIX_DECLARE_MIXIN(counter);
+DYNAMIX_DECLARE_MIXIN(aligned);
+DYNAMIX_DECLARE_MIXIN(other);
+
+DYNAMIX_MESSAGE_1(int, add, int, n);
+DYNAMIX_CONST_MESSAGE_0(int, get);
+DYNAMIX_CONST_MESSAGE_0(const object*, owner);
+DYNAMIX_CONST_MULTICAST_MESSAGE_0(int, value);
+
+// the mixin classes must be complete for a static object
+class counter
+{
+public:
+    int add(int n) { return _value += n; }
+    int get() const { return _value; }
+    const object* owner() const { return dm_this; }
+    int value() const { return _value; }
+private:
+    int _value = 0;
+};
+
+class alignas(32) aligned
+{
+public:
+    int value() const { return 7; }
+};
+
+class other
+{
+};
+
+TEST_CASE("static object")
+{
+    using counter_object = static_object<counter, aligned>;
+
+    CHECK(counter_object::has<counter>());
+    CHECK(counter_object::has<aligned>());
+    CHECK(!counter_object::has<other>());
+
+    const size_t num_counters = _dynamix_get_mixin_type_info(static_cast<counter*>(nullptr)).num_mixins;
+
+    {
+        counter_object s1, s2;
+        CHECK(&s1.type_info() == &s2.type_info());
+        CHECK(_dynamix_get_mixin_type_info(static_cast<counter*>(nullptr)).num_mixins == num_counters + 2);
+
+        // the same type info as regular objects with these mixins
+        object o;
+        mutate(o).add<counter>().add<aligned>();
+        CHECK(&o.type_info() == &s1.type_info());
+
+        // mixins are within the static object
+        const uintptr_t begin = uintptr_t(&s1);
+        const uintptr_t end = begin + sizeof(s1);
+        const uintptr_t c = uintptr_t(s1.get<counter>());
+        const uintptr_t a = uintptr_t(s1.get<aligned>());
+        CHECK(c > begin);
+        CHECK(c < end);
+        CHECK(a > begin);
+        CHECK(a < end);
+        CHECK(a % 32 == 0);
+
+        object& so = s1;
+        CHECK(so.has<counter>());
+        CHECK(so.get<counter>() == s1.get<counter>());
+        CHECK(so.get<aligned>() == s1.get<aligned>());
+        CHECK(!so.has<other>());
+
+        // the owning object is the inner one
+        CHECK(owner(s1) == &s1.as_object());
+        CHECK(object_of(s1.get<counter>()) == &s1.as_object());
+
+        // regular message calls
+        CHECK(add(s1, 3) == 3);
+        CHECK(get(s1) == 3);
+        CHECK(value<combinators::sum>(s1) == 3 + 7);
+
+        // calls resolved for the static type
+        CHECK(s1.call(add_msg, 2) == 5);
+        CHECK(s2.call(add_msg, 1) == 1);
+        const counter_object& cs1 = s1;
+        CHECK(cs1.call(get_msg) == 5);
+        CHECK(s1.get<counter>()->get() == 5);
+
+        // copies are regular objects
+        object copy = s1.as_object().copy();
+        CHECK(&copy.type_info() == &s1.type_info());
+        CHECK(get(copy) == 5);
+        CHECK(copy.get<counter>() != s1.get<counter>());
+    }
+
+    CHECK(_dynamix_get_mixin_type_info(static_cast<counter*>(nullptr)).num_mixins == num_counters);
+}
+
+TEST_CASE("static object mixin order")
+{
+    // the order in which the mixins are listed doesn't matter
+    static_object<counter, aligned> s1;
+    static_object<aligned, counter> s2;
+    CHECK(&s1.type_info() == &s2.type_info());
+
+    object o;
+    mutate(o).add<aligned>().add<counter>();
+    CHECK(&o.type_info() == &s2.type_info());
+
+    CHECK(uintptr_t(s2.get<aligned>()) % 32 == 0);
+    CHECK(s2.call(add_msg, 4) == 4);
+    CHECK(get(s2) == 4);
+    CHECK(value<combinators::sum>(s2) == 4 + 7);
+}
+
+TEST_CASE("mutated static object")
+{
+    static_object<counter> s;
+    add(s, 2);
+
+    // mutating a static object is not supported, but it should still work as an object
+    mutate(s.as_object()).add<other>();
+    CHECK(get(s) == 2);
+    CHECK(s.as_object().has<other>());
+
+    mutate(s.as_object()).remove<other>();
+    CHECK(get(s) == 2);
+    CHECK(s.get<counter>()->get() == 2);
+}
+
+DYNAMIX_DEFINE_MIXIN(counter, add_msg & get_msg & owner_msg & value_msg);
+DYNAMIX_DEFINE_MIXIN(aligned, value_msg);
+DYNAMIX_DEFINE_MIXIN(other, none);
+
+DYNAMIX_DEFINE_MESSAGE(add);
+DYNAMIX_DEFINE_MESSAGE(get);
+DYNAMIX_DEFINE_MESSAGE(owner);
+DYNAMIX_DEFINE_MESSAGE(value);
@@ -163,6 +163,73 @@ TEST_CASE("mutate")
     CHECK(same);
 }
 
+void mutate_to_all_types(size_t first, std::vector<object>& objects)
+{
+    const mixin_id ids[] =
+    {
+        _dynamix_get_mixin_type_info((m1*)nullptr).id,
+        _dynamix_get_mixin_type_info((m2*)nullptr).id,
+        _dynamix_get_mixin_type_info((m3*)nullptr).id,
+        _dynamix_get_mixin_type_info((e1*)nullptr).id,
+        _dynamix_get_mixin_type_info((e2*)nullptr).id,
+    };
+    const size_t num_types = 1 << 5;
+
+    // each thread goes through the types in a different order
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        const size_t type = (first + i) % num_types;
+
+        single_object_mutator m(objects[i]);
+        for (size_t b = 0; b < 5; ++b)
+        {
+            if (type & (1 << b)) m.add(ids[b]);
+        }
+    }
+}
+
+TEST_CASE("concurrent type creation")
+{
+    using namespace std;
+    const size_t num_threads = 8;
+    const size_t num_types = 1 << 5;
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        vector<vector<object>> objects(num_threads);
+        vector<std::thread> threads;
+        for (size_t i = 0; i < num_threads; ++i)
+        {
+            objects[i].resize(num_types * 4);
+            threads.emplace_back(mutate_to_all_types, i * 5, std::ref(objects[i]));
+        }
+
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+
+        // objects with the same mixins must have the same type info
+        // no matter which thread created it
+        bool same = true;
+        for (size_t i = 1; i < num_threads; ++i)
+        {
+            for (size_t j = 0; j < objects[i].size(); ++j)
+            {
+                const object& a = objects[0][(j + i * 5) % objects[0].size()];
+                const object& b = objects[i][j];
+                same = same && (a._type_info == b._type_info);
+            }
+        }
+        CHECK(same);
+
+        objects.clear();
+
+        // the second pass recreates the collected types
+        internal::domain::safe_instance().garbage_collect_type_infos();
+    }
+}
+
 #endif
 
 class m1
@@ -76,16 +76,114 @@ TEST_CASE("global")
 {
     using namespace dynamix;
     object gt; mutate(gt).add<ghost>().add<tank>();
-    CHECK(gt._type_info->_matching_type_classes.size() == 2);
+    CHECK(gt._type_info->_matching_type_classes.count() == 2);
     CHECK(gt.is_a(move_and_shoot_and_ghost));
     CHECK(gt.is_a<move_and_ghost_and_tank>());
 
     object gs; mutate(gs).add<ghost>().add<soldier>();
-    CHECK(gs._type_info->_matching_type_classes.size() == 1);
+    CHECK(gs._type_info->_matching_type_classes.count() == 1);
     CHECK(gs.is_a(move_and_shoot_and_ghost));
     CHECK_FALSE(gs.is_a<move_and_ghost_and_tank>());
 }
 
+TEST_CASE("declarative local")
+{
+    using namespace dynamix;
+
+    object gc; mutate(gc).add<ghost>().add<cannon>();
+    object vc; mutate(vc).add<visible>().add<cannon>();
+    object gs; mutate(gs).add<ghost>().add<soldier>();
+    object vt; mutate(vt).add<visible>().add<tank>();
+
+    type_class has_ghost(type_class_filter().all_of<ghost>());
+    type_class move_and_shoot(type_class_filter().implements(move_msg, shoot_msg));
+    type_class shoot_and_visible_and_tank(type_class_filter().all_of<visible, tank>().implements(shoot_msg));
+    type_class soldier_or_tank(type_class_filter().any_of<soldier, tank>());
+    type_class armed_not_ghost(type_class_filter().any_of<cannon, tank>().none_of<ghost>());
+
+    CHECK(gc.is_a(has_ghost));
+    CHECK_FALSE(gc.is_a(soldier_or_tank));
+    CHECK_FALSE(gc.is_a(armed_not_ghost));
+
+    CHECK_FALSE(vc.is_a(has_ghost));
+    CHECK_FALSE(vc.is_a(move_and_shoot));
+    CHECK_FALSE(vc.is_a(shoot_and_visible_and_tank));
+    CHECK(vc.is_a(armed_not_ghost));
+
+    CHECK(gs.is_a(has_ghost));
+    CHECK(gs.is_a(move_and_shoot));
+    CHECK(gs.is_a(soldier_or_tank));
+
+    CHECK_FALSE(vt.is_a(has_ghost));
+    CHECK(vt.is_a(move_and_shoot));
+    CHECK(vt.is_a(shoot_and_visible_and_tank));
+    CHECK(vt.is_a(soldier_or_tank));
+    CHECK(vt.is_a(armed_not_ghost));
+}
+
+static void init_int_mixin_info(dynamix::mixin_type_info& info, const char* name)
+{
+    info.name = name;
+    info.size = sizeof(int);
+    info.alignment = alignof(int);
+    info.constructor = [](void* mem) { new (mem) int(0); };
+    info.destructor = [](void*) {};
+}
+
+TEST_CASE("declarative local with unregistered mixins")
+{
+    using namespace dynamix;
+    auto& dom = internal::domain::safe_instance();
+
+    mixin_type_info late, reused;
+    init_int_mixin_info(late, "type_classes_late");
+    init_int_mixin_info(reused, "type_classes_reused");
+
+    // created before the mixin is registered
+    type_class has_late(type_class_filter().all_of(late));
+    type_class not_late(type_class_filter().none_of(late));
+
+    dom.register_mixin_type(late);
+    {
+        object o;
+        single_object_mutator(o).add(late.id);
+        CHECK(o.is_a(has_late));
+        CHECK_FALSE(o.is_a(not_late));
+    }
+
+    const auto late_id = late.id;
+    dom.unregister_mixin_type(late);
+
+    // the new mixin gets the id of the unregistered one
+    dom.register_mixin_type(reused);
+    CHECK(reused.id == late_id);
+    {
+        object o;
+        single_object_mutator(o).add(reused.id);
+        CHECK_FALSE(o.is_a(has_late));
+        CHECK(o.is_a(not_late));
+    }
+    dom.unregister_mixin_type(reused);
+}
+
+// defined before the mixins and messages are registered
+DYNAMIX_TYPE_CLASS(visible_not_ghost);
+DYNAMIX_DEFINE_TYPE_CLASS_FILTER(visible_not_ghost, .all_of<visible>().none_of<ghost>().implements(draw_msg));
+
+TEST_CASE("declarative global")
+{
+    using namespace dynamix;
+    object vc; mutate(vc).add<visible>().add<cannon>();
+    CHECK(vc.is_a<visible_not_ghost>());
+    CHECK(vc._type_info->_matching_type_classes.count() == 1);
+
+    object gv; mutate(gv).add<ghost>().add<visible>();
+    CHECK_FALSE(gv.is_a<visible_not_ghost>());
+
+    object gt; mutate(gt).add<ghost>().add<tank>();
+    CHECK_FALSE(gt.is_a<visible_not_ghost>());
+}
+
 DYNAMIX_DEFINE_MESSAGE(move);
 DYNAMIX_DEFINE_MESSAGE(draw);
 DYNAMIX_DEFINE_MESSAGE(shoot);
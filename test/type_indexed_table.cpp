@@ -0,0 +1,119 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include <dynamix/core.hpp>
+#include <dynamix/type_indexed_table.hpp>
+
+#include "doctest/doctest.h"
+
+#include "test_mixins.hpp"
+
+#include <string>
+#include <memory>
+#include <set>
+
+TEST_SUITE_BEGIN("type indexed table");
+
+using namespace dynamix;
+using internal::domain;
+
+TEST_CASE("type ids")
+{
+    CHECK(object_type_info::null().id() == 0);
+
+    object o1, o2, o3;
+    mutate(o1).add<a>();
+    mutate(o2).add<b>();
+    mutate(o3).add<a>().add<b>();
+
+    std::set<uint32_t> ids = { o1.type_info().id(), o2.type_info().id(), o3.type_info().id() };
+    CHECK(ids.size() == 3);
+    CHECK(ids.count(0) == 0);
+
+    // the ids are dense
+    for (auto id : ids)
+    {
+        CHECK(id <= 3);
+    }
+
+    // the id of a destroyed type info is reused
+    const uint32_t id3 = o3.type_info().id();
+    o3.clear();
+    domain::safe_instance().garbage_collect_type_infos();
+
+    object o4;
+    mutate(o4).add<b>().add<c>();
+    CHECK(o4.type_info().id() == id3);
+
+    // a type info of another domain gets an id of its own
+    domain shard;
+    object o5(shard);
+    mutate(o5).add<a>();
+    CHECK(o5.type_info().id() != o1.type_info().id());
+    CHECK(o5.type_info().id() != 0);
+}
+
+TEST_CASE("tables")
+{
+    auto& dom = domain::safe_instance();
+
+    object o1;
+    mutate(o1).add<a>();
+
+    // the slots of existing type infos are created with the table
+    type_indexed_table<std::string> names;
+    CHECK(names[o1.type_info()].empty());
+    CHECK(names[object_type_info::null()].empty());
+    names[o1.type_info()] = "a";
+
+    // and the slots of new type infos are created with them
+    type_indexed_table<std::unique_ptr<int>, 2> small_pages;
+    object o2;
+    mutate(o2).add<a>().add<c>();
+    CHECK(names[o2.type_info()].empty());
+    names[o2.type_info()] = "ac";
+    small_pages[o2.type_info()].reset(new int(5));
+
+    // more types than fit in a page
+    object objects[5];
+    for (auto& o : objects)
+    {
+        mutate(o).add<b>();
+    }
+    mutate(objects[1]).add<a>();
+    mutate(objects[2]).add<c>();
+    mutate(objects[3]).add<a>().add<c>();
+    mutate(objects[4]).remove<b>().add<c>();
+    for (auto& o : objects)
+    {
+        CHECK(names[o.type_info()].empty());
+        CHECK(!small_pages[o.type_info()]);
+    }
+
+    CHECK(names[o1.type_info()] == "a");
+    CHECK(names[o2.type_info()] == "ac");
+    CHECK(*small_pages[o2.type_info()] == 5);
+
+    // the slot of a destroyed type info is reset
+    std::set<uint32_t> freed_ids = { o2.type_info().id() };
+    o2.clear();
+    for (auto& o : objects)
+    {
+        freed_ids.insert(o.type_info().id());
+        o.clear();
+    }
+    dom.garbage_collect_type_infos();
+
+    // the smallest free id is reused first
+    object o3;
+    mutate(o3).add<b>().add<a>();
+    CHECK(o3.type_info().id() == *freed_ids.begin());
+    CHECK(names[o3.type_info()].empty());
+    CHECK(!small_pages[o3.type_info()]);
+
+    CHECK(names[o1.type_info()] == "a");
+}
@@ -0,0 +1,247 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include <dynamix/core.hpp>
+#include <dynamix/type_info_gc.hpp>
+#include <dynamix/object_type_template.hpp>
+
+#include "doctest/doctest.h"
+
+#include "test_mixins.hpp"
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <new>
+
+TEST_SUITE_BEGIN("type info gc");
+
+using namespace dynamix;
+
+namespace
+{
+// mixins registered at run time, so that there can be many types
+struct runtime_mixins
+{
+    explicit runtime_mixins(size_t num)
+    {
+        names.reserve(num);
+        for (size_t i = 0; i < num; ++i)
+        {
+            names.push_back("gc_mixin_" + std::to_string(i));
+
+            infos.emplace_back(new mixin_type_info);
+            auto& info = *infos.back();
+            info.name = names.back().c_str();
+            info.size = sizeof(int);
+            info.alignment = alignof(int);
+            info.constructor = [](void* mem) { new (mem) int(0); };
+            info.destructor = [](void*) {};
+            internal::domain::safe_instance().register_mixin_type(info);
+        }
+    }
+
+    ~runtime_mixins()
+    {
+        auto& dom = internal::domain::safe_instance();
+        dom.garbage_collect_type_infos();
+        for (auto& info : infos)
+        {
+            dom.unregister_mixin_type(*info);
+        }
+    }
+
+    mixin_id id(size_t i) const { return infos[i]->id; }
+
+    std::vector<std::string> names;
+    std::vector<std::unique_ptr<mixin_type_info>> infos;
+};
+
+// creates the type {a, mixin i} and destroys its object
+const object_type_info* make_unused_type(const runtime_mixins& mixins, size_t i)
+{
+    object o;
+    mutate(o).add<a>();
+    single_object_mutator(o).add(mixins.id(i));
+    return &o.type_info();
+}
+
+void reset()
+{
+    set_type_info_gc_policy(type_info_gc_policy());
+    internal::domain::safe_instance().garbage_collect_type_infos();
+}
+}
+
+TEST_CASE("limits")
+{
+    runtime_mixins mixins(100);
+
+    type_info_gc_policy policy;
+    policy.max_type_infos = 20;
+    policy.collection_interval = 1;
+    set_type_info_gc_policy(policy);
+
+    const auto before = get_type_info_gc_stats();
+
+    object live;
+    mutate(live).add<b>();
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        make_unused_type(mixins, i);
+    }
+
+    auto stats = get_type_info_gc_stats();
+    CHECK(stats.num_type_infos <= 21);
+    CHECK(stats.num_collected - before.num_collected >= 80);
+    CHECK(stats.collected_size - before.collected_size >= (stats.num_collected - before.num_collected) * sizeof(object_type_info));
+    CHECK(stats.type_infos_size > 0);
+
+    // types with objects are not collected
+    CHECK(live.has<b>());
+    object live2;
+    mutate(live2).add<b>();
+    CHECK(&live2.type_info() == &live.type_info());
+
+    // memory budget
+    policy = type_info_gc_policy();
+    policy.max_type_infos_size = stats.type_infos_size / 2;
+    policy.collection_interval = 1;
+    set_type_info_gc_policy(policy);
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        make_unused_type(mixins, i);
+    }
+
+    stats = get_type_info_gc_stats();
+    CHECK(stats.type_infos_size <= policy.max_type_infos_size + live.type_info().memory_footprint());
+
+    reset();
+}
+
+TEST_CASE("lru")
+{
+    runtime_mixins mixins(10);
+
+    type_info_gc_policy policy;
+    policy.num_retained_unused = 3;
+    set_type_info_gc_policy(policy);
+
+    std::vector<const object_type_info*> types;
+    for (size_t i = 0; i < 10; ++i)
+    {
+        types.push_back(make_unused_type(mixins, i));
+    }
+
+    // use the first one again
+    make_unused_type(mixins, 0);
+
+    collect_type_infos();
+    const auto stats = get_type_info_gc_stats();
+    CHECK(stats.num_type_infos == 3);
+
+    // the type {a} is used by every mutation, so it's one of the most recently used
+    std::vector<const object_type_info*> left;
+    internal::domain::safe_instance().get_object_type_infos(left);
+    for (auto type : left)
+    {
+        const bool a_only = type->as_mixin_collection()->_compact_mixins.size() == 1 && type->has<a>();
+        CHECK((type == types[0] || type == types[9] || a_only));
+    }
+
+    reset();
+}
+
+TEST_CASE("pins")
+{
+    object_type_template tmp;
+    tmp.add<a>().add<c>();
+    tmp.create();
+
+    collect_type_infos();
+
+    // the target of the template is pinned
+    object o;
+    tmp.apply_to(o);
+    CHECK(o.has<a>());
+    CHECK(o.has<c>());
+
+    const object_type_info* ac = &o.type_info();
+    o.clear();
+    collect_type_infos();
+    tmp.apply_to(o);
+    CHECK(&o.type_info() == ac);
+
+    reset();
+}
+
+#if DYNAMIX_THREAD_SAFE_MUTATIONS
+TEST_CASE("concurrent")
+{
+    const size_t num_mixins = 32;
+    runtime_mixins mixins(num_mixins);
+
+    type_info_gc_policy policy;
+    policy.max_type_infos = 8;
+    policy.collection_interval = 1;
+    policy.max_collected_per_pass = 4;
+    set_type_info_gc_policy(policy);
+
+    std::atomic<bool> stop(false);
+    std::thread collector([&stop]()
+    {
+        while (!stop)
+        {
+            collect_type_infos();
+        }
+    });
+
+    std::vector<std::thread> threads;
+    std::atomic<int> num_errors(0);
+    for (size_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&mixins, &num_errors, t]()
+        {
+            object o;
+            for (size_t i = 0; i < 2000; ++i)
+            {
+                const size_t m = (i * 7 + t) % num_mixins;
+                mutate(o).add<a>();
+                single_object_mutator(o).add(mixins.id(m));
+                if (!o.has<a>() || !o.has(mixins.id(m)) || *static_cast<int*>(o.get(mixins.id(m))) != 0)
+                {
+                    ++num_errors;
+                }
+                o.clear();
+            }
+        });
+    }
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    stop = true;
+    collector.join();
+
+    CHECK(num_errors == 0);
+
+    const auto stats = get_type_info_gc_stats();
+    CHECK(stats.num_collected > 0);
+
+    // the pending type infos are destroyed when nothing is reading them
+    collect_type_infos();
+    collect_type_infos();
+    CHECK(get_type_info_gc_stats().num_pending == 0);
+
+    reset();
+}
+#endif
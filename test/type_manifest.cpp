@@ -0,0 +1,175 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include <dynamix/core.hpp>
+#include <dynamix/type_manifest.hpp>
+#include <dynamix/executor.hpp>
+
+#include "doctest/doctest.h"
+
+#include "test_mixins.hpp"
+
+#include <sstream>
+#include <vector>
+#include <new>
+
+TEST_SUITE_BEGIN("type manifest");
+
+using namespace dynamix;
+
+namespace
+{
+size_t num_type_infos()
+{
+    std::vector<const object_type_info*> types;
+    internal::domain::safe_instance().get_object_type_infos(types);
+    return types.size();
+}
+
+// the manifest of types {a}, {a, b}, {a, b, c}, {b, c}
+std::string make_manifest()
+{
+    {
+        object o1, o2;
+        mutate(o1).add<a>();
+        mutate(o1).add<b>();
+        mutate(o1).add<c>();
+        mutate(o2).add<b>().add<c>();
+    }
+
+    std::ostringstream out;
+    CHECK(save_type_manifest(out));
+
+    internal::domain::safe_instance().garbage_collect_type_infos();
+    CHECK(num_type_infos() == 0);
+
+    return out.str();
+}
+
+void check_types(const object_type_info* abc)
+{
+    CHECK(num_type_infos() == 4);
+
+    // the objects get the preloaded types
+    object o;
+    mutate(o).add<a>().add<b>().add<c>();
+    CHECK(&o.type_info() == abc);
+    mutate(o).remove<a>();
+    CHECK(num_type_infos() == 4);
+}
+}
+
+TEST_CASE("save and load")
+{
+    const std::string data = make_manifest();
+
+    // the names are written once
+    CHECK(data.size() < 32);
+
+    std::istringstream in(data);
+    auto result = load_type_manifest(in);
+    CHECK(result.valid);
+    CHECK(result.num_types == 4);
+    CHECK(result.num_skipped_types == 0);
+    CHECK(result.unresolved_mixin_names.empty());
+
+    std::vector<const object_type_info*> types;
+    internal::domain::safe_instance().get_object_type_infos(types);
+    const object_type_info* abc = nullptr;
+    for (auto type : types)
+    {
+        if (type->_compact_mixins.size() == 3) abc = type;
+    }
+    REQUIRE(abc);
+    CHECK(abc->has<a>());
+    CHECK(abc->has<b>());
+    CHECK(abc->has<c>());
+
+    check_types(abc);
+
+    // loading again finds the existing types
+    std::istringstream in2(data);
+    result = load_type_manifest(in2);
+    CHECK(result.valid);
+    CHECK(num_type_infos() == 4);
+
+    internal::domain::safe_instance().garbage_collect_type_infos();
+}
+
+TEST_CASE("parallel load")
+{
+    const std::string data = make_manifest();
+
+    work_stealing_executor exec(4);
+    std::istringstream in(data);
+    auto result = load_type_manifest(in, &exec);
+    CHECK(result.valid);
+    CHECK(result.num_types == 4);
+
+    object o;
+    mutate(o).add<a>().add<b>().add<c>();
+    const object_type_info* abc = &o.type_info();
+    o.clear();
+    check_types(abc);
+
+    internal::domain::safe_instance().garbage_collect_type_infos();
+}
+
+TEST_CASE("unresolved names")
+{
+    auto& dom = internal::domain::safe_instance();
+
+    mixin_type_info plugin_mixin;
+    plugin_mixin.name = "plugin_mixin";
+    plugin_mixin.size = sizeof(int);
+    plugin_mixin.alignment = alignof(int);
+    plugin_mixin.constructor = [](void* mem) { new (mem) int(0); };
+    plugin_mixin.destructor = [](void*) {};
+    dom.register_mixin_type(plugin_mixin);
+
+    {
+        object o1, o2;
+        mutate(o1).add<a>();
+        single_object_mutator(o1).add(plugin_mixin.id);
+        mutate(o2).add<b>();
+    }
+
+    std::ostringstream out;
+    CHECK(save_type_manifest(out));
+
+    // as if the plugin wasn't loaded
+    dom.unregister_mixin_type(plugin_mixin);
+    dom.garbage_collect_type_infos();
+
+    std::istringstream in(out.str());
+    auto result = load_type_manifest(in);
+    CHECK(result.valid);
+    CHECK(result.num_types == 3); // {a}, {a, plugin_mixin}, {b}
+    CHECK(result.num_skipped_types == 1);
+    REQUIRE(result.unresolved_mixin_names.size() == 1);
+    CHECK(result.unresolved_mixin_names[0] == "plugin_mixin");
+    CHECK(num_type_infos() == 2);
+
+    dom.garbage_collect_type_infos();
+}
+
+TEST_CASE("invalid manifest")
+{
+    const std::string data = make_manifest();
+
+    std::istringstream empty("");
+    CHECK(!load_type_manifest(empty).valid);
+
+    std::istringstream garbage("not a manifest");
+    CHECK(!load_type_manifest(garbage).valid);
+
+    std::istringstream truncated(data.substr(0, data.size() - 1));
+    CHECK(!load_type_manifest(truncated).valid);
+    CHECK(num_type_infos() == 0);
+
+    CHECK(!load_type_manifest("no/such/manifest/file").valid);
+}
@@ -0,0 +1,167 @@
+// DynaMix
+// Copyright (c) 2013-2020 Borislav Stanimirov, Zahary Karadjov
+//
+// Distributed under the MIT Software License
+// See accompanying file LICENSE.txt or copy at
+// https://opensource.org/licenses/MIT
+//
+#include <dynamix/core.hpp>
+#include <dynamix/mutation_rule.hpp>
+#include <dynamix/common_mutation_rules.hpp>
+
+#include "doctest/doctest.h"
+
+#include "test_mixins.hpp"
+
+TEST_SUITE_BEGIN("type transitions");
+
+using namespace dynamix;
+
+namespace
+{
+const mixin_collection no_mixins;
+
+const object_type_info* transition(const object_type_info& source, const mixin_collection& adding, const mixin_collection& removing = no_mixins)
+{
+    return source.find_transition(adding._mixins, removing._mixins, internal::domain::mutation_rules_generation());
+}
+}
+
+TEST_CASE("transitions")
+{
+    object o1, o2;
+
+    mixin_collection a_only;
+    a_only.add<a>();
+
+    const auto& null = object_type_info::null();
+    CHECK(!transition(null, a_only));
+
+    mutate(o1).add<a>();
+    CHECK(transition(null, a_only) == &o1.type_info());
+
+    // the same mutation of the same type
+    mutate(o2).add<a>();
+    CHECK(&o2.type_info() == &o1.type_info());
+
+    // no change is also memoized
+    mutate(o1).add<a>();
+    CHECK(transition(o1.type_info(), a_only) == &o1.type_info());
+    CHECK(o1.has<a>());
+
+
+    const object_type_info* a_type = &o1.type_info();
+    mutate(o1).remove<a>();
+    CHECK(o1.empty());
+    CHECK(transition(*a_type, no_mixins, a_only) == &null);
+
+    mutate(o2).remove<a>();
+    CHECK(o2.empty());
+
+    for (int i = 0; i < 10; ++i)
+    {
+        mutate(o1).add<a>().add<b>();
+        CHECK(o1.has<a>());
+        CHECK(o1.has<b>());
+        mutate(o1).remove<b>();
+        CHECK(o1.has<a>());
+        CHECK(!o1.has<b>());
+        mutate(o1).remove<a>();
+        CHECK(o1.empty());
+    }
+}
+
+TEST_CASE("transitions and rules")
+{
+    object o;
+
+    mixin_collection a_only;
+    a_only.add<a>();
+
+    mutate(o).add<a>();
+    CHECK(!o.has<b>());
+    mutate(o).remove<a>();
+
+    // the rule must invalidate the memoized transition
+    auto rule = new dependent_mixins;
+    rule->set_master<a>();
+    rule->add<b>();
+    auto id = add_mutation_rule(rule);
+
+    CHECK(!transition(object_type_info::null(), a_only));
+
+    mutate(o).add<a>();
+    CHECK(o.has<a>());
+    CHECK(o.has<b>());
+
+    mutate(o).remove<a>();
+    CHECK(o.empty());
+
+    remove_mutation_rule(id);
+
+    mutate(o).add<a>();
+    CHECK(o.has<a>());
+    CHECK(!o.has<b>());
+}
+
+TEST_CASE("transitions and garbage collection")
+{
+    mixin_collection c_only;
+    c_only.add<c>();
+
+    {
+        object o;
+        mutate(o).add<c>();
+        CHECK(transition(object_type_info::null(), c_only) == &o.type_info());
+    }
+
+    // the type with c only is destroyed
+    internal::domain::safe_instance().garbage_collect_type_infos();
+    CHECK(!transition(object_type_info::null(), c_only));
+
+    object o;
+    mutate(o).add<c>();
+    CHECK(o.has<c>());
+    CHECK(transition(object_type_info::null(), c_only) == &o.type_info());
+}
+
+TEST_CASE("transitions limit")
+{
+    object o;
+    mutate(o).add<a>();
+
+    const object_type_info& type = o.type_info();
+    const size_t footprint = type.memory_footprint();
+
+    const mixin_id ids[] =
+    {
+        _dynamix_get_mixin_type_info((::a*)nullptr).id,
+        _dynamix_get_mixin_type_info((::b*)nullptr).id,
+        _dynamix_get_mixin_type_info((::c*)nullptr).id,
+    };
+
+    // all 27 mutations which add, remove, or don't touch each mixin
+    // more than the limit
+    for (int i = 0; i < 27; ++i)
+    {
+        object obj;
+        mutate(obj).add<a>();
+        REQUIRE(&obj.type_info() == &type);
+
+        single_object_mutator m(obj);
+        for (int n = i, m_i = 0; m_i < 3; n /= 3, ++m_i)
+        {
+            if (n % 3 == 1) m.add(ids[m_i]);
+            else if (n % 3 == 2) m.remove(ids[m_i]);
+        }
+    }
+
+    CHECK(type._num_transitions == object_type_info::MAX_TRANSITIONS);
+    CHECK(type.memory_footprint() > footprint);
+
+    // mutations still work when the list is full
+    mutate(o).add<b>().add<c>();
+    CHECK(o.has<a>());
+    CHECK(o.has<b>());
+    CHECK(o.has<c>());
+}